@@ -92,6 +92,15 @@ static void fill_block(__m256i* state, const block* ref_block,
 	}
 }
 
+/* Requests all cache lines of a memory block ahead of its use */
+static FORCE_INLINE void prefetch_block(const block* b) {
+	const char* p = (const char*)b->v;
+	unsigned int i;
+	for (i = 0; i < ARGON2_BLOCK_SIZE; i += 64) {
+		_mm_prefetch(p + i, _MM_HINT_T0);
+	}
+}
+
 void randomx_argon2_fill_segment_avx2(const argon2_instance_t* instance,
 	argon2_position_t position) {
 	block* ref_block = NULL, * curr_block = NULL;
@@ -156,6 +165,11 @@ void randomx_argon2_fill_segment_avx2(const argon2_instance_t* instance,
 		ref_block =
 			instance->memory + instance->lane_length * ref_lane + ref_index;
 		curr_block = instance->memory + curr_offset;
+		prefetch_block(ref_block);
+		if (0 != position.pass && i + 1 < instance->segment_length) {
+			/* the next block is XORed with its old contents */
+			prefetch_block(curr_block + 1);
+		}
 		if (ARGON2_VERSION_10 == instance->version) {
 			/* version 1.2.1 and earlier: overwrite, not XOR */
 			fill_block(state, ref_block, curr_block, 0);
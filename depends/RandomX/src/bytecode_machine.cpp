@@ -78,6 +78,96 @@ namespace randomx {
 		}
 	}
 
+#ifdef RANDOMX_COMPUTED_GOTO
+#define INSTR_LABEL(x) &&op_ ## x,
+
+#define INSTR_DISPATCH() \
+	if (++pc == RANDOMX_PROGRAM_SIZE) \
+		return; \
+	goto *dispatchTable[(int)bytecode[pc].type];
+
+#define INSTR_THREADED(x) op_ ## x: \
+	exe_ ## x(bytecode[pc], pc, scratchpad, config); \
+	INSTR_DISPATCH()
+
+	void BytecodeMachine::executeBytecode(InstructionByteCode bytecode[RANDOMX_PROGRAM_SIZE], uint8_t* scratchpad, ProgramConfiguration& config) {
+		//indexed by InstructionType; every handler ends with its own indirect jump
+		//so the branch predictor can learn the opcode sequence of the program
+		static void* const dispatchTable[] = {
+			INSTR_LABEL(IADD_RS)
+			INSTR_LABEL(IADD_M)
+			INSTR_LABEL(ISUB_R)
+			INSTR_LABEL(ISUB_M)
+			INSTR_LABEL(IMUL_R)
+			INSTR_LABEL(IMUL_M)
+			INSTR_LABEL(IMULH_R)
+			INSTR_LABEL(IMULH_M)
+			INSTR_LABEL(ISMULH_R)
+			INSTR_LABEL(ISMULH_M)
+			INSTR_LABEL(NOP) //IMUL_RCP is executed as IMUL_R
+			INSTR_LABEL(INEG_R)
+			INSTR_LABEL(IXOR_R)
+			INSTR_LABEL(IXOR_M)
+			INSTR_LABEL(IROR_R)
+			INSTR_LABEL(IROL_R)
+			INSTR_LABEL(ISWAP_R)
+			INSTR_LABEL(FSWAP_R)
+			INSTR_LABEL(FADD_R)
+			INSTR_LABEL(FADD_M)
+			INSTR_LABEL(FSUB_R)
+			INSTR_LABEL(FSUB_M)
+			INSTR_LABEL(FSCAL_R)
+			INSTR_LABEL(FMUL_R)
+			INSTR_LABEL(FDIV_M)
+			INSTR_LABEL(FSQRT_R)
+			INSTR_LABEL(CBRANCH)
+			INSTR_LABEL(CFROUND)
+			INSTR_LABEL(ISTORE)
+			INSTR_LABEL(NOP)
+		};
+		static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == (int)InstructionType::NOP + 1, "Invalid dispatch table");
+
+		int pc = 0;
+		goto *dispatchTable[(int)bytecode[pc].type];
+
+		INSTR_THREADED(IADD_RS)
+		INSTR_THREADED(IADD_M)
+		INSTR_THREADED(ISUB_R)
+		INSTR_THREADED(ISUB_M)
+		INSTR_THREADED(IMUL_R)
+		INSTR_THREADED(IMUL_M)
+		INSTR_THREADED(IMULH_R)
+		INSTR_THREADED(IMULH_M)
+		INSTR_THREADED(ISMULH_R)
+		INSTR_THREADED(ISMULH_M)
+		INSTR_THREADED(INEG_R)
+		INSTR_THREADED(IXOR_R)
+		INSTR_THREADED(IXOR_M)
+		INSTR_THREADED(IROR_R)
+		INSTR_THREADED(IROL_R)
+		INSTR_THREADED(ISWAP_R)
+		INSTR_THREADED(FSWAP_R)
+		INSTR_THREADED(FADD_R)
+		INSTR_THREADED(FADD_M)
+		INSTR_THREADED(FSUB_R)
+		INSTR_THREADED(FSUB_M)
+		INSTR_THREADED(FSCAL_R)
+		INSTR_THREADED(FMUL_R)
+		INSTR_THREADED(FDIV_M)
+		INSTR_THREADED(FSQRT_R)
+		INSTR_THREADED(CBRANCH)
+		INSTR_THREADED(CFROUND)
+		INSTR_THREADED(ISTORE)
+
+	op_NOP:
+		INSTR_DISPATCH()
+	}
+
+#undef INSTR_THREADED
+#undef INSTR_DISPATCH
+#undef INSTR_LABEL
+#endif
+
 	void BytecodeMachine::compileInstruction(RANDOMX_GEN_ARGS) {
 		int opcode = instr.opcode;
 
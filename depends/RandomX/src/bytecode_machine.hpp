@@ -98,6 +98,11 @@ namespace randomx {
 	OPCODE_CEIL_DECLARE(NOP, ISTORE);
 #undef OPCODE_CEIL_DECLARE
 
+//threaded dispatch via the GNU "labels as values" extension
+#if defined(__GNUC__) && !defined(RANDOMX_NO_COMPUTED_GOTO)
+#define RANDOMX_COMPUTED_GOTO
+#endif
+
 #define RANDOMX_EXE_ARGS InstructionByteCode& ibc, int& pc, uint8_t* scratchpad, ProgramConfiguration& config
 #define RANDOMX_GEN_ARGS Instruction& instr, int i, InstructionByteCode& ibc
 
@@ -123,12 +128,17 @@ namespace randomx {
 			}
 		}
 
-		static void executeBytecode(InstructionByteCode bytecode[RANDOMX_PROGRAM_SIZE], uint8_t* scratchpad, ProgramConfiguration& config) {
+		static void executeBytecode(InstructionByteCode bytecode[RANDOMX_PROGRAM_SIZE], uint8_t* scratchpad, ProgramConfiguration& config)
+#ifdef RANDOMX_COMPUTED_GOTO
+		;
+#else
+		{
 			for (int pc = 0; pc < RANDOMX_PROGRAM_SIZE; ++pc) {
 				auto& ibc = bytecode[pc];
 				executeInstruction(ibc, pc, scratchpad, config);
 			}
 		}
+#endif
 
 		void compileInstruction(RANDOMX_GEN_ARGS)
 #ifdef RANDOMX_GEN_TABLE
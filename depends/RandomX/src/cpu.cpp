@@ -48,19 +48,34 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace randomx {
 
-	Cpu::Cpu() : aes_(false), ssse3_(false), avx2_(false) {
+	Cpu::Cpu() : aes_(false), ssse3_(false), avx2_(false), avx512f_(false), avx512_(false), intel_(false), amd_(false), family_(0), model_(0) {
 #ifdef HAVE_CPUID
 		int info[4];
 		cpuid(info, 0);
 		int nIds = info[0];
+		//vendor string is stored in EBX, EDX, ECX
+		intel_ = info[1] == 0x756e6547 && info[3] == 0x49656e69 && info[2] == 0x6c65746e;
+		amd_ = info[1] == 0x68747541 && info[3] == 0x69746e65 && info[2] == 0x444d4163;
 		if (nIds >= 0x00000001) {
 			cpuid(info, 0x00000001);
 			ssse3_ = (info[2] & (1 << 9)) != 0;
 			aes_ = (info[2] & (1 << 25)) != 0;
+			int baseFamily = (info[0] >> 8) & 0xf;
+			family_ = baseFamily;
+			model_ = (info[0] >> 4) & 0xf;
+			if (baseFamily == 0xf) {
+				family_ += (info[0] >> 20) & 0xff;
+			}
+			if (baseFamily == 0x6 || baseFamily == 0xf) {
+				model_ |= ((info[0] >> 16) & 0xf) << 4;
+			}
 		}
 		if (nIds >= 0x00000007) {
 			cpuid(info, 0x00000007);
 			avx2_ = (info[1] & (1 << 5)) != 0;
+			//AVX-512 Foundation (Argon2) and Doubleword/Quadword (dataset)
+			avx512f_ = (info[1] & (1 << 16)) != 0;
+			avx512_ = avx512f_ && (info[1] & (1 << 17)) != 0;
 		}
 #elif defined(__aarch64__)
 	#if defined(HWCAP_AES)
@@ -42,8 +42,28 @@ namespace randomx {
 		bool hasAvx2() const {
 			return avx2_;
 		}
+		bool hasAvx512F() const {
+			return avx512f_;
+		}
+		bool hasAvx512() const {
+			return avx512_;
+		}
+		bool isIntel() const {
+			return intel_;
+		}
+		bool isAmd() const {
+			return amd_;
+		}
+		//display family and model (base values combined with the extended fields)
+		int family() const {
+			return family_;
+		}
+		int model() const {
+			return model_;
+		}
 	private:
-		bool aes_, ssse3_, avx2_;
+		bool aes_, ssse3_, avx2_, avx512f_, avx512_, intel_, amd_;
+		int family_, model_;
 	};
 
 }
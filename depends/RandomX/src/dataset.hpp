@@ -77,6 +77,15 @@ namespace randomx {
 
 	using DefaultAllocator = AlignedAllocator<CacheLineSize>;
 
+	constexpr uint64_t superscalarMul0 = 6364136223846793005ULL;
+	constexpr uint64_t superscalarAdd1 = 9298411001130361340ULL;
+	constexpr uint64_t superscalarAdd2 = 12065312585734608966ULL;
+	constexpr uint64_t superscalarAdd3 = 9306329213124626780ULL;
+	constexpr uint64_t superscalarAdd4 = 5281919268842080866ULL;
+	constexpr uint64_t superscalarAdd5 = 10536153434571861004ULL;
+	constexpr uint64_t superscalarAdd6 = 3398623926847679864ULL;
+	constexpr uint64_t superscalarAdd7 = 9549104520008361294ULL;
+
 	template<class Allocator>
 	void deallocDataset(randomx_dataset* dataset) {
 		if (dataset->memory != nullptr)
@@ -90,8 +99,13 @@ namespace randomx {
 	void initCacheCompile(randomx_cache*, const void*, size_t);
 	void initDatasetItem(randomx_cache* cache, uint8_t* out, uint64_t blockNumber);
 	void initDataset(randomx_cache* cache, uint8_t* dataset, uint32_t startBlock, uint32_t endBlock);
+	DatasetInitFunc* selectDatasetInitAvx2();
+	DatasetInitFunc* selectDatasetInitAvx512();
 
 	inline randomx_argon2_impl* selectArgonImpl(randomx_flags flags) {
+		if (flags & RANDOMX_FLAG_ARGON2_AVX512) {
+			return randomx_argon2_impl_avx512();
+		}
 		if (flags & RANDOMX_FLAG_ARGON2_AVX2) {
 			return randomx_argon2_impl_avx2();
 		}
@@ -100,4 +114,17 @@ namespace randomx {
 		}
 		return &randomx_argon2_fill_segment_ref;
 	}
+
+	inline DatasetInitFunc* selectDatasetImpl(randomx_flags flags, DatasetInitFunc* defaultImpl) {
+		if ((flags & RANDOMX_FLAG_DATASET_SIMD) == RANDOMX_FLAG_DATASET_SIMD) {
+			return nullptr;
+		}
+		if (flags & RANDOMX_FLAG_DATASET_AVX512) {
+			return selectDatasetInitAvx512();
+		}
+		if (flags & RANDOMX_FLAG_DATASET_AVX2) {
+			return selectDatasetInitAvx2();
+		}
+		return defaultImpl;
+	}
 }
@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2018-2019, tevador <tevador@gmail.com>
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright
+	  notice, this list of conditions and the following disclaimer in the
+	  documentation and/or other materials provided with the distribution.
+	* Neither the name of the copyright holder nor the
+	  names of its contributors may be used to endorse or promote products
+	  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "dataset.hpp"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#include "dataset_simd.hpp"
+
+namespace randomx {
+
+	//4 dataset items per 256-bit vector
+	struct DatasetVecAvx2 {
+		typedef __m256i type;
+		static constexpr int lanes = 4;
+
+		static type set1(uint64_t x) {
+			return _mm256_set1_epi64x(x);
+		}
+		static type load(const uint64_t* p) {
+			return _mm256_load_si256((const __m256i*)p);
+		}
+		static void store(uint64_t* p, type a) {
+			_mm256_store_si256((__m256i*)p, a);
+		}
+		static type add(type a, type b) {
+			return _mm256_add_epi64(a, b);
+		}
+		static type sub(type a, type b) {
+			return _mm256_sub_epi64(a, b);
+		}
+		static type xor_(type a, type b) {
+			return _mm256_xor_si256(a, b);
+		}
+		static type and_(type a, type b) {
+			return _mm256_and_si256(a, b);
+		}
+		static type shl(type a, int count) {
+			return _mm256_sll_epi64(a, _mm_cvtsi32_si128(count));
+		}
+		static type rotr(type a, int count) {
+			return _mm256_or_si256(
+				_mm256_srl_epi64(a, _mm_cvtsi32_si128(count)),
+				_mm256_sll_epi64(a, _mm_cvtsi32_si128(64 - count))
+			);
+		}
+		static type mul(type a, type b) {
+			//lo(a) * lo(b) + ((hi(a) * lo(b) + lo(a) * hi(b)) << 32)
+			type ll = _mm256_mul_epu32(a, b);
+			type hl = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+			type lh = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+			return _mm256_add_epi64(ll, _mm256_slli_epi64(_mm256_add_epi64(hl, lh), 32));
+		}
+		static type mulh(type a, type b) {
+			const type lo32 = _mm256_set1_epi64x(0xffffffff);
+			type ah = _mm256_srli_epi64(a, 32);
+			type bh = _mm256_srli_epi64(b, 32);
+			type ll = _mm256_mul_epu32(a, b);
+			type hl = _mm256_mul_epu32(ah, b);
+			type lh = _mm256_mul_epu32(a, bh);
+			type hh = _mm256_mul_epu32(ah, bh);
+			type mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32), _mm256_and_si256(hl, lo32));
+			mid = _mm256_add_epi64(mid, _mm256_and_si256(lh, lo32));
+			hh = _mm256_add_epi64(hh, _mm256_srli_epi64(hl, 32));
+			hh = _mm256_add_epi64(hh, _mm256_srli_epi64(lh, 32));
+			return _mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32));
+		}
+		static type smulh(type a, type b) {
+			//signed high product = unsigned high product - (a < 0 ? b : 0) - (b < 0 ? a : 0)
+			const type zero = _mm256_setzero_si256();
+			type hi = mulh(a, b);
+			hi = _mm256_sub_epi64(hi, _mm256_and_si256(_mm256_cmpgt_epi64(zero, a), b));
+			return _mm256_sub_epi64(hi, _mm256_and_si256(_mm256_cmpgt_epi64(zero, b), a));
+		}
+		static type gather(const uint64_t* base, type index) {
+			return _mm256_i64gather_epi64((const long long*)base, index, 8);
+		}
+	};
+
+	void initDatasetAvx2(randomx_cache* cache, uint8_t* dataset, uint32_t startItem, uint32_t endItem) {
+		initDatasetSimd<DatasetVecAvx2, 8>(cache, dataset, startItem, endItem);
+	}
+
+	DatasetInitFunc* selectDatasetInitAvx2() {
+		return &initDatasetAvx2;
+	}
+}
+
+#else
+
+namespace randomx {
+
+	DatasetInitFunc* selectDatasetInitAvx2() {
+		return nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2018-2019, tevador <tevador@gmail.com>
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright
+	  notice, this list of conditions and the following disclaimer in the
+	  documentation and/or other materials provided with the distribution.
+	* Neither the name of the copyright holder nor the
+	  names of its contributors may be used to endorse or promote products
+	  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "dataset.hpp"
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+
+#include <immintrin.h>
+#include "dataset_simd.hpp"
+
+namespace randomx {
+
+	//8 dataset items per 512-bit vector
+	struct DatasetVecAvx512 {
+		typedef __m512i type;
+		static constexpr int lanes = 8;
+
+		static type set1(uint64_t x) {
+			return _mm512_set1_epi64(x);
+		}
+		static type load(const uint64_t* p) {
+			return _mm512_load_si512((const void*)p);
+		}
+		static void store(uint64_t* p, type a) {
+			_mm512_store_si512((void*)p, a);
+		}
+		static type add(type a, type b) {
+			return _mm512_add_epi64(a, b);
+		}
+		static type sub(type a, type b) {
+			return _mm512_sub_epi64(a, b);
+		}
+		static type xor_(type a, type b) {
+			return _mm512_xor_si512(a, b);
+		}
+		static type and_(type a, type b) {
+			return _mm512_and_si512(a, b);
+		}
+		static type shl(type a, int count) {
+			return _mm512_sll_epi64(a, _mm_cvtsi32_si128(count));
+		}
+		static type rotr(type a, int count) {
+			return _mm512_rorv_epi64(a, _mm512_set1_epi64(count));
+		}
+		static type mul(type a, type b) {
+			return _mm512_mullo_epi64(a, b);
+		}
+		static type mulh(type a, type b) {
+			const type lo32 = _mm512_set1_epi64(0xffffffff);
+			type ah = _mm512_srli_epi64(a, 32);
+			type bh = _mm512_srli_epi64(b, 32);
+			type ll = _mm512_mul_epu32(a, b);
+			type hl = _mm512_mul_epu32(ah, b);
+			type lh = _mm512_mul_epu32(a, bh);
+			type hh = _mm512_mul_epu32(ah, bh);
+			type mid = _mm512_add_epi64(_mm512_srli_epi64(ll, 32), _mm512_and_si512(hl, lo32));
+			mid = _mm512_add_epi64(mid, _mm512_and_si512(lh, lo32));
+			hh = _mm512_add_epi64(hh, _mm512_srli_epi64(hl, 32));
+			hh = _mm512_add_epi64(hh, _mm512_srli_epi64(lh, 32));
+			return _mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32));
+		}
+		static type smulh(type a, type b) {
+			//signed high product = unsigned high product - (a < 0 ? b : 0) - (b < 0 ? a : 0)
+			type hi = mulh(a, b);
+			hi = _mm512_sub_epi64(hi, _mm512_and_si512(_mm512_srai_epi64(a, 63), b));
+			return _mm512_sub_epi64(hi, _mm512_and_si512(_mm512_srai_epi64(b, 63), a));
+		}
+		static type gather(const uint64_t* base, type index) {
+			return _mm512_i64gather_epi64(index, (const void*)base, 8);
+		}
+	};
+
+	void initDatasetAvx512(randomx_cache* cache, uint8_t* dataset, uint32_t startItem, uint32_t endItem) {
+		initDatasetSimd<DatasetVecAvx512, 8>(cache, dataset, startItem, endItem);
+	}
+
+	DatasetInitFunc* selectDatasetInitAvx512() {
+		return &initDatasetAvx512;
+	}
+}
+
+#else
+
+namespace randomx {
+
+	DatasetInitFunc* selectDatasetInitAvx512() {
+		return nullptr;
+	}
+}
+
+#endif
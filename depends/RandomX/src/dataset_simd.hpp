@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2018-2019, tevador <tevador@gmail.com>
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright
+	  notice, this list of conditions and the following disclaimer in the
+	  documentation and/or other materials provided with the distribution.
+	* Neither the name of the copyright holder nor the
+	  names of its contributors may be used to endorse or promote products
+	  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+//Generic multi-item dataset initialization. Included by the ISA specific
+//translation units (dataset_avx2.cpp, dataset_avx512.cpp), which provide
+//the vector operations for one lane per dataset item.
+
+#include <cstdint>
+#include "common.hpp"
+#include "dataset.hpp"
+#include "superscalar.hpp"
+#include "intrin_portable.h"
+
+namespace randomx {
+
+	//superscalar instruction with the immediate already expanded
+	struct SuperscalarSimdInstruction {
+		uint8_t opcode;
+		uint8_t dst;
+		uint8_t src;
+		uint8_t shift;
+		uint64_t imm;
+	};
+
+	struct SuperscalarSimdProgram {
+		SuperscalarSimdInstruction code[SuperscalarMaxSize];
+		uint32_t size;
+		int addrReg;
+	};
+
+	inline void decodeSuperscalarSimd(randomx_cache* cache, SuperscalarSimdProgram(&programs)[RANDOMX_CACHE_ACCESSES]) {
+		for (unsigned i = 0; i < RANDOMX_CACHE_ACCESSES; ++i) {
+			SuperscalarProgram& prog = cache->programs[i];
+			SuperscalarSimdProgram& simd = programs[i];
+			simd.size = prog.getSize();
+			simd.addrReg = prog.getAddressRegister();
+			for (unsigned j = 0; j < prog.getSize(); ++j) {
+				Instruction& instr = prog(j);
+				SuperscalarSimdInstruction& op = simd.code[j];
+				op.opcode = instr.opcode;
+				op.dst = instr.dst;
+				op.src = instr.src;
+				op.shift = instr.getModShift();
+				switch ((SuperscalarInstructionType)instr.opcode)
+				{
+				case SuperscalarInstructionType::IROR_C:
+					op.imm = instr.getImm32() & 63;
+					break;
+				case SuperscalarInstructionType::IMUL_RCP:
+					op.imm = cache->reciprocalCache[instr.getImm32()];
+					break;
+				default:
+					op.imm = signExtend2sCompl(instr.getImm32());
+				}
+			}
+		}
+	}
+
+	//r[reg][u] holds register reg of dataset items u * V::lanes .. (u + 1) * V::lanes - 1
+	template<class V, int unroll>
+	void executeSuperscalarSimd(typename V::type(&r)[8][unroll], const SuperscalarSimdProgram& prog) {
+		for (unsigned j = 0; j < prog.size; ++j) {
+			const SuperscalarSimdInstruction& op = prog.code[j];
+			typename V::type(&dst)[unroll] = r[op.dst];
+			typename V::type(&src)[unroll] = r[op.src];
+			switch ((SuperscalarInstructionType)op.opcode)
+			{
+			case SuperscalarInstructionType::ISUB_R:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::sub(dst[u], src[u]);
+				break;
+			case SuperscalarInstructionType::IXOR_R:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::xor_(dst[u], src[u]);
+				break;
+			case SuperscalarInstructionType::IADD_RS:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::add(dst[u], V::shl(src[u], op.shift));
+				break;
+			case SuperscalarInstructionType::IMUL_R:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::mul(dst[u], src[u]);
+				break;
+			case SuperscalarInstructionType::IROR_C:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::rotr(dst[u], (int)op.imm);
+				break;
+			case SuperscalarInstructionType::IADD_C7:
+			case SuperscalarInstructionType::IADD_C8:
+			case SuperscalarInstructionType::IADD_C9:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::add(dst[u], V::set1(op.imm));
+				break;
+			case SuperscalarInstructionType::IXOR_C7:
+			case SuperscalarInstructionType::IXOR_C8:
+			case SuperscalarInstructionType::IXOR_C9:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::xor_(dst[u], V::set1(op.imm));
+				break;
+			case SuperscalarInstructionType::IMULH_R:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::mulh(dst[u], src[u]);
+				break;
+			case SuperscalarInstructionType::ISMULH_R:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::smulh(dst[u], src[u]);
+				break;
+			case SuperscalarInstructionType::IMUL_RCP:
+				for (int u = 0; u < unroll; ++u)
+					dst[u] = V::mul(dst[u], V::set1(op.imm));
+				break;
+			default:
+				UNREACHABLE;
+			}
+		}
+	}
+
+	template<class V, int unroll>
+	void initDatasetSimd(randomx_cache* cache, uint8_t* dataset, uint32_t startItem, uint32_t endItem) {
+		typedef typename V::type vec;
+		constexpr int lanes = V::lanes;
+		constexpr int items = lanes * unroll;
+		constexpr uint64_t mixMask = CacheSize / CacheLineSize - 1;
+
+		SuperscalarSimdProgram programs[RANDOMX_CACHE_ACCESSES];
+		decodeSuperscalarSimd(cache, programs);
+
+		alignas(64) uint64_t lane[lanes];
+		alignas(64) uint64_t output[8][items];
+
+		uint32_t itemNumber = startItem;
+		for (; itemNumber + items <= endItem; itemNumber += items) {
+			vec r[8][unroll];
+			vec registerValue[unroll];
+			for (int u = 0; u < unroll; ++u) {
+				for (int l = 0; l < lanes; ++l)
+					lane[l] = itemNumber + u * lanes + l;
+				registerValue[u] = V::load(lane);
+				r[0][u] = V::mul(V::add(registerValue[u], V::set1(1)), V::set1(superscalarMul0));
+				r[1][u] = V::xor_(r[0][u], V::set1(superscalarAdd1));
+				r[2][u] = V::xor_(r[0][u], V::set1(superscalarAdd2));
+				r[3][u] = V::xor_(r[0][u], V::set1(superscalarAdd3));
+				r[4][u] = V::xor_(r[0][u], V::set1(superscalarAdd4));
+				r[5][u] = V::xor_(r[0][u], V::set1(superscalarAdd5));
+				r[6][u] = V::xor_(r[0][u], V::set1(superscalarAdd6));
+				r[7][u] = V::xor_(r[0][u], V::set1(superscalarAdd7));
+			}
+
+			for (unsigned i = 0; i < RANDOMX_CACHE_ACCESSES; ++i) {
+				//index of the first 64-bit word of each mix block
+				vec mixIndex[unroll];
+				for (int u = 0; u < unroll; ++u) {
+					mixIndex[u] = V::shl(V::and_(registerValue[u], V::set1(mixMask)), 3);
+					V::store(lane, mixIndex[u]);
+					for (int l = 0; l < lanes; ++l)
+						rx_prefetch_nta(cache->memory + 8 * lane[l]);
+				}
+				const SuperscalarSimdProgram& prog = programs[i];
+				executeSuperscalarSimd<V, unroll>(r, prog);
+				for (unsigned q = 0; q < 8; ++q) {
+					for (int u = 0; u < unroll; ++u)
+						r[q][u] = V::xor_(r[q][u], V::gather((const uint64_t*)cache->memory + q, mixIndex[u]));
+				}
+				for (int u = 0; u < unroll; ++u)
+					registerValue[u] = r[prog.addrReg][u];
+			}
+
+			for (unsigned q = 0; q < 8; ++q) {
+				for (int u = 0; u < unroll; ++u)
+					V::store(&output[q][u * lanes], r[q][u]);
+			}
+			for (int l = 0; l < items; ++l, dataset += CacheLineSize) {
+				for (unsigned q = 0; q < 8; ++q)
+					store64(dataset + 8 * q, output[q][l]);
+			}
+		}
+
+		for (; itemNumber < endItem; ++itemNumber, dataset += CacheLineSize)
+			initDatasetItem(cache, dataset, itemNumber);
+	}
+}
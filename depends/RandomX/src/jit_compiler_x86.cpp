@@ -35,6 +35,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "program.hpp"
 #include "reciprocal.h"
 #include "virtual_memory.hpp"
+#include "cpu.hpp"
+#include "perf_map.hpp"
 
 namespace randomx {
 	/*
@@ -79,6 +81,7 @@ namespace randomx {
 	//Calculate the required code buffer size that is sufficient for the largest possible program:
 
 	constexpr size_t MaxRandomXInstrCodeSize = 32;   //FDIV_M requires up to 32 bytes of x86 code
+	constexpr size_t MaxCbranchCodeSize = 20 + 13;   //CBRANCH with the JitAlign::Jcc32 padding of the fused TEST+JZ
 	constexpr size_t MaxSuperscalarInstrSize = 14;   //IMUL_RCP requires 14 bytes of x86 code
 	constexpr size_t SuperscalarProgramHeader = 128; //overhead per superscalar program
 	constexpr size_t CodeAlign = 4096;               //align code size to a multiple of 4 KiB
@@ -88,6 +91,7 @@ namespace randomx {
 	constexpr size_t SuperscalarSize = alignSize(ReserveCodeSize + (SuperscalarProgramHeader + MaxSuperscalarInstrSize * SuperscalarMaxSize) * RANDOMX_CACHE_ACCESSES, CodeAlign);
 
 	static_assert(RandomXCodeSize < INT32_MAX / 2, "RandomXCodeSize is too large");
+	static_assert((MaxCbranchCodeSize - MaxRandomXInstrCodeSize) * RANDOMX_PROGRAM_SIZE <= ReserveCodeSize / 4, "Branch padding doesn't fit into the reserve");
 	static_assert(SuperscalarSize < INT32_MAX / 2, "SuperscalarSize is too large");
 
 	constexpr uint32_t CodeSize = RandomXCodeSize + SuperscalarSize;
@@ -219,16 +223,68 @@ namespace randomx {
 
 	static const uint8_t* NOPX[] = { NOP1, NOP2, NOP3, NOP4, NOP5, NOP6, NOP7, NOP8 };
 
+	static const uint8_t MOV_ECX_EBP[] = { 0x89, 0xe9 };
+	static const uint8_t PREFETCHT0_RDI_RCX[] = { 0x0f, 0x18, 0x0c, 0x0f };
+
+	//"prefetchnta byte ptr [rdi+rdx]" in randomx_program_read_dataset
+	static const uint8_t PREFETCHNTA_RDI_RDX[] = { 0x0f, 0x18, 0x04, 0x17 };
+	//opcode and ModRM reg field for each JitPrefetch value
+	static const uint8_t PREFETCH_OPCODE[] = { 0x18, 0x18, 0x18, 0x0d };
+	static const uint8_t PREFETCH_REG[] = { 0, 1, 3, 1 };
+
+	static int32_t findReadDatasetPrefetch() {
+		for (int32_t i = 0; i + (int32_t)sizeof(PREFETCHNTA_RDI_RDX) <= readDatasetSize; ++i) {
+			if (memcmp(codeReadDataset + i, PREFETCHNTA_RDI_RDX, sizeof(PREFETCHNTA_RDI_RDX)) == 0)
+				return i;
+		}
+		return -1;
+	}
+
+	const int32_t readDatasetPrefetchOffset = findReadDatasetPrefetch();
+
 	size_t JitCompilerX86::getCodeSize() {
 		return CodeSize;
 	}
 
-	JitCompilerX86::JitCompilerX86() {
+	JitCompilerX86::JitCompilerX86() : profile(getDefaultProfile()) {
 		code = (uint8_t*)allocMemoryPages(CodeSize);
 		memcpy(code, codePrologue, prologueSize);
 		memcpy(code + epilogueOffset, codeEpilogue, epilogueSize);
 	}
 
+	JitProfile JitCompilerX86::selectProfile(const Cpu& cpu) {
+		JitProfile p = DefaultJitProfile;
+		//Skylake derived cores with the JCC erratum microcode update don't cache
+		//jumps that cross or end on a 32-byte boundary in the decoded ICache
+		if (cpu.isIntel() && cpu.family() == 6) {
+			switch (cpu.model()) {
+			case 0x4e: //Skylake (client)
+			case 0x5e:
+			case 0x55: //Skylake/Cascade Lake (server)
+			case 0x8e: //Kaby/Coffee/Whiskey/Amber Lake
+			case 0x9e:
+			case 0xa5: //Comet Lake
+			case 0xa6:
+				p.align = JitAlign::Jcc32;
+				break;
+			}
+		}
+		return p;
+	}
+
+	JitProfile& JitCompilerX86::defaultProfile() {
+		static JitProfile p = selectProfile(Cpu());
+		return p;
+	}
+
+	void JitCompilerX86::setDefaultProfile(const JitProfile& p) {
+		defaultProfile() = p;
+	}
+
+	JitProfile JitCompilerX86::getDefaultProfile() {
+		return defaultProfile();
+	}
+
 	JitCompilerX86::~JitCompilerX86() {
 		freePagedMemory(code, CodeSize);
 	}
@@ -245,15 +301,44 @@ namespace randomx {
 		setPagesRX(code, CodeSize);
 	}
 
+	void JitCompilerX86::emitNops(int count) {
+		while (count > 0) {
+			int nopSize = count > 8 ? 8 : count;
+			emit(NOPX[nopSize - 1], nopSize);
+			count -= nopSize;
+		}
+	}
+
+	void JitCompilerX86::alignCode(int boundary) {
+		emitNops((boundary - codePos % boundary) % boundary);
+	}
+
+	//pads a macro-fused branch of the given size so that it doesn't cross or end on a 32-byte boundary
+	void JitCompilerX86::alignBranch(int size) {
+		if (profile.align != JitAlign::Jcc32)
+			return;
+		int offset = codePos % 32;
+		if (offset + size >= 32)
+			emitNops(32 - offset);
+	}
+
 	void JitCompilerX86::generateProgram(Program& prog, ProgramConfiguration& pcfg) {
-		generateProgramPrologue(prog, pcfg);
+		generateProgramPrologue(prog, pcfg, profile.datasetRead == JitDatasetRead::Early);
+		if (profile.align != JitAlign::None)
+			alignCode(16);
 		memcpy(code + codePos, codeReadDataset, readDatasetSize);
+		if (readDatasetPrefetchOffset >= 0) {
+			uint8_t* prefetch = code + codePos + readDatasetPrefetchOffset;
+			prefetch[1] = PREFETCH_OPCODE[(int)profile.prefetch];
+			prefetch[2] = 0x04 + 8 * PREFETCH_REG[(int)profile.prefetch];
+		}
 		codePos += readDatasetSize;
 		generateProgramEpilogue(prog, pcfg);
+		registerProgramCode();
 	}
 
 	void JitCompilerX86::generateProgramLight(Program& prog, ProgramConfiguration& pcfg, uint32_t datasetOffset) {
-		generateProgramPrologue(prog, pcfg);
+		generateProgramPrologue(prog, pcfg, false);
 		emit(codeReadDatasetLightSshInit, readDatasetLightInitSize);
 		emit(ADD_EBX_I);
 		emit32(datasetOffset / CacheLineSize);
@@ -261,6 +346,18 @@ namespace randomx {
 		emit32(superScalarHashOffset - (codePos + 4));
 		emit(codeReadDatasetLightSshFin, readDatasetLightFinSize);
 		generateProgramEpilogue(prog, pcfg);
+		registerProgramCode();
+	}
+
+	//programs are regenerated in place for every hash, so the regions are registered once
+	//(jitdump keeps a copy of the first program)
+	void JitCompilerX86::registerProgramCode() {
+		if (perfRegistered || getPerfMode() == PerfNone)
+			return;
+		perfRegistered = true;
+		perfRegisterCode(code, prologueSize, "randomx_program_prologue");
+		perfRegisterCode(code + prologueSize, RandomXCodeSize - prologueSize, "randomx_program");
+		perfRegisterCode(code + epilogueOffset, epilogueSize, "randomx_program_epilogue");
 	}
 
 	template<size_t N>
@@ -290,6 +387,7 @@ namespace randomx {
 			}
 		}
 		emitByte(RET);
+		perfRegisterCode(code + superScalarHashOffset, codePos - superScalarHashOffset, "randomx_sshash");
 	}
 
 	template
@@ -297,9 +395,10 @@ namespace randomx {
 
 	void JitCompilerX86::generateDatasetInitCode() {
 		memcpy(code, codeDatasetInit, datasetInitSize);
+		perfRegisterCode(code, datasetInitSize, "randomx_dataset_init");
 	}
 
-	void JitCompilerX86::generateProgramPrologue(Program& prog, ProgramConfiguration& pcfg) {
+	void JitCompilerX86::generateProgramPrologue(Program& prog, ProgramConfiguration& pcfg, bool datasetTouch) {
 		instructionOffsets.clear();
 		for (unsigned i = 0; i < RegistersCount; ++i) {
 			registerUsage[i] = -1;
@@ -309,6 +408,15 @@ namespace randomx {
 		memcpy(code + codePos - 48, &pcfg.eMask, sizeof(pcfg.eMask));
 		memcpy(code + codePos, codeLoopLoad, loopLoadSize);
 		codePos += loopLoadSize;
+		if (datasetTouch) {
+			//the "ma" item was prefetched in the previous iteration; bring it to L1 while the program runs
+			emit(MOV_ECX_EBP);
+			emit(AND_ECX_I);
+			emit32(CacheLineAlignMask);
+			emit(PREFETCHT0_RDI_RCX);
+		}
+		if (profile.align != JitAlign::None)
+			alignCode(16);
 		for (unsigned i = 0; i < prog.getSize(); ++i) {
 			Instruction& instr = prog(i);
 			instr.src %= RegistersCount;
@@ -329,6 +437,7 @@ namespace randomx {
 		emit(ADDR(randomx_prefetch_scratchpad), ADDR(randomx_prefetch_scratchpad_end) - ADDR(randomx_prefetch_scratchpad));
 		memcpy(code + codePos, codeLoopStore, loopStoreSize);
 		codePos += loopStoreSize;
+		alignBranch(sizeof(SUB_EBX) + sizeof(JNZ) + 4);
 		emit(SUB_EBX);
 		emit(JNZ);
 		emit32(prologueSize - codePos - 4);
@@ -784,6 +893,7 @@ namespace randomx {
 		if (ConditionOffset > 0 || shift > 0)
 			imm &= ~(1UL << (shift - 1));
 		emit32(imm);
+		alignBranch(sizeof(REX_TEST) + 5 + sizeof(JZ) + 4);
 		emit(REX_TEST);
 		emitByte(0xc0 + reg);
 		emit32(ConditionMask << shift);
@@ -40,13 +40,53 @@ namespace randomx {
 	class SuperscalarProgram;
 	class JitCompilerX86;
 	class Instruction;
+	class Cpu;
 
 	typedef void(JitCompilerX86::*InstructionGeneratorX86)(Instruction&, int);
 
+	//prefetch instruction used for the dataset item of the next iteration
+	enum class JitPrefetch : uint8_t {
+		Nta,
+		T0,
+		T2,
+		W,
+	};
+
+	enum class JitAlign : uint8_t {
+		None,
+		Loop16, //program start and dataset read aligned to 16 bytes
+		Jcc32,  //Loop16 + macro-fused branches never cross or end on a 32-byte boundary
+	};
+
+	enum class JitDatasetRead : uint8_t {
+		End,    //dataset item is accessed only after the program
+		Early,  //dataset item is also touched at the start of the loop body
+	};
+
+	//code generation parameters that don't affect the result
+	struct JitProfile {
+		JitPrefetch prefetch;
+		JitAlign align;
+		JitDatasetRead datasetRead;
+	};
+
+	constexpr JitProfile DefaultJitProfile = { JitPrefetch::Nta, JitAlign::None, JitDatasetRead::End };
+
 	class JitCompilerX86 {
 	public:
 		JitCompilerX86();
 		~JitCompilerX86();
+		//returns the profile suggested for the CPU family
+		static JitProfile selectProfile(const Cpu&);
+		//profile used by compilers created afterwards; not thread-safe
+		static void setDefaultProfile(const JitProfile&);
+		static JitProfile getDefaultProfile();
+		void setProfile(const JitProfile& p) {
+			profile = p;
+		}
+		const JitProfile& getProfile() const {
+			return profile;
+		}
 		void generateProgram(Program&, ProgramConfiguration&);
 		void generateProgramLight(Program&, ProgramConfiguration&, uint32_t);
 		template<size_t N>
@@ -71,9 +111,16 @@ namespace randomx {
 		int registerUsage[RegistersCount];
 		uint8_t* code;
 		int32_t codePos;
-
-		void generateProgramPrologue(Program&, ProgramConfiguration&);
+		JitProfile profile;
+		bool perfRegistered = false;
+
+		static JitProfile& defaultProfile();
+		void emitNops(int);
+		void alignCode(int);
+		void alignBranch(int);
+		void generateProgramPrologue(Program&, ProgramConfiguration&, bool datasetTouch);
 		void generateProgramEpilogue(Program&, ProgramConfiguration&);
+		void registerProgramCode();
 		void genAddressReg(Instruction&, bool);
 		void genAddressRegDst(Instruction&);
 		void genAddressImm(Instruction&);
@@ -0,0 +1,185 @@
+/*
+Copyright (c) 2018-2019, tevador <tevador@gmail.com>
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright
+	  notice, this list of conditions and the following disclaimer in the
+	  documentation and/or other materials provided with the distribution.
+	* Neither the name of the copyright holder nor the
+	  names of its contributors may be used to endorse or promote products
+	  derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "perf_map.hpp"
+
+#include <mutex>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <elf.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace randomx {
+
+	static uint32_t perfMode = PerfNone;
+	static std::mutex perfMutex;
+
+#if defined(__linux__)
+
+	//https://github.com/torvalds/linux/blob/master/tools/perf/Documentation/jitdump-specification.txt
+	constexpr uint32_t JitDumpMagic = 0x4A695444;
+	constexpr uint32_t JitDumpVersion = 1;
+	constexpr uint32_t JitCodeLoad = 0;
+
+	struct JitDumpHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t totalSize;
+		uint32_t elfMach;
+		uint32_t pad1;
+		uint32_t pid;
+		uint64_t timestamp;
+		uint64_t flags;
+	};
+
+	struct JitDumpCodeLoad {
+		uint32_t id;
+		uint32_t totalSize;
+		uint64_t timestamp;
+		uint32_t pid;
+		uint32_t tid;
+		uint64_t vma;
+		uint64_t codeAddr;
+		uint64_t codeSize;
+		uint64_t codeIndex;
+	};
+
+	static FILE* perfMapFile = nullptr;
+	static FILE* jitDumpFile = nullptr;
+	static void* jitDumpMarker = nullptr;
+	static uint64_t jitDumpIndex = 0;
+
+	//perf record -k mono
+	static uint64_t monotonicTime() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	static void openPerfMap() {
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+		perfMapFile = fopen(path, "a");
+	}
+
+	static void openJitDump() {
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/jit-%d.dump", (int)getpid());
+		int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+		if (fd < 0)
+			return;
+		//perf finds the dump through an executable mapping of the file
+		long pageSize = sysconf(_SC_PAGESIZE);
+		jitDumpMarker = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+		if (jitDumpMarker == MAP_FAILED) {
+			jitDumpMarker = nullptr;
+			close(fd);
+			return;
+		}
+		jitDumpFile = fdopen(fd, "wb");
+		if (jitDumpFile == nullptr) {
+			close(fd);
+			return;
+		}
+		JitDumpHeader header = {};
+		header.magic = JitDumpMagic;
+		header.version = JitDumpVersion;
+		header.totalSize = sizeof(header);
+#if defined(__aarch64__)
+		header.elfMach = EM_AARCH64;
+#else
+		header.elfMach = EM_X86_64;
+#endif
+		header.pid = getpid();
+		header.timestamp = monotonicTime();
+		fwrite(&header, sizeof(header), 1, jitDumpFile);
+		fflush(jitDumpFile);
+	}
+
+	static void writeJitDump(const void* code, size_t size, const char* name) {
+		JitDumpCodeLoad record = {};
+		size_t nameSize = strlen(name) + 1;
+		record.id = JitCodeLoad;
+		record.totalSize = sizeof(record) + nameSize + size;
+		record.timestamp = monotonicTime();
+		record.pid = getpid();
+		record.tid = (uint32_t)syscall(SYS_gettid);
+		record.vma = record.codeAddr = (uint64_t)code;
+		record.codeSize = size;
+		record.codeIndex = jitDumpIndex++;
+		fwrite(&record, sizeof(record), 1, jitDumpFile);
+		fwrite(name, nameSize, 1, jitDumpFile);
+		fwrite(code, size, 1, jitDumpFile);
+		fflush(jitDumpFile);
+	}
+
+	void setPerfMode(uint32_t mode) {
+		std::lock_guard<std::mutex> lock(perfMutex);
+		perfMode = mode;
+		if ((mode & PerfMap) && perfMapFile == nullptr)
+			openPerfMap();
+		if ((mode & PerfJitDump) && jitDumpFile == nullptr)
+			openJitDump();
+	}
+
+	void perfRegisterCode(const void* code, size_t size, const char* name) {
+		if (perfMode == PerfNone || size == 0)
+			return;
+		std::lock_guard<std::mutex> lock(perfMutex);
+		if ((perfMode & PerfMap) && perfMapFile != nullptr) {
+			fprintf(perfMapFile, "%llx %zx %s\n", (unsigned long long)(uintptr_t)code, size, name);
+			fflush(perfMapFile);
+		}
+		if ((perfMode & PerfJitDump) && jitDumpFile != nullptr) {
+			writeJitDump(code, size, name);
+		}
+	}
+
+#else
+
+	void setPerfMode(uint32_t mode) {
+		perfMode = mode;
+	}
+
+	void perfRegisterCode(const void*, size_t, const char*) {
+	}
+
+#endif
+
+	uint32_t getPerfMode() {
+		return perfMode;
+	}
+
+}
@@ -34,6 +34,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "vm_compiled_light.hpp"
 #include "blake2/blake2.h"
 #include "cpu.hpp"
+#include "perf_map.hpp"
 #include <cassert>
 #include <limits>
 #include <cfenv>
@@ -51,21 +52,37 @@ extern "C" {
 		if (HAVE_AES && cpu.hasAes()) {
 			flags |= RANDOMX_FLAG_HARD_AES;
 		}
-		if (randomx_argon2_impl_avx2() != nullptr && cpu.hasAvx2()) {
+		if (randomx_argon2_impl_avx512() != nullptr && cpu.hasAvx512F()) {
+			flags |= RANDOMX_FLAG_ARGON2_AVX512;
+		}
+		else if (randomx_argon2_impl_avx2() != nullptr && cpu.hasAvx2()) {
 			flags |= RANDOMX_FLAG_ARGON2_AVX2;
 		}
 		if (randomx_argon2_impl_ssse3() != nullptr && cpu.hasSsse3()) {
 			flags |= RANDOMX_FLAG_ARGON2_SSSE3;
 		}
+		if (randomx::selectDatasetInitAvx512() != nullptr && cpu.hasAvx512()) {
+			flags |= RANDOMX_FLAG_DATASET_AVX512;
+		}
+		else if (randomx::selectDatasetInitAvx2() != nullptr && cpu.hasAvx2()) {
+			flags |= RANDOMX_FLAG_DATASET_AVX2;
+		}
 		return flags;
 	}
 
+	void randomx_set_perf_mode(randomx_perf_mode mode) {
+		randomx::setPerfMode(mode);
+	}
+
 	randomx_cache *randomx_alloc_cache(randomx_flags flags) {
 		randomx_cache *cache = nullptr;
 		auto impl = randomx::selectArgonImpl(flags);
 		if (impl == nullptr) {
 			return cache;
 		}
+		if (randomx::selectDatasetImpl(flags, &randomx::initDataset) == nullptr) {
+			return cache;
+		}
 
 		try {
 			cache = new randomx_cache();
@@ -106,6 +123,7 @@ extern "C" {
 				default:
 					UNREACHABLE;
 			}
+			cache->datasetInit = randomx::selectDatasetImpl(flags, cache->datasetInit);
 		}
 		catch (std::exception &ex) {
 			if (cache != nullptr) {
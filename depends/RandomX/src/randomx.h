@@ -48,9 +48,19 @@ typedef enum {
   RANDOMX_FLAG_SECURE = 16,
   RANDOMX_FLAG_ARGON2_SSSE3 = 32,
   RANDOMX_FLAG_ARGON2_AVX2 = 64,
-  RANDOMX_FLAG_ARGON2 = 96
+  RANDOMX_FLAG_ARGON2 = 96,
+  RANDOMX_FLAG_DATASET_AVX2 = 128,
+  RANDOMX_FLAG_DATASET_AVX512 = 256,
+  RANDOMX_FLAG_DATASET_SIMD = 384,
+  RANDOMX_FLAG_ARGON2_AVX512 = 512
 } randomx_flags;
 
+typedef enum {
+  RANDOMX_PERF_NONE = 0,
+  RANDOMX_PERF_MAP = 1,
+  RANDOMX_PERF_JITDUMP = 2
+} randomx_perf_mode;
+
 typedef struct randomx_dataset randomx_dataset;
 typedef struct randomx_cache randomx_cache;
 typedef struct randomx_vm randomx_vm;
@@ -88,6 +98,20 @@ extern "C" {
  */
 RANDOMX_EXPORT randomx_flags randomx_get_flags(void);
 
+/**
+ * Enables export of JIT compiled code regions for the Linux perf tool.
+ * Must be called before creating caches and virtual machines that should be
+ * profiled. Has no effect on other platforms.
+ *
+ * @param mode is a combination of the following values:
+ *        RANDOMX_PERF_MAP - append the regions to /tmp/perf-<pid>.map
+ *        RANDOMX_PERF_JITDUMP - write the regions with a copy of the code to
+ *            /tmp/jit-<pid>.dump (use "perf record -k mono" and "perf inject --jit")
+ *        Programs are regenerated in place for every hash, so their region is
+ *        exported once per virtual machine.
+*/
+RANDOMX_EXPORT void randomx_set_perf_mode(randomx_perf_mode mode);
+
 /**
  * Creates a randomx_cache structure and allocates memory for RandomX Cache.
  *
@@ -95,17 +119,27 @@ RANDOMX_EXPORT randomx_flags randomx_get_flags(void);
  *        RANDOMX_FLAG_LARGE_PAGES - allocate memory in large pages
  *        RANDOMX_FLAG_JIT - create cache structure with JIT compilation support; this makes
  *                           subsequent Dataset initialization faster
- *        Optionally, one of these two flags may be selected:
+ *        Optionally, one of these three flags may be selected:
  *        RANDOMX_FLAG_ARGON2_SSSE3 - optimized Argon2 for CPUs with the SSSE3 instruction set
  *                                   makes subsequent cache initialization faster
  *        RANDOMX_FLAG_ARGON2_AVX2 - optimized Argon2 for CPUs with the AVX2 instruction set
  *                                   makes subsequent cache initialization faster
+ *        RANDOMX_FLAG_ARGON2_AVX512 - optimized Argon2 for CPUs with the AVX-512F instruction set
+ *                                     makes subsequent cache initialization faster
+ *        Optionally, one of these two flags may be selected:
+ *        RANDOMX_FLAG_DATASET_AVX2 - Dataset initialization computing 4 items per vector with
+ *                                    the AVX2 instruction set
+ *        RANDOMX_FLAG_DATASET_AVX512 - Dataset initialization computing 8 items per vector with
+ *                                      the AVX-512F and AVX-512DQ instruction sets
+ *        Both produce the same Dataset as the scalar code and take precedence over RANDOMX_FLAG_JIT
+ *        for Dataset initialization.
  *
  * @return Pointer to an allocated randomx_cache structure.
  *         Returns NULL if:
  *         (1) memory allocation fails
  *         (2) the RANDOMX_FLAG_JIT is set and JIT compilation is not supported on the current platform
  *         (3) an invalid or unsupported RANDOMX_FLAG_ARGON2 value is set
+ *         (4) an invalid or unsupported RANDOMX_FLAG_DATASET_SIMD value is set
  */
 RANDOMX_EXPORT randomx_cache *randomx_alloc_cache(randomx_flags flags);
 
@@ -94,9 +94,41 @@ void printUsage(const char* executable) {
 	std::cout << "  --seed S      seed for cache initialization (default: 0)" << std::endl;
 	std::cout << "  --ssse3       use optimized Argon2 for SSSE3 CPUs" << std::endl;
 	std::cout << "  --avx2        use optimized Argon2 for AVX2 CPUs" << std::endl;
+	std::cout << "  --avx512      use optimized Argon2 for AVX-512 CPUs" << std::endl;
+	std::cout << "  --datasetAvx2    initialize dataset with AVX2 (4 items per vector)" << std::endl;
+	std::cout << "  --datasetAvx512  initialize dataset with AVX-512 (8 items per vector)" << std::endl;
 	std::cout << "  --auto        select the best options for the current CPU" << std::endl;
 	std::cout << "  --noBatch     calculate hashes one by one (default: batch)" << std::endl;
+	std::cout << "  --perfMap     export JIT code regions to /tmp/perf-<pid>.map" << std::endl;
+	std::cout << "  --jitDump     export JIT code to /tmp/jit-<pid>.dump for perf inject" << std::endl;
+#if defined(_M_X64) || defined(__x86_64__)
+	std::cout << "  --jitProfile P   use JIT code generation profile P (default: selected for the CPU)" << std::endl;
+	std::cout << "  --sweepJit       benchmark all JIT code generation profiles" << std::endl;
+#endif
+}
+
+#if defined(_M_X64) || defined(__x86_64__)
+constexpr int jitProfileCount = 4 * 3 * 2;
+
+randomx::JitProfile jitProfile(int index) {
+	randomx::JitProfile p;
+	p.prefetch = (randomx::JitPrefetch)(index / 6);
+	p.align = (randomx::JitAlign)(index / 2 % 3);
+	p.datasetRead = (randomx::JitDatasetRead)(index % 2);
+	return p;
+}
+
+int jitProfileIndex(const randomx::JitProfile& p) {
+	return (int)p.prefetch * 6 + (int)p.align * 2 + (int)p.datasetRead;
+}
+
+void printJitProfile(std::ostream& os, const randomx::JitProfile& p) {
+	static const char* prefetch[] = { "prefetchnta", "prefetcht0", "prefetcht2", "prefetchw" };
+	static const char* align[] = { "no alignment", "16-byte alignment", "JCC erratum alignment" };
+	static const char* datasetRead[] = { "late dataset read", "early dataset read" };
+	os << jitProfileIndex(p) << " (" << prefetch[(int)p.prefetch] << ", " << align[(int)p.align] << ", " << datasetRead[(int)p.datasetRead] << ")";
 }
+#endif
 
 struct MemoryException : public std::exception {
 };
@@ -147,8 +179,9 @@ void mine(randomx_vm* vm, std::atomic<uint32_t>& atomicNonce, AtomicHash& result
 
 int main(int argc, char** argv) {
 	bool softAes, miningMode, verificationMode, help, largePages, jit, secure;
-	bool ssse3, avx2, autoFlags, noBatch;
-	int noncesCount, threadCount, initThreadCount;
+	bool ssse3, avx2, avx512, datasetAvx2, datasetAvx512, autoFlags, noBatch, sweepJit;
+	bool perfMap, jitDump;
+	int noncesCount, threadCount, initThreadCount, jitProfileValue;
 	uint64_t threadAffinity;
 	int32_t seedValue;
 	char seed[4];
@@ -170,8 +203,15 @@ int main(int argc, char** argv) {
 	readOption("--secure", argc, argv, secure);
 	readOption("--ssse3", argc, argv, ssse3);
 	readOption("--avx2", argc, argv, avx2);
+	readOption("--avx512", argc, argv, avx512);
+	readOption("--datasetAvx2", argc, argv, datasetAvx2);
+	readOption("--datasetAvx512", argc, argv, datasetAvx512);
 	readOption("--auto", argc, argv, autoFlags);
 	readOption("--noBatch", argc, argv, noBatch);
+	readIntOption("--jitProfile", argc, argv, jitProfileValue, -1);
+	readOption("--sweepJit", argc, argv, sweepJit);
+	readOption("--perfMap", argc, argv, perfMap);
+	readOption("--jitDump", argc, argv, jitDump);
 
 	store32(&seed, seedValue);
 
@@ -205,9 +245,18 @@ int main(int argc, char** argv) {
 		if (ssse3) {
 			flags |= RANDOMX_FLAG_ARGON2_SSSE3;
 		}
-		if (avx2) {
+		if (avx512) {
+			flags |= RANDOMX_FLAG_ARGON2_AVX512;
+		}
+		else if (avx2) {
 			flags |= RANDOMX_FLAG_ARGON2_AVX2;
 		}
+		if (datasetAvx512) {
+			flags |= RANDOMX_FLAG_DATASET_AVX512;
+		}
+		else if (datasetAvx2) {
+			flags |= RANDOMX_FLAG_DATASET_AVX2;
+		}
 		if (!softAes) {
 			flags |= RANDOMX_FLAG_HARD_AES;
 		}
@@ -231,7 +280,10 @@ int main(int argc, char** argv) {
 	}
 #endif
 
-	if (flags & RANDOMX_FLAG_ARGON2_AVX2) {
+	if (flags & RANDOMX_FLAG_ARGON2_AVX512) {
+		std::cout << " - Argon2 implementation: AVX-512" << std::endl;
+	}
+	else if (flags & RANDOMX_FLAG_ARGON2_AVX2) {
 		std::cout << " - Argon2 implementation: AVX2" << std::endl;
 	}
 	else if (flags & RANDOMX_FLAG_ARGON2_SSSE3) {
@@ -243,6 +295,12 @@ int main(int argc, char** argv) {
 
 	if (flags & RANDOMX_FLAG_FULL_MEM) {
 		std::cout << " - full memory mode (2080 MiB)" << std::endl;
+		if (flags & RANDOMX_FLAG_DATASET_AVX512) {
+			std::cout << " - Dataset implementation: AVX-512" << std::endl;
+		}
+		else if (flags & RANDOMX_FLAG_DATASET_AVX2) {
+			std::cout << " - Dataset implementation: AVX2" << std::endl;
+		}
 	}
 	else {
 		std::cout << " - light memory mode (256 MiB)" << std::endl;
@@ -254,6 +312,23 @@ int main(int argc, char** argv) {
 			std::cout << "(secure)";
 		}
 		std::cout << std::endl;
+#if defined(_M_X64) || defined(__x86_64__)
+		if (jitProfileValue >= 0 && jitProfileValue < jitProfileCount) {
+			randomx::JitCompiler::setDefaultProfile(jitProfile(jitProfileValue));
+		}
+		if (sweepJit) {
+			std::cout << " - JIT profile sweep" << std::endl;
+		}
+		else {
+			std::cout << " - JIT profile ";
+			printJitProfile(std::cout, randomx::JitCompiler::getDefaultProfile());
+			std::cout << std::endl;
+		}
+#endif
+		if (perfMap || jitDump) {
+			randomx_set_perf_mode((randomx_perf_mode)((perfMap ? RANDOMX_PERF_MAP : 0) | (jitDump ? RANDOMX_PERF_JITDUMP : 0)));
+			std::cout << " - exporting JIT code to" << (perfMap ? " perf map" : "") << (jitDump ? " jitdump" : "") << std::endl;
+		}
 	}
 	else {
 		std::cout << " - interpreted mode" << std::endl;
@@ -296,6 +371,9 @@ int main(int argc, char** argv) {
 		if (nullptr == randomx::selectArgonImpl(flags)) {
 			throw std::runtime_error("Unsupported Argon2 implementation");
 		}
+		if (nullptr == randomx::selectDatasetImpl(flags, &randomx::initDataset)) {
+			throw std::runtime_error("Unsupported Dataset implementation");
+		}
 		if ((flags & RANDOMX_FLAG_JIT) && !RANDOMX_HAVE_COMPILER) {
 			throw std::runtime_error("JIT compilation is not supported on this platform. Try without --jit");
 		}
@@ -336,6 +414,38 @@ int main(int argc, char** argv) {
 			threads.clear();
 		}
 		std::cout << "Memory initialized in " << sw.getElapsed() << " s" << std::endl;
+#if defined(_M_X64) || defined(__x86_64__)
+		if (sweepJit && (flags & RANDOMX_FLAG_JIT)) {
+			std::cout << "Sweeping " << jitProfileCount << " JIT profiles (" << noncesCount << " nonces, 1 thread) ..." << std::endl;
+			int bestProfile = -1;
+			double bestElapsed = 0;
+			for (int i = 0; i < jitProfileCount; ++i) {
+				randomx::JitCompiler::setDefaultProfile(jitProfile(i));
+				randomx_vm* vm = randomx_create_vm(flags, cache, dataset);
+				if (vm == nullptr) {
+					throw std::runtime_error("Cannot create VM");
+				}
+				std::atomic<uint32_t> profileNonce(0);
+				AtomicHash profileResult;
+				sw.restart();
+				func(vm, profileNonce, profileResult, noncesCount, 0, -1);
+				double profileElapsed = sw.getElapsed();
+				randomx_destroy_vm(vm);
+				std::cout << " - profile ";
+				printJitProfile(std::cout, jitProfile(i));
+				std::cout << ": " << noncesCount / profileElapsed << " H/s, result ";
+				profileResult.print(std::cout);
+				if (bestProfile < 0 || profileElapsed < bestElapsed) {
+					bestProfile = i;
+					bestElapsed = profileElapsed;
+				}
+			}
+			randomx::JitCompiler::setDefaultProfile(jitProfile(bestProfile));
+			std::cout << "Best JIT profile for this host: ";
+			printJitProfile(std::cout, jitProfile(bestProfile));
+			std::cout << std::endl;
+		}
+#endif
 		std::cout << "Initializing " << threadCount << " virtual machine(s) ..." << std::endl;
 		for (int i = 0; i < threadCount; ++i) {
 			randomx_vm *vm = randomx_create_vm(flags, cache, dataset);
@@ -4,6 +4,12 @@
 
 #include <cassert>
 #include <iomanip>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <cstdio>
 #include "utility.hpp"
 #include "../bytecode_machine.hpp"
 #include "../dataset.hpp"
@@ -15,6 +21,11 @@
 #include "../intrin_portable.h"
 #include "../jit_compiler.hpp"
 #include "../aes_hash.hpp"
+#include "../cpu.hpp"
+#include "../perf_map.hpp"
+#if defined(__linux__)
+#include <unistd.h>
+#endif
 
 randomx_cache* cache;
 randomx_vm* vm = nullptr;
@@ -159,6 +170,31 @@ int main() {
 		assert(datasetItem[0] == 0x145a5091f7853099);
 	});
 
+	auto datasetTest = [](randomx::DatasetInitFunc* datasetInit) {
+		initCache("test key 000");
+		const uint32_t startItems[] = { 0, 10000000, 20000000, 30000000 };
+		const uint64_t firstWords[] = { 0x680588a85ae222db, 0x7943a1f6186ffb72, 0x9035244d718095e1, 0x145a5091f7853099 };
+		constexpr uint32_t itemCount = 67;
+		std::vector<uint64_t> items(itemCount * 8);
+		for (int i = 0; i < 4; ++i) {
+			datasetInit(cache, (uint8_t*)items.data(), startItems[i], startItems[i] + itemCount);
+			assert(items[0] == firstWords[i]);
+			for (uint32_t j = 0; j < itemCount; ++j) {
+				uint64_t datasetItem[8];
+				randomx::initDatasetItem(cache, (uint8_t*)&datasetItem, startItems[i] + j);
+				assert(memcmp(datasetItem, &items[8 * j], sizeof(datasetItem)) == 0);
+			}
+		}
+	};
+
+	runTest("Dataset initialization (AVX2)", randomx::selectDatasetInitAvx2() != nullptr && randomx::Cpu().hasAvx2() && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), [&]() {
+		datasetTest(randomx::selectDatasetInitAvx2());
+	});
+
+	runTest("Dataset initialization (AVX-512)", randomx::selectDatasetInitAvx512() != nullptr && randomx::Cpu().hasAvx512() && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), [&]() {
+		datasetTest(randomx::selectDatasetInitAvx512());
+	});
+
 	runTest("AesGenerator1R", true, []() {
 		char state[64] = { 0 };
 		hex2bin("6c19536eb2de31b6c0065f7f116e86f960d8af0c57210a6584c3237b9d064dc7", 64, state);
@@ -954,6 +990,35 @@ int main() {
 		assert(ibc.memMask == randomx::ScratchpadL3Mask);
 	});
 
+	runTest("Bytecode execution (dispatch)", true, [&] {
+		alignas(16) randomx::Program program;
+		randomx::InstructionByteCode bytecode[RANDOMX_PROGRAM_SIZE];
+		std::vector<uint8_t> scratchpad1(RANDOMX_SCRATCHPAD_L3), scratchpad2(RANDOMX_SCRATCHPAD_L3);
+		char seed[64] = { 0 };
+		fillAes1Rx4<false>(seed, scratchpad1.size(), scratchpad1.data());
+		scratchpad2 = scratchpad1;
+		fillAes4Rx4<false>(seed, sizeof(program), &program);
+		randomx::NativeRegisterFile reg1, reg2;
+		for (unsigned i = 0; i < randomx::RegisterCountFlt; ++i) {
+			reg1.a[i] = rx_set_vec_f128(0x3ff0000000000000 | i, 0x4000000000000000 | i);
+			reg1.f[i] = reg1.e[i] = reg1.a[i];
+		}
+		reg2 = reg1;
+		rx_set_rounding_mode(RoundToNearest);
+		decoder.compileProgram(program, bytecode, reg1);
+		for (int pc = 0; pc < RANDOMX_PROGRAM_SIZE; ++pc)
+			decoder.executeInstruction(bytecode[pc], pc, scratchpad1.data(), config);
+		rx_set_rounding_mode(RoundToNearest);
+		decoder.compileProgram(program, bytecode, reg2);
+		randomx::BytecodeMachine::executeBytecode(bytecode, scratchpad2.data(), config);
+		rx_set_rounding_mode(RoundToNearest);
+		assert(memcmp(reg1.r, reg2.r, sizeof(reg1.r)) == 0);
+		assert(memcmp(reg1.f, reg2.f, sizeof(reg1.f)) == 0);
+		assert(memcmp(reg1.e, reg2.e, sizeof(reg1.e)) == 0);
+		assert(scratchpad1 == scratchpad2);
+		decoder.beginCompilation(reg);
+	});
+
 #ifdef RANDOMX_FORCE_SECURE
 	vm = randomx_create_vm(RANDOMX_FLAG_DEFAULT | RANDOMX_FLAG_SECURE, cache, nullptr);
 #else
@@ -1026,6 +1091,108 @@ int main() {
 
 	runTest("Hash test 2e (compiler)", RANDOMX_HAVE_COMPILER && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), test_e);
 
+#if defined(_M_X64) || defined(__x86_64__)
+	runTest("Hash test 2f (compiler alignment)", stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), [&] {
+		randomx::JitProfile defaultProfile = randomx::JitCompiler::getDefaultProfile();
+		randomx_vm* defaultVm = vm;
+		for (int align = 0; align < 3; ++align) {
+			randomx::JitProfile profile = randomx::DefaultJitProfile;
+			profile.align = (randomx::JitAlign)align;
+			randomx::JitCompiler::setDefaultProfile(profile);
+#ifdef RANDOMX_FORCE_SECURE
+			vm = randomx_create_vm(RANDOMX_FLAG_JIT | RANDOMX_FLAG_SECURE, cache, nullptr);
+#else
+			vm = randomx_create_vm(RANDOMX_FLAG_JIT, cache, nullptr);
+#endif
+			test_a();
+			test_b();
+			test_c();
+			test_d();
+			test_e();
+			randomx_destroy_vm(vm);
+		}
+		vm = defaultVm;
+		randomx::JitCompiler::setDefaultProfile(defaultProfile);
+	});
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+	randomx_dataset* dataset = RANDOMX_HAVE_COMPILER ? randomx_alloc_dataset(RANDOMX_FLAG_DEFAULT) : nullptr;
+
+	runTest("Hash test 2g (compiler, full dataset)", dataset != nullptr && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), [&] {
+		initCache("test key 000");
+		unsigned long itemCount = randomx_dataset_item_count();
+		unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < threadCount; ++i) {
+			unsigned long start = itemCount * i / threadCount;
+			unsigned long end = itemCount * (i + 1) / threadCount;
+			threads.emplace_back(&randomx_init_dataset, dataset, cache, start, end - start);
+		}
+		for (auto& thread : threads)
+			thread.join();
+		randomx::JitProfile defaultProfile = randomx::JitCompiler::getDefaultProfile();
+		for (int prefetch = 0; prefetch < 4; ++prefetch) {
+			for (int datasetRead = 0; datasetRead < 2; ++datasetRead) {
+				randomx::JitProfile profile = randomx::DefaultJitProfile;
+				profile.prefetch = (randomx::JitPrefetch)prefetch;
+				profile.datasetRead = (randomx::JitDatasetRead)datasetRead;
+				randomx::JitCompiler::setDefaultProfile(profile);
+#ifdef RANDOMX_FORCE_SECURE
+				randomx_vm* fullVm = randomx_create_vm(RANDOMX_FLAG_JIT | RANDOMX_FLAG_FULL_MEM | RANDOMX_FLAG_SECURE, nullptr, dataset);
+#else
+				randomx_vm* fullVm = randomx_create_vm(RANDOMX_FLAG_JIT | RANDOMX_FLAG_FULL_MEM, nullptr, dataset);
+#endif
+				assert(fullVm != nullptr);
+				char hash[RANDOMX_HASH_SIZE];
+				randomx_calculate_hash(fullVm, "This is a test", 14, hash);
+				assert(equalsHex(hash, "639183aae1bf4c9a35884cb46b09cad9175f04efd7684e7262a0ac1c2f0b4e3f"));
+				randomx_calculate_hash(fullVm, "Lorem ipsum dolor sit amet", 26, hash);
+				assert(equalsHex(hash, "300a0adb47603dedb42228ccb2b211104f4da45af709cd7547cd049e9489c969"));
+				randomx_calculate_hash(fullVm, "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua", 65, hash);
+				assert(equalsHex(hash, "c36d4ed4191e617309867ed66a443be4075014e2b061bcdaf9ce7b721d2b77a8"));
+				randomx_destroy_vm(fullVm);
+			}
+		}
+		randomx::JitCompiler::setDefaultProfile(defaultProfile);
+	});
+
+	if (dataset != nullptr)
+		randomx_release_dataset(dataset);
+#endif
+
+#if defined(__linux__) && (defined(_M_X64) || defined(__x86_64__))
+	runTest("JIT perf map", stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), [&] {
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+		remove(path);
+		randomx::setPerfMode(randomx::PerfMap);
+#ifdef RANDOMX_FORCE_SECURE
+		randomx_vm* perfVm = randomx_create_vm(RANDOMX_FLAG_JIT | RANDOMX_FLAG_SECURE, cache, nullptr);
+#else
+		randomx_vm* perfVm = randomx_create_vm(RANDOMX_FLAG_JIT, cache, nullptr);
+#endif
+		char hash[RANDOMX_HASH_SIZE];
+		randomx_calculate_hash(perfVm, "perf", 4, hash);
+		randomx_calculate_hash(perfVm, "perf", 4, hash);
+		randomx_destroy_vm(perfVm);
+		randomx::setPerfMode(randomx::PerfNone);
+		std::ifstream map(path);
+		std::string line;
+		int programs = 0, prologues = 0;
+		while (std::getline(map, line)) {
+			if (line.find(" randomx_program") != std::string::npos && line.find("_prologue") == std::string::npos && line.find("_epilogue") == std::string::npos)
+				++programs;
+			if (line.find(" randomx_program_prologue") != std::string::npos)
+				++prologues;
+		}
+		map.close();
+		remove(path);
+		assert(programs == 1);
+		assert(prologues == 1);
+	});
+#endif
+
 	auto flags = randomx_get_flags();
 
 	randomx_release_cache(cache);
@@ -1043,7 +1210,19 @@ int main() {
 		randomx_release_cache(cache);
 	cache = randomx_alloc_cache(RANDOMX_FLAG_ARGON2_AVX2);
 
-	runTest("Cache initialization: AVX2", (flags & RANDOMX_FLAG_ARGON2_AVX2) && RANDOMX_ARGON_ITERATIONS == 3 && RANDOMX_ARGON_LANES == 1 && RANDOMX_ARGON_MEMORY == 262144 && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), []() {
+	runTest("Cache initialization: AVX2", randomx_argon2_impl_avx2() != nullptr && randomx::Cpu().hasAvx2() && RANDOMX_ARGON_ITERATIONS == 3 && RANDOMX_ARGON_LANES == 1 && RANDOMX_ARGON_MEMORY == 262144 && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), []() {
+		initCache("test key 000");
+		uint64_t* cacheMemory = (uint64_t*)cache->memory;
+		assert(cacheMemory[0] == 0x191e0e1d23c02186);
+		assert(cacheMemory[1568413] == 0xf1b62fe6210bf8b1);
+		assert(cacheMemory[33554431] == 0x1f47f056d05cd99b);
+	});
+
+	if (cache != nullptr)
+		randomx_release_cache(cache);
+	cache = randomx_alloc_cache(RANDOMX_FLAG_ARGON2_AVX512);
+
+	runTest("Cache initialization: AVX-512", (flags & RANDOMX_FLAG_ARGON2_AVX512) && RANDOMX_ARGON_ITERATIONS == 3 && RANDOMX_ARGON_LANES == 1 && RANDOMX_ARGON_MEMORY == 262144 && stringsEqual(RANDOMX_ARGON_SALT, "RandomX\x03"), []() {
 		initCache("test key 000");
 		uint64_t* cacheMemory = (uint64_t*)cache->memory;
 		assert(cacheMemory[0] == 0x191e0e1d23c02186);
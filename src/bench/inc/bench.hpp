@@ -0,0 +1,597 @@
+#pragma once
+
+#ifndef BENCH_HEADER
+#define BENCH_HEADER
+
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+
+#include "../../solvers/inc/solvers.hpp"
+#include "../../hashes/inc/hashes.hpp"
+#include "../../tuner/inc/tuner.hpp"
+#include "../../logger/inc/logger.hpp"
+#include "../../libs/csv/csv.hpp"
+
+using std::string;
+
+/**
+ * @brief Implementators for Bench objects
+ *
+ * @author GerrFrog
+ */
+namespace Bench::Implementors
+{
+    /**
+     * @brief Sum of hashes of all workers
+     *
+     * @author GerrFrog
+     *
+     * @param solver Solver
+     * @return uint64_t
+     */
+    inline uint64_t total_hashes(const Solvers::Solver &solver)
+    {
+        uint64_t total = 0;
+
+        for (auto hashes : solver.get_hashes())
+            total += hashes;
+
+        return total;
+    }
+
+    /**
+     * @brief Wait until solver published job (cache and dataset are ready)
+     *
+     * @author GerrFrog
+     *
+     * @param solver Solver
+     */
+    inline void wait_job(const Solvers::Solver &solver)
+    {
+        while (!solver.get_job())
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    /**
+     * @brief Quote CSV field
+     *
+     * @author GerrFrog
+     *
+     * @param field Field
+     * @return string Field in double quotes
+     */
+    inline string quote(const string &field)
+    {
+        string quoted = "\"";
+
+        for (char c : field)
+        {
+            if (c == '"')
+                quoted += '"';
+            quoted += c;
+        }
+
+        return quoted + "\"";
+    }
+}
+
+/**
+ * @brief Offline benchmarks of the miner
+ *
+ * @author GerrFrog
+ */
+namespace Bench
+{
+    /**
+     * @brief CPU contention benchmark. Runs a CPU-bound victim workload
+     * alone and next to the solver, and reports slowdown of victim and
+     * hashrate of solver. Verifies background mode on shared hosts
+     *
+     * @author GerrFrog
+     */
+    class Contention_Benchmark
+    {
+        private:
+            /**
+             * @brief Solver configuration
+             *
+             * @author GerrFrog
+             */
+            nlohmann::json solver_config;
+
+            /**
+             * @brief Duration of victim workload alone
+             *
+             * @author GerrFrog
+             */
+            double seconds;
+
+            /**
+             * @brief Victim threads
+             *
+             * @author GerrFrog
+             */
+            size_t victims;
+
+            /**
+             * @brief Working set of every victim thread in bytes
+             *
+             * @author GerrFrog
+             */
+            size_t victim_memory;
+
+            /**
+             * @brief Node of pointer chase, one per cache line
+             *
+             * @author GerrFrog
+             */
+            struct alignas(64) Node
+            {
+                /**
+                 * @brief Index of next node
+                 *
+                 * @author GerrFrog
+                 */
+                uint32_t next;
+            };
+
+            /**
+             * @brief Victim working sets
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::vector<Node>> chains;
+
+            /**
+             * @brief Build random cycle through all nodes (Sattolo), so
+             * the hardware prefetcher cannot follow it
+             *
+             * @author GerrFrog
+             *
+             * @param count Number of nodes
+             * @param seed Seed of xorshift
+             * @return std::vector<Node>
+             */
+            static std::vector<Node> make_chain(size_t count, uint64_t seed)
+            {
+                std::vector<uint32_t> order(count);
+                std::vector<Node> nodes(count);
+
+                for (size_t i = 0; i < count; i++)
+                    order[i] = (uint32_t)i;
+                for (size_t i = count - 1; i > 0; i--)
+                {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 7;
+                    seed ^= seed << 17;
+                    std::swap(order[i], order[seed % i]);
+                }
+                for (size_t i = 0; i < count; i++)
+                    nodes[order[i]].next = order[(i + 1) % count];
+
+                return nodes;
+            }
+
+            /**
+             * @brief Victim work: dependent loads over a working set
+             * larger than L2, so it competes with workers for L3 and
+             * memory bandwidth. Result is returned so the loop is not
+             * optimized out
+             *
+             * @author GerrFrog
+             *
+             * @param nodes Working set
+             * @param iterations Loads
+             * @return uint64_t
+             */
+            static uint64_t victim_work(const std::vector<Node> &nodes, uint64_t iterations)
+            {
+                uint32_t index = 0;
+
+                for (uint64_t i = 0; i < iterations; i++)
+                    index = nodes[index].next;
+
+                return index;
+            }
+
+            /**
+             * @brief Run victim threads
+             *
+             * @author GerrFrog
+             *
+             * @param iterations Rounds of every thread
+             * @return double Wall time in seconds
+             */
+            double run_victims(uint64_t iterations) const
+            {
+                std::vector<std::thread> threads;
+                std::vector<uint64_t> results(this->victims);
+                auto started = std::chrono::steady_clock::now();
+
+                for (size_t i = 0; i < this->victims; i++)
+                    threads.emplace_back([this, &results, i, iterations]() {
+                        results[i] = victim_work(this->chains[i], iterations);
+                    });
+                for (auto &thread : threads)
+                    thread.join();
+
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            }
+
+        public:
+            /**
+             * @brief Construct a new Contention_Benchmark object
+             *
+             * @author GerrFrog
+             *
+             * @param solver_config Solver configuration (with background)
+             * @param config Benchmark configuration (seconds, victims,
+             * victim_memory in MiB)
+             */
+            Contention_Benchmark(
+                const nlohmann::json &solver_config,
+                const nlohmann::json &config
+            ) : solver_config(solver_config),
+                seconds(config.value("seconds", 5.0)),
+                victims(config.value("victims", (size_t)0)),
+                victim_memory(std::max(config.value("victim_memory", (size_t)16), (size_t)1) << 20)
+            {
+                if (this->victims == 0)
+                    this->victims = std::max(1u, std::thread::hardware_concurrency());
+                for (size_t i = 0; i < this->victims; i++)
+                    this->chains.push_back(make_chain(this->victim_memory / sizeof(Node), 0x9E3779B97F4A7C15ULL + i));
+            }
+
+            /**
+             * @brief Destroy the Contention_Benchmark object
+             *
+             * @author GerrFrog
+             */
+            ~Contention_Benchmark() = default;
+
+            /**
+             * @brief Run benchmark
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json Report
+             */
+            nlohmann::json run()
+            {
+                // Calibrate victim to run for configured seconds alone
+                uint64_t probe = 1 << 20;
+                double probe_time = this->run_victims(probe);
+                uint64_t iterations = (uint64_t)(probe * this->seconds / std::max(probe_time, 1e-6));
+                double alone = this->run_victims(iterations);
+
+                Solvers::Solver solver(this->solver_config);
+
+                solver.set_job(Solvers::Implementors::synthetic_job("contention", binary(32, 0)));
+                Implementors::wait_job(solver);
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+
+                uint64_t before = Implementors::total_hashes(solver);
+                double contended = this->run_victims(iterations);
+                uint64_t after = Implementors::total_hashes(solver);
+
+                auto started = std::chrono::steady_clock::now();
+
+                std::this_thread::sleep_for(std::chrono::duration<double>(this->seconds));
+
+                double idle_hashrate = (Implementors::total_hashes(solver) - after) /
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+                return {
+                    {"background", solver.get_background().enabled},
+                    {"victims", this->victims},
+                    {"victim_memory", this->victim_memory},
+                    {"miner_threads", solver.get_threads()},
+                    {"victim_alone_seconds", alone},
+                    {"victim_contended_seconds", contended},
+                    {"victim_slowdown_percent", (contended / alone - 1) * 100},
+                    {"hashrate_contended", (after - before) / contended},
+                    {"hashrate_alone", idle_hashrate}
+                };
+            }
+    };
+
+    /**
+     * @brief Offline benchmark of the whole solver: cache and dataset
+     * init, VM creation and hashing of a synthetic job with fixed seed.
+     * Reports are written as JSON and appended to CSV history
+     *
+     * @author GerrFrog
+     */
+    class Solver_Benchmark
+    {
+        public:
+            /**
+             * @brief Columns of CSV history
+             *
+             * @author GerrFrog
+             */
+            static constexpr const char *csv_header = 
+                "timestamp,host,compiler,mode,huge_pages,threads,init_seconds,hashes,hashrate,checksum";
+
+            /**
+             * @brief Nonces of reference checksum
+             *
+             * @author GerrFrog
+             */
+            static constexpr uint32_t checksum_nonces = 16;
+
+        private:
+            /**
+             * @brief Solver configuration
+             *
+             * @author GerrFrog
+             */
+            nlohmann::json solver_config;
+
+            /**
+             * @brief Seed hash
+             *
+             * @author GerrFrog
+             */
+            binary seed;
+
+            /**
+             * @brief Hashes to calculate (0 to run for duration)
+             *
+             * @author GerrFrog
+             */
+            uint64_t nonces;
+
+            /**
+             * @brief Duration of hashing in seconds
+             *
+             * @author GerrFrog
+             */
+            double duration;
+
+            /**
+             * @brief Checksum of hashes of fixed nonces. Equal on every
+             * correct build and host
+             *
+             * @author GerrFrog
+             *
+             * @param hashes Hashes by nonce
+             * @return string SHA-256 of hashes in HEX
+             */
+            static string checksum(const std::vector<binary> &hashes)
+            {
+                string joined;
+                char digest[65] = {0};
+
+                for (const binary &hash : hashes)
+                    joined.append(hash.begin(), hash.end());
+
+                Hashes::SHA_256().completion_hash_sha256_array(joined.data(), joined.size(), digest);
+
+                return digest;
+            }
+
+        public:
+            /**
+             * @brief Construct a new Solver_Benchmark object
+             *
+             * @author GerrFrog
+             *
+             * @param solver_config Solver configuration
+             * @param seed Seed hash in HEX
+             * @param nonces Hashes to calculate (0 to run for duration)
+             * @param duration Duration in seconds
+             */
+            Solver_Benchmark(
+                const nlohmann::json &solver_config,
+                const string &seed,
+                uint64_t nonces,
+                double duration
+            ) : solver_config(solver_config),
+                seed(Utilities::HEX_String(seed).get_decoded()),
+                nonces(nonces),
+                duration(duration)
+            { }
+
+            /**
+             * @brief Destroy the Solver_Benchmark object
+             *
+             * @author GerrFrog
+             */
+            ~Solver_Benchmark() = default;
+
+            /**
+             * @brief Run benchmark
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json Report
+             */
+            nlohmann::json run()
+            {
+                std::mutex checksum_mutex;
+                std::vector<binary> checksum_hashes(checksum_nonces);
+                size_t collected = 0;
+                auto started = std::chrono::steady_clock::now();
+                Solvers::Solver solver(this->solver_config);
+                size_t threads = solver.get_threads();
+
+                // Worker 0 starts at nonce 0, so its VM hashes the fixed nonces
+                solver.set_submit_handler([&](const Solvers::Implementors::Share &share) {
+                    if (share.job_id != "checksum")
+                        return;
+
+                    uint32_t nonce = Utilities::HEX_String(share.nonce);
+                    std::lock_guard<std::mutex> lock(checksum_mutex);
+
+                    if (nonce < checksum_nonces && checksum_hashes[nonce].empty())
+                    {
+                        checksum_hashes[nonce] = Utilities::HEX_String(share.result).get_decoded();
+                        collected++;
+                    }
+                });
+                solver.set_job(Solvers::Implementors::synthetic_job("bench", this->seed));
+                Implementors::wait_job(solver);
+
+                double init = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+                // Window starts when every worker has its VM
+                for (bool ready = false; !ready; )
+                {
+                    std::vector<uint64_t> job_hashes = solver.get_job_hashes();
+
+                    ready = std::all_of(job_hashes.begin(), job_hashes.begin() + threads, [](uint64_t hashes) {
+                        return hashes > 0;
+                    });
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                std::vector<uint64_t> before = solver.get_hashes();
+                uint64_t first = Implementors::total_hashes(solver);
+                auto window = std::chrono::steady_clock::now();
+
+                if (this->nonces == 0)
+                    std::this_thread::sleep_for(std::chrono::duration<double>(this->duration));
+                else
+                    while (Implementors::total_hashes(solver) - first < this->nonces)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                std::vector<uint64_t> after = solver.get_hashes();
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - window).count();
+                nlohmann::json per_thread = nlohmann::json::array();
+                uint64_t hashes = 0;
+
+                for (size_t i = 0; i < threads; i++)
+                {
+                    per_thread.push_back((after[i] - before[i]) / elapsed);
+                    hashes += after[i] - before[i];
+                }
+
+                // Every hash of checksum job is a share
+                Utilities::Pools::New_Job_V1 checksum_job = Solvers::Implementors::synthetic_job("checksum", this->seed);
+
+                checksum_job.target = "ffffffffffffffff";
+                solver.set_job(checksum_job);
+
+                for (bool ready = false; !ready; )
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    std::lock_guard<std::mutex> lock(checksum_mutex);
+
+                    ready = collected == checksum_nonces;
+                }
+
+                solver.stop();
+
+                return {
+                    {"host", Tuner::Topology().describe()},
+                    {"compiler", __VERSION__},
+                    {"mode", solver.is_full_memory() ? "full" : "light"},
+                    {"huge_pages", solver.has_huge_pages()},
+                    {"threads", threads},
+                    {"seed", Utilities::HEX_String(this->seed).get_encoded()},
+                    {"init_seconds", init},
+                    {"dataset_init_seconds", solver.get_dataset_init()},
+                    {"first_hash_ms", solver.get_latency().summary(Statistics::Stage::First_Hash).p50},
+                    {"seconds", elapsed},
+                    {"hashes", hashes},
+                    {"hashrate", hashes / elapsed},
+                    {"hashrate_threads", per_thread},
+                    {"checksum", checksum(checksum_hashes)}
+                };
+            }
+
+            /**
+             * @brief Append report to CSV history (header for new file)
+             *
+             * @author GerrFrog
+             *
+             * @param path Path to CSV file
+             * @param report Report of run()
+             */
+            static void write_csv(const string &path, const nlohmann::json &report)
+            {
+                bool exists = std::filesystem::exists(path);
+                std::ofstream file(path, std::ios::app);
+                std::time_t now = std::time(nullptr);
+
+                if (!exists)
+                    file << csv_header << "\n";
+
+                file
+                    << now << ","
+                    << Implementors::quote(report["host"]) << ","
+                    << Implementors::quote(report["compiler"]) << ","
+                    << report["mode"].get<string>() << ","
+                    << report["huge_pages"].get<bool>() << ","
+                    << report["threads"].get<size_t>() << ","
+                    << report["init_seconds"].get<double>() << ","
+                    << report["hashes"].get<uint64_t>() << ","
+                    << report["hashrate"].get<double>() << ","
+                    << report["checksum"].get<string>() << "\n";
+            }
+
+            /**
+             * @brief Compare report with the last run of the same host,
+             * mode and threads in CSV history
+             *
+             * @author GerrFrog
+             *
+             * @param path Path to CSV file
+             * @param report Report of run()
+             * @return nlohmann::json Comparison (null if there is no such run)
+             */
+            static nlohmann::json compare(const string &path, const nlohmann::json &report)
+            {
+                if (!std::filesystem::exists(path))
+                    return nullptr;
+
+                io::CSVReader<10, io::trim_chars<' '>, io::double_quote_escape<',', '"'>> history(path);
+                string host, compiler, mode, checksum;
+                long long timestamp = 0;
+                int huge_pages = 0;
+                size_t threads = 0;
+                double init = 0, hashrate = 0;
+                uint64_t hashes = 0;
+                nlohmann::json baseline = nullptr;
+
+                history.read_header(
+                    io::ignore_extra_column,
+                    "timestamp", "host", "compiler", "mode", "huge_pages",
+                    "threads", "init_seconds", "hashes", "hashrate", "checksum"
+                );
+
+                while (history.read_row(timestamp, host, compiler, mode, huge_pages, threads, init, hashes, hashrate, checksum))
+                    if (host == report["host"] && mode == report["mode"] && threads == report["threads"])
+                        baseline = {
+                            {"timestamp", timestamp},
+                            {"compiler", compiler},
+                            {"hashrate", hashrate},
+                            {"hashrate_change_percent", (report["hashrate"].get<double>() / hashrate - 1) * 100},
+                            {"init_seconds", init},
+                            {"checksum_match", checksum == report["checksum"]}
+                        };
+
+                return baseline;
+            }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
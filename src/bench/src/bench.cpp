@@ -0,0 +1 @@
+#include "../inc/bench.hpp"
\ No newline at end of file
@@ -185,29 +185,171 @@ namespace Exceptions::Requests
     };
 }
 
+/**
+ * @brief Solver Exceptions
+ * 
+ * @author GerrFrog
+ */
+namespace Exceptions::Solvers
+{
+    /**
+     * @brief Failed to allocate or initialize RandomX structures
+     * 
+     * @author GerrFrog
+     */
+    class RandomX_Error : virtual public std::exception
+    {
+        protected:
+            /**
+             * @brief Error message
+             * 
+             * @author GerrFrog
+             */
+            string error_message;
 
+        public:
+            /**
+             * @brief Construct a new randomx error object
+             * 
+             * @author GerrFrog
+             * 
+             * @param msg Error Message
+             */
+            explicit RandomX_Error(
+                const string& msg
+            ) : error_message(msg)
+            { }
 
+            /**
+             * @brief Destroy the randomx error object
+             * 
+             * @author GerrFrog
+             */
+            virtual ~RandomX_Error() throw()
+            { }
 
+            /**
+             * @brief What method of exceptions
+             * 
+             * @author GerrFrog
+             * 
+             * @return const char* 
+             */
+            virtual const char* what() const throw () { return error_message.c_str(); }
+    };
+}
 
+/**
+ * @brief Monero daemon Exceptions
+ * 
+ * @author GerrFrog
+ */
+namespace Exceptions::Monero
+{
+    /**
+     * @brief Malformed block template of daemon
+     * 
+     * @author GerrFrog
+     */
+    class Template_Error : virtual public std::exception
+    {
+        protected:
+            /**
+             * @brief Error message
+             * 
+             * @author GerrFrog
+             */
+            string error_message;
 
+        public:
+            /**
+             * @brief Construct a new template error object
+             * 
+             * @author GerrFrog
+             * 
+             * @param msg Error Message
+             */
+            explicit Template_Error(
+                const string& msg
+            ) : error_message(msg)
+            { }
 
+            /**
+             * @brief Destroy the template error object
+             * 
+             * @author GerrFrog
+             */
+            virtual ~Template_Error() throw()
+            { }
 
+            /**
+             * @brief What method of exceptions
+             * 
+             * @author GerrFrog
+             * 
+             * @return const char* 
+             */
+            virtual const char* what() const throw () { return error_message.c_str(); }
+    };
+}
 
+/**
+ * @brief Pool protocol Exceptions
+ * 
+ * @author GerrFrog
+ */
+namespace Exceptions::Pools
+{
+    /**
+     * @brief Malformed message of pool
+     * 
+     * @author GerrFrog
+     */
+    class Protocol_Error : virtual public std::exception
+    {
+        protected:
+            /**
+             * @brief Error message
+             * 
+             * @author GerrFrog
+             */
+            string error_message;
 
+        public:
+            /**
+             * @brief Construct a new protocol error object
+             * 
+             * @author GerrFrog
+             * 
+             * @param msg Error Message
+             */
+            explicit Protocol_Error(
+                const string& msg
+            ) : error_message(msg)
+            { }
 
+            /**
+             * @brief Destroy the protocol error object
+             * 
+             * @author GerrFrog
+             */
+            virtual ~Protocol_Error() throw()
+            { }
 
+            /**
+             * @brief What method of exceptions
+             * 
+             * @author GerrFrog
+             * 
+             * @return const char* 
+             */
+            virtual const char* what() const throw () { return error_message.c_str(); }
+    };
+}
 
 
 
 
 
 
-
-
-
-
-
-
-
-
-#endif 
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -307,6 +307,149 @@ namespace Hashes
                 bin_to_hex(hash, 32, buffer);
             }
     };
+
+    /**
+     * @brief Keccak-256 with original padding (cn_fast_hash of Monero,
+     * not SHA3-256)
+     * 
+     * @note https://keccak.team/keccak_specs_summary.html
+     * 
+     * @author GerrFrog
+     */
+    class Keccak_256
+    {
+        private:
+            /**
+             * @brief Absorbed bytes per permutation (1600 - 2 * 256 bits)
+             * 
+             * @author GerrFrog
+             */
+            static constexpr size_t rate = 136;
+
+            /**
+             * @brief Rotate left
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             * @param shift Shift
+             * @return uint64_t 
+             */
+            static uint64_t rotate(uint64_t value, unsigned shift)
+            {
+                return shift == 0 ? value : (value << shift) | (value >> (64 - shift));
+            }
+
+            /**
+             * @brief Keccak-f[1600] permutation
+             * 
+             * @author GerrFrog
+             * 
+             * @param state State
+             */
+            static void permute(uint64_t state[25])
+            {
+                static const uint64_t round_constants[24] = {
+                    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+                    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+                    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+                    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+                    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+                    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+                };
+                static const unsigned rotations[25] = {
+                    0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14
+                };
+
+                for (int round = 0; round < 24; round++)
+                {
+                    uint64_t c[5], b[25];
+
+                    // Theta
+                    for (int x = 0; x < 5; x++)
+                        c[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+                    for (int x = 0; x < 5; x++)
+                    {
+                        uint64_t d = c[(x + 4) % 5] ^ rotate(c[(x + 1) % 5], 1);
+
+                        for (int y = 0; y < 25; y += 5)
+                            state[y + x] ^= d;
+                    }
+
+                    // Rho and Pi
+                    for (int x = 0; x < 5; x++)
+                        for (int y = 0; y < 5; y++)
+                            b[y + 5 * ((2 * x + 3 * y) % 5)] = rotate(state[x + 5 * y], rotations[x + 5 * y]);
+
+                    // Chi
+                    for (int y = 0; y < 25; y += 5)
+                        for (int x = 0; x < 5; x++)
+                            state[y + x] = b[y + x] ^ (~b[y + (x + 1) % 5] & b[y + (x + 2) % 5]);
+
+                    // Iota
+                    state[0] ^= round_constants[round];
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct a new Keccak_256 object
+             * 
+             * @author GerrFrog
+             */
+            Keccak_256() = default;
+
+            /**
+             * @brief Destroy the Keccak_256 object
+             * 
+             * @author GerrFrog
+             */
+            ~Keccak_256() = default;
+
+            /**
+             * @brief Hash single contiguous block of data
+             * 
+             * @author GerrFrog
+             * 
+             * @param data Input data
+             * @param size Size of data
+             * @param hash Output hash (32 bytes)
+             */
+            static void hash(const uint8_t* data, size_t size, uint8_t* hash)
+            {
+                uint64_t state[25] = {0};
+                uint8_t block[rate];
+
+                for (; size >= rate; data += rate, size -= rate)
+                {
+                    for (size_t i = 0; i < rate / 8; i++)
+                    {
+                        uint64_t lane;
+
+                        memcpy(&lane, data + i * 8, 8);
+                        state[i] ^= lane;
+                    }
+                    permute(state);
+                }
+
+                // Original Keccak padding: 0x01 ... 0x80
+                memset(block, 0, rate);
+                memcpy(block, data, size);
+                block[size] |= 0x01;
+                block[rate - 1] |= 0x80;
+
+                for (size_t i = 0; i < rate / 8; i++)
+                {
+                    uint64_t lane;
+
+                    memcpy(&lane, block + i * 8, 8);
+                    state[i] ^= lane;
+                }
+                permute(state);
+
+                memcpy(hash, state, 32);
+            }
+    };
 }
 
 
@@ -0,0 +1,1096 @@
+#pragma once
+
+#ifndef LOGGER_HEADER
+#define LOGGER_HEADER
+
+#include <nlohmann/json.hpp>
+#include <condition_variable>
+#include <type_traits>
+#include <string_view>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ctime>
+
+/**
+ * @brief Lowest level compiled into the binary (0 - trace, 1 - debug,
+ * 2 - info, 3 - warning, 4 - error). Calls below it are removed
+ *
+ * @author GerrFrog
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/**
+ * @brief Implementators for Logger object
+ *
+ * @author GerrFrog
+ */
+namespace Logger::Implementors
+{
+    /**
+     * @brief Type tag of serialized argument
+     *
+     * @author GerrFrog
+     */
+    enum class Argument : uint8_t
+    {
+        Signed,
+        Unsigned,
+        Floating,
+        Boolean,
+        Text
+    };
+
+    /**
+     * @brief Header of record in ring
+     *
+     * @author GerrFrog
+     */
+    struct Record_Header
+    {
+        /**
+         * @brief Size of record with header and padding (0 for padding
+         * record until the end of ring)
+         *
+         * @author GerrFrog
+         */
+        uint32_t size;
+
+        /**
+         * @brief Level
+         *
+         * @author GerrFrog
+         */
+        uint8_t level;
+
+        /**
+         * @brief Number of arguments
+         *
+         * @author GerrFrog
+         */
+        uint8_t arguments;
+
+        /**
+         * @brief Wall time in nanoseconds since epoch
+         *
+         * @author GerrFrog
+         */
+        int64_t time;
+
+        /**
+         * @brief Format string literal with {} placeholders
+         *
+         * @author GerrFrog
+         */
+        const char *format;
+    };
+
+    /**
+     * @brief Ring buffer of serialized records. Single producer (owning
+     * thread), single consumer (drain thread), no locks
+     *
+     * @note Records are aligned to 8 bytes and never split, the tail
+     * of the ring is skipped with a padding record
+     *
+     * @author GerrFrog
+     */
+    class Ring
+    {
+        public:
+            /**
+             * @brief Size of ring in bytes
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t capacity = 1 << 20;
+
+            /**
+             * @brief Longest text argument (longer are truncated)
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t max_text = 16384;
+
+        private:
+            /**
+             * @brief Memory of ring
+             *
+             * @author GerrFrog
+             */
+            std::unique_ptr<unsigned char[]> memory;
+
+            /**
+             * @brief Written bytes (producer)
+             *
+             * @author GerrFrog
+             */
+            alignas(64) std::atomic<uint64_t> head{0};
+
+            /**
+             * @brief Read bytes (consumer)
+             *
+             * @author GerrFrog
+             */
+            alignas(64) std::atomic<uint64_t> tail{0};
+
+            /**
+             * @brief Records dropped because ring was full
+             *
+             * @author GerrFrog
+             */
+            alignas(64) std::atomic<uint64_t> dropped{0};
+
+        public:
+            /**
+             * @brief Thread number of producer
+             *
+             * @author GerrFrog
+             */
+            const size_t thread;
+
+            /**
+             * @brief Producer thread has exited
+             *
+             * @author GerrFrog
+             */
+            std::atomic<bool> closed{false};
+
+            /**
+             * @brief Construct a new Ring object
+             *
+             * @author GerrFrog
+             *
+             * @param thread Thread number of producer
+             */
+            Ring(
+                size_t thread
+            ) : memory(new unsigned char[capacity]),
+                thread(thread)
+            { }
+
+            /**
+             * @brief Destroy the Ring object
+             *
+             * @author GerrFrog
+             */
+            ~Ring() = default;
+
+            /**
+             * @brief Reserve space for record of size bytes
+             *
+             * @author GerrFrog
+             *
+             * @param size Size of record (aligned to 8 bytes)
+             * @return unsigned char* Memory for record or nullptr if full
+             */
+            unsigned char *reserve(size_t size)
+            {
+                uint64_t head = this->head.load(std::memory_order_relaxed);
+                uint64_t tail = this->tail.load(std::memory_order_acquire);
+                size_t offset = head % capacity;
+                size_t until_end = capacity - offset;
+                size_t needed = size <= until_end ? size : until_end + size;
+
+                if (size > capacity / 2 || capacity - (head - tail) < needed)
+                {
+                    this->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                if (size > until_end)
+                {
+                    Record_Header padding{};
+
+                    // Less than a header until the end is skipped without padding record
+                    if (until_end >= sizeof(padding))
+                        std::memcpy(this->memory.get() + offset, &padding, sizeof(padding));
+                    this->head.store(head + until_end, std::memory_order_release);
+                    offset = 0;
+                }
+
+                return this->memory.get() + offset;
+            }
+
+            /**
+             * @brief Publish reserved record
+             *
+             * @author GerrFrog
+             *
+             * @param size Size of record
+             */
+            void commit(size_t size)
+            {
+                uint64_t head = this->head.load(std::memory_order_relaxed);
+
+                this->head.store(head + size, std::memory_order_release);
+            }
+
+            /**
+             * @brief Get next record for consumer
+             *
+             * @author GerrFrog
+             *
+             * @return const unsigned char* Record or nullptr if empty
+             */
+            const unsigned char *front()
+            {
+                while (true)
+                {
+                    uint64_t tail = this->tail.load(std::memory_order_relaxed);
+                    uint64_t head = this->head.load(std::memory_order_acquire);
+
+                    if (tail == head)
+                        return nullptr;
+
+                    size_t until_end = capacity - tail % capacity;
+
+                    if (until_end < sizeof(Record_Header))
+                    {
+                        this->tail.store(tail + until_end, std::memory_order_release);
+                        continue;
+                    }
+
+                    const unsigned char *record = this->memory.get() + tail % capacity;
+                    Record_Header header;
+
+                    std::memcpy(&header, record, sizeof(header));
+
+                    if (header.size != 0)
+                        return record;
+
+                    // Padding until the end of ring
+                    this->tail.store(tail + capacity - tail % capacity, std::memory_order_release);
+                }
+            }
+
+            /**
+             * @brief Release record returned by front
+             *
+             * @author GerrFrog
+             *
+             * @param size Size of record
+             */
+            void pop(size_t size)
+            {
+                this->tail.store(
+                    this->tail.load(std::memory_order_relaxed) + size,
+                    std::memory_order_release
+                );
+            }
+
+            /**
+             * @brief Check if ring is empty
+             *
+             * @author GerrFrog
+             *
+             * @return bool
+             */
+            bool empty() const
+            {
+                return this->tail.load(std::memory_order_acquire) == this->head.load(std::memory_order_acquire);
+            }
+
+            /**
+             * @brief Take number of dropped records
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t take_dropped()
+            {
+                return this->dropped.exchange(0, std::memory_order_relaxed);
+            }
+    };
+
+    /**
+     * @brief Serializer of arguments into record payload
+     *
+     * @author GerrFrog
+     */
+    class Encoder
+    {
+        private:
+            /**
+             * @brief Text of argument
+             *
+             * @author GerrFrog
+             *
+             * @tparam T Type of argument
+             * @param value Argument
+             * @return std::string_view
+             */
+            template<class T>
+            static std::string_view text(const T &value)
+            {
+                if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                    return std::string_view(value);
+                else
+                    return std::string_view(value.data(), value.size());
+            }
+
+        public:
+            /**
+             * @brief Get serialized size of argument
+             *
+             * @author GerrFrog
+             *
+             * @tparam T Type of argument
+             * @param value Argument
+             * @return size_t
+             */
+            template<class T>
+            static size_t size(const T &value)
+            {
+                if constexpr (std::is_arithmetic_v<T>)
+                    return 1 + 8;
+                else
+                    return 1 + sizeof(uint32_t) + std::min(text(value).size(), Ring::max_text);
+            }
+
+            /**
+             * @brief Serialize argument
+             *
+             * @author GerrFrog
+             *
+             * @tparam T Type of argument
+             * @param output Output memory
+             * @param value Argument
+             * @return unsigned char* Memory after argument
+             */
+            template<class T>
+            static unsigned char *write(unsigned char *output, const T &value)
+            {
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    uint64_t data = value;
+                    *output = (uint8_t)Argument::Boolean;
+                    std::memcpy(output + 1, &data, 8);
+                    return output + 9;
+                } else if constexpr (std::is_floating_point_v<T>) {
+                    double data = value;
+                    *output = (uint8_t)Argument::Floating;
+                    std::memcpy(output + 1, &data, 8);
+                    return output + 9;
+                } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                    int64_t data = value;
+                    *output = (uint8_t)Argument::Signed;
+                    std::memcpy(output + 1, &data, 8);
+                    return output + 9;
+                } else if constexpr (std::is_integral_v<T>) {
+                    uint64_t data = value;
+                    *output = (uint8_t)Argument::Unsigned;
+                    std::memcpy(output + 1, &data, 8);
+                    return output + 9;
+                } else {
+                    std::string_view data = text(value);
+                    uint32_t length = std::min(data.size(), Ring::max_text);
+
+                    *output = (uint8_t)Argument::Text;
+                    std::memcpy(output + 1, &length, sizeof(length));
+                    std::memcpy(output + 1 + sizeof(length), data.data(), length);
+                    return output + 1 + sizeof(length) + length;
+                }
+            }
+
+            /**
+             * @brief Deserialize argument into text
+             *
+             * @author GerrFrog
+             *
+             * @param input Serialized argument
+             * @param output Output text
+             * @return const unsigned char* Memory after argument
+             */
+            static const unsigned char *read(const unsigned char *input, string &output)
+            {
+                Argument type = (Argument)*input;
+
+                if (type == Argument::Text)
+                {
+                    uint32_t length;
+
+                    std::memcpy(&length, input + 1, sizeof(length));
+                    output.append((const char*)input + 1 + sizeof(length), length);
+                    return input + 1 + sizeof(length) + length;
+                }
+
+                unsigned char data[8];
+                std::memcpy(data, input + 1, 8);
+
+                switch (type)
+                {
+                    case Argument::Signed:
+                    {
+                        int64_t value;
+                        std::memcpy(&value, data, 8);
+                        output += std::to_string(value);
+                        break;
+                    }
+                    case Argument::Unsigned:
+                    {
+                        uint64_t value;
+                        std::memcpy(&value, data, 8);
+                        output += std::to_string(value);
+                        break;
+                    }
+                    case Argument::Floating:
+                    {
+                        double value;
+                        char text[32];
+                        std::memcpy(&value, data, 8);
+                        std::snprintf(text, sizeof(text), "%g", value);
+                        output += text;
+                        break;
+                    }
+                    default:
+                        output += data[0] ? "true" : "false";
+                }
+
+                return input + 9;
+            }
+    };
+}
+
+/**
+ * @brief Asynchronous logger
+ *
+ * @author GerrFrog
+ */
+namespace Logger
+{
+    /**
+     * @brief Level of record
+     *
+     * @author GerrFrog
+     */
+    enum class Level : uint8_t
+    {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    /**
+     * @brief Logger with per-thread lock-free rings drained by a background
+     * thread into rotating files. Producers never block: when a ring is
+     * full the record is dropped and counted
+     *
+     * @note Arguments are stored in binary form, text is formatted by
+     * the drain thread
+     *
+     * @author GerrFrog
+     */
+    class Async_Logger
+    {
+        private:
+            /**
+             * @brief Ring of current thread. Marks ring closed on thread exit
+             *
+             * @author GerrFrog
+             */
+            struct Thread_Ring
+            {
+                /**
+                 * @brief Ring
+                 *
+                 * @author GerrFrog
+                 */
+                std::shared_ptr<Implementors::Ring> ring;
+
+                /**
+                 * @brief Destroy the Thread_Ring object
+                 *
+                 * @author GerrFrog
+                 */
+                ~Thread_Ring()
+                {
+                    if (this->ring)
+                        this->ring->closed.store(true);
+                }
+            };
+
+            /**
+             * @brief Rings of all threads
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::shared_ptr<Implementors::Ring>> rings;
+
+            /**
+             * @brief Guard for rings list (registration and drain only)
+             *
+             * @author GerrFrog
+             */
+            std::mutex rings_mutex;
+
+            /**
+             * @brief Number of registered threads
+             *
+             * @author GerrFrog
+             */
+            size_t thread_count = 0;
+
+            /**
+             * @brief Minimal level at runtime
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint8_t> level{(uint8_t)Level::Info};
+
+            /**
+             * @brief Minimal level printed to console
+             *
+             * @author GerrFrog
+             */
+            Level console_level = Level::Info;
+
+            /**
+             * @brief Directory for files
+             *
+             * @author GerrFrog
+             */
+            std::filesystem::path directory = "logs";
+
+            /**
+             * @brief Maximum size of one file
+             *
+             * @author GerrFrog
+             */
+            uint64_t max_size = 10 * 1024 * 1024;
+
+            /**
+             * @brief Number of rotated files to keep
+             *
+             * @author GerrFrog
+             */
+            size_t max_files = 5;
+
+            /**
+             * @brief Current file
+             *
+             * @author GerrFrog
+             */
+            std::ofstream file;
+
+            /**
+             * @brief Size of current file
+             *
+             * @author GerrFrog
+             */
+            uint64_t file_size = 0;
+
+            /**
+             * @brief Second of formatted time stamp
+             *
+             * @author GerrFrog
+             */
+            std::time_t stamp_seconds = -1;
+
+            /**
+             * @brief Formatted time stamp (up to seconds)
+             *
+             * @author GerrFrog
+             */
+            char stamp[32] = {};
+
+            /**
+             * @brief Drain thread is running
+             *
+             * @author GerrFrog
+             */
+            std::atomic<bool> running{false};
+
+            /**
+             * @brief Drain thread
+             *
+             * @author GerrFrog
+             */
+            std::thread drainer;
+
+            /**
+             * @brief Guard for drain thread sleep
+             *
+             * @author GerrFrog
+             */
+            std::mutex sleep_mutex;
+
+            /**
+             * @brief Wakes up drain thread on stop
+             *
+             * @author GerrFrog
+             */
+            std::condition_variable wakeup;
+
+            /**
+             * @brief Construct a new Async_Logger object
+             *
+             * @author GerrFrog
+             */
+            Async_Logger() = default;
+
+            /**
+             * @brief Get ring of current thread
+             *
+             * @author GerrFrog
+             *
+             * @return Implementors::Ring&
+             */
+            Implementors::Ring &thread_ring()
+            {
+                thread_local Thread_Ring current;
+
+                if (!current.ring)
+                {
+                    std::lock_guard<std::mutex> lock(this->rings_mutex);
+
+                    current.ring = std::make_shared<Implementors::Ring>(this->thread_count++);
+                    this->rings.push_back(current.ring);
+                }
+
+                return *current.ring;
+            }
+
+            /**
+             * @brief Name of level
+             *
+             * @author GerrFrog
+             *
+             * @param level Level
+             * @return const char*
+             */
+            static const char *level_name(uint8_t level)
+            {
+                static const char *names[] = {"TRACE", "DEBUG", "INFO ", "WARN ", "ERROR"};
+
+                return level < 5 ? names[level] : "?????";
+            }
+
+            /**
+             * @brief Format record into line (drain thread only)
+             *
+             * @author GerrFrog
+             *
+             * @param record Record
+             * @param thread Thread number
+             * @return string
+             */
+            string format(const unsigned char *record, size_t thread)
+            {
+                Implementors::Record_Header header;
+                std::memcpy(&header, record, sizeof(header));
+
+                std::time_t seconds = header.time / 1000000000;
+
+                // Local time is expensive, so it is formatted once per second
+                if (seconds != this->stamp_seconds)
+                {
+                    std::tm local{};
+
+                    localtime_r(&seconds, &local);
+                    std::strftime(this->stamp, sizeof(this->stamp), "%Y-%m-%d %H:%M:%S", &local);
+                    this->stamp_seconds = seconds;
+                }
+
+                string line;
+                char micro[16];
+
+                std::snprintf(micro, sizeof(micro), ".%06lld", (long long)(header.time / 1000 % 1000000));
+                line.reserve(128);
+                line.append(this->stamp).append(micro)
+                    .append(" [").append(level_name(header.level)).append("] [t")
+                    .append(std::to_string(thread)).append("] ");
+
+                const unsigned char *argument = record + sizeof(header);
+                size_t remaining = header.arguments;
+
+                for (const char *c = header.format; *c != '\0'; c++)
+                {
+                    if (c[0] == '{' && c[1] == '}' && remaining > 0)
+                    {
+                        argument = Implementors::Encoder::read(argument, line);
+                        remaining--;
+                        c++;
+                    } else {
+                        line.push_back(*c);
+                    }
+                }
+                // Arguments without placeholder are appended
+                while (remaining-- > 0)
+                {
+                    line.push_back(' ');
+                    argument = Implementors::Encoder::read(argument, line);
+                }
+
+                return line;
+            }
+
+            /**
+             * @brief Open file, rotate old files if current is too big
+             *
+             * @author GerrFrog
+             */
+            void open_file()
+            {
+                std::filesystem::path path = this->directory / "cpuminer.log";
+                std::error_code err;
+
+                if (this->file.is_open())
+                    this->file.close();
+
+                if (std::filesystem::exists(path, err) && std::filesystem::file_size(path, err) >= this->max_size)
+                {
+                    for (size_t i = this->max_files; i > 1; i--)
+                        std::filesystem::rename(
+                            this->directory / ("cpuminer." + std::to_string(i - 1) + ".log"),
+                            this->directory / ("cpuminer." + std::to_string(i) + ".log"),
+                            err
+                        );
+                    std::filesystem::rename(path, this->directory / "cpuminer.1.log", err);
+                }
+
+                std::filesystem::create_directories(this->directory, err);
+                this->file.open(path, std::ios::app);
+                this->file_size = std::filesystem::exists(path, err) ? std::filesystem::file_size(path, err) : 0;
+            }
+
+            /**
+             * @brief Write line to file and console
+             *
+             * @author GerrFrog
+             *
+             * @param line Line
+             * @param level Level
+             */
+            void output(const string &line, uint8_t level)
+            {
+                if (this->file.is_open())
+                {
+                    this->file << line << '\n';
+                    this->file_size += line.size() + 1;
+
+                    if (this->file_size >= this->max_size)
+                        this->open_file();
+                }
+                if (level >= (uint8_t)this->console_level)
+                    cout << line << '\n';
+            }
+
+            /**
+             * @brief Write all records from rings
+             *
+             * @author GerrFrog
+             *
+             * @return bool Something was written
+             */
+            bool drain()
+            {
+                std::vector<std::shared_ptr<Implementors::Ring>> rings;
+                bool written = false;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->rings_mutex);
+                    rings = this->rings;
+                }
+
+                for (auto &ring : rings)
+                {
+                    uint64_t dropped = ring->take_dropped();
+
+                    if (dropped != 0)
+                        this->output(
+                            "[logger] " + std::to_string(dropped) + " records of thread t"
+                                + std::to_string(ring->thread) + " dropped",
+                            (uint8_t)Level::Warning
+                        );
+
+                    while (const unsigned char *record = ring->front())
+                    {
+                        Implementors::Record_Header header;
+                        std::memcpy(&header, record, sizeof(header));
+
+                        this->output(format(record, ring->thread), header.level);
+                        ring->pop(header.size);
+                        written = true;
+                    }
+                }
+
+                if (written)
+                {
+                    this->file.flush();
+                    cout.flush();
+                }
+
+                // Forget rings of exited threads
+                std::lock_guard<std::mutex> lock(this->rings_mutex);
+
+                this->rings.erase(
+                    std::remove_if(
+                        this->rings.begin(),
+                        this->rings.end(),
+                        [](const std::shared_ptr<Implementors::Ring> &ring) {
+                            return ring->closed.load() && ring->empty();
+                        }
+                    ),
+                    this->rings.end()
+                );
+
+                return written;
+            }
+
+            /**
+             * @brief Loop of drain thread
+             *
+             * @author GerrFrog
+             */
+            void run()
+            {
+                while (this->running.load())
+                {
+                    if (!this->drain())
+                    {
+                        std::unique_lock<std::mutex> lock(this->sleep_mutex);
+
+                        this->wakeup.wait_for(lock, std::chrono::milliseconds(20), [this] {
+                            return !this->running.load();
+                        });
+                    }
+                }
+                this->drain();
+            }
+
+        public:
+            /**
+             * @brief Destroy the Async_Logger object. Writes remaining records
+             *
+             * @author GerrFrog
+             */
+            ~Async_Logger()
+            {
+                this->stop();
+            }
+
+            /**
+             * @brief Get logger
+             *
+             * @author GerrFrog
+             *
+             * @return Async_Logger&
+             */
+            static Async_Logger &instance()
+            {
+                static Async_Logger logger;
+
+                return logger;
+            }
+
+            /**
+             * @brief Parse level name
+             *
+             * @author GerrFrog
+             *
+             * @param name trace, debug, info, warning or error
+             * @return Level
+             */
+            static Level parse_level(const string &name)
+            {
+                if (name == "trace") return Level::Trace;
+                if (name == "debug") return Level::Debug;
+                if (name == "warning") return Level::Warning;
+                if (name == "error") return Level::Error;
+                return Level::Info;
+            }
+
+            /**
+             * @brief Start drain thread. Records written before start are
+             * kept in rings
+             *
+             * @author GerrFrog
+             *
+             * @param config Logger configuration (directory, level,
+             * console_level, max_size, max_files)
+             */
+            void start(const nlohmann::json &config)
+            {
+                if (this->running.load())
+                    return;
+
+                if (config.is_object())
+                {
+                    this->directory = config.value("directory", this->directory.string());
+                    this->level.store((uint8_t)parse_level(config.value("level", "info")));
+                    this->console_level = parse_level(config.value("console_level", "info"));
+                    this->max_size = config.value("max_size", this->max_size);
+                    this->max_files = std::max<size_t>(1, config.value("max_files", this->max_files));
+                }
+
+                this->open_file();
+                this->running.store(true);
+                this->drainer = std::thread(&Async_Logger::run, this);
+            }
+
+            /**
+             * @brief Stop drain thread and write remaining records
+             *
+             * @author GerrFrog
+             */
+            void stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->sleep_mutex);
+                    this->running.store(false);
+                }
+                this->wakeup.notify_all();
+
+                if (this->drainer.joinable())
+                    this->drainer.join();
+            }
+
+            /**
+             * @brief Check if level is enabled at runtime
+             *
+             * @author GerrFrog
+             *
+             * @param level Level
+             * @return bool
+             */
+            bool enabled(Level level) const
+            {
+                return (uint8_t)level >= this->level.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Write record into ring of current thread
+             *
+             * @author GerrFrog
+             *
+             * @tparam Args Types of arguments
+             * @param level Level
+             * @param format Format string literal with {} placeholders
+             * @param args Arguments (numbers, bool and strings)
+             */
+            template<class... Args>
+            void write(Level level, const char *format, const Args&... args)
+            {
+                static_assert(sizeof...(Args) < 256, "Too many arguments");
+
+                Implementors::Ring &ring = this->thread_ring();
+                size_t size = sizeof(Implementors::Record_Header);
+
+                ((size += Implementors::Encoder::size(args)), ...);
+                size = (size + 7) & ~(size_t)7;
+
+                unsigned char *record = ring.reserve(size);
+
+                if (record == nullptr)
+                    return;
+
+                Implementors::Record_Header header{
+                    (uint32_t)size,
+                    (uint8_t)level,
+                    (uint8_t)sizeof...(Args),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()
+                    ).count(),
+                    format
+                };
+                [[maybe_unused]] unsigned char *argument = record + sizeof(header);
+
+                std::memcpy(record, &header, sizeof(header));
+                ((argument = Implementors::Encoder::write(argument, args)), ...);
+
+                ring.commit(size);
+            }
+    };
+
+    /**
+     * @brief Write record. Levels below LOG_LEVEL are removed at compile time
+     *
+     * @author GerrFrog
+     *
+     * @tparam level Level
+     * @tparam Args Types of arguments
+     * @param format Format string literal with {} placeholders
+     * @param args Arguments
+     */
+    template<Level level, class... Args>
+    inline void log(const char *format, const Args&... args)
+    {
+        if constexpr ((int)level >= LOG_LEVEL)
+        {
+            Async_Logger &logger = Async_Logger::instance();
+
+            if (logger.enabled(level))
+                logger.write(level, format, args...);
+        }
+    }
+
+    /**
+     * @brief Write trace record
+     *
+     * @author GerrFrog
+     */
+    template<class... Args>
+    inline void trace(const char *format, const Args&... args) { log<Level::Trace>(format, args...); }
+
+    /**
+     * @brief Write debug record
+     *
+     * @author GerrFrog
+     */
+    template<class... Args>
+    inline void debug(const char *format, const Args&... args) { log<Level::Debug>(format, args...); }
+
+    /**
+     * @brief Write info record
+     *
+     * @author GerrFrog
+     */
+    template<class... Args>
+    inline void info(const char *format, const Args&... args) { log<Level::Info>(format, args...); }
+
+    /**
+     * @brief Write warning record
+     *
+     * @author GerrFrog
+     */
+    template<class... Args>
+    inline void warning(const char *format, const Args&... args) { log<Level::Warning>(format, args...); }
+
+    /**
+     * @brief Write error record
+     *
+     * @author GerrFrog
+     */
+    template<class... Args>
+    inline void error(const char *format, const Args&... args) { log<Level::Error>(format, args...); }
+}
+
+
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
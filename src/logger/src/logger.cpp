@@ -0,0 +1 @@
+#include "../inc/logger.hpp"
\ No newline at end of file
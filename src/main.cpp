@@ -29,8 +29,21 @@ int main(int argc, char *argv[])
         options.add_options()
             ("s,server", "Server configuration")
             ("p,proxy", "Proxy configuration")
+            ("c,contention", "Run CPU contention benchmark with solver configuration")
             ("h,help", "Help for arguments list")
+            ("command", "Subcommand (bench, verify)", cxxopts::value<string>()->default_value(""))
         ;
+        options.add_options("bench")
+            ("nonces", "Hashes to calculate (0 to run for duration)", cxxopts::value<uint64_t>()->default_value("0"))
+            ("duration", "Duration of hashing in seconds", cxxopts::value<double>()->default_value("10"))
+            ("seed", "Seed hash in HEX", cxxopts::value<string>()->default_value(string(64, '0')))
+            ("threads", "Solver threads (0 for configuration)", cxxopts::value<size_t>()->default_value("0"))
+            ("json", "Write JSON report to file", cxxopts::value<string>())
+            ("csv", "Append report to CSV history", cxxopts::value<string>())
+            ("baseline", "Compare with CSV history", cxxopts::value<string>())
+        ;
+        options.parse_positional({"command"});
+        options.positional_help("[bench|verify]");
 
         auto result = options.parse(argc, argv);
         
@@ -44,14 +57,209 @@ int main(int argc, char *argv[])
                 << "HTTP_PROXY: " << http_proxy << endl
                 << "HTTPS_PROXY: " << https_proxy << endl
             << endl;
+        Logger::Async_Logger::instance().start(configuration["logger"]);
+
+        if (result.count("contention"))
+        {
+            cout << Bench::Contention_Benchmark(
+                configuration["solver"],
+                configuration.value("bench", nlohmann::json::object())
+            ).run().dump(4) << endl;
+            Logger::Async_Logger::instance().stop();
+
+            return EXIT_SUCCESS;
+        }
+        if (result["command"].as<string>() == "bench")
+        {
+            nlohmann::json solver_config = configuration["solver"];
+
+            if (result["threads"].as<size_t>() != 0)
+                solver_config["threads"] = result["threads"].as<size_t>();
+
+            nlohmann::json report = Bench::Solver_Benchmark(
+                solver_config,
+                result["seed"].as<string>(),
+                result["nonces"].as<uint64_t>(),
+                result["duration"].as<double>()
+            ).run();
+
+            if (result.count("baseline"))
+                report["baseline"] = Bench::Solver_Benchmark::compare(result["baseline"].as<string>(), report);
+            if (result.count("csv"))
+                Bench::Solver_Benchmark::write_csv(result["csv"].as<string>(), report);
+            if (result.count("json"))
+                std::ofstream(result["json"].as<string>()) << report.dump(4) << endl;
+            cout << report.dump(4) << endl;
+            Logger::Async_Logger::instance().stop();
+
+            return EXIT_SUCCESS;
+        }
+        if (result["command"].as<string>() == "verify")
+        {
+            Verifier::Verifier_Server(
+                configuration.value("verifier", nlohmann::json::object())
+            ).run();
+            Logger::Async_Logger::instance().stop();
+
+            return EXIT_SUCCESS;
+        }
+        if (!result["command"].as<string>().empty())
+        {
+            cout << options.help() << endl;
+
+            return EXIT_FAILURE;
+        }
+
         if (result.count("server"))
             cout
                 << "SERVER HOST: " << (string)configuration["server"]["host"] << endl
                 << "SERVER PORT: " << (int)configuration["server"]["port"] << endl
             << endl;
 
-        Pools::Pool_V1 pool(configuration["pool"]);
-        std::cin.ignore();
+        // Logger is stopped last, after the solver and connections
+        std::shared_ptr<void> stop_logger(nullptr, [](void *) { Logger::Async_Logger::instance().stop(); });
+
+        Solvers::Solver solver(configuration["solver"]);
+
+        solver.set_pool(
+            0,
+            configuration["pool"].value("name", (string)configuration["pool"]["host"]),
+            configuration["pool"].value("weight", 1.0)
+        );
+
+        std::vector<unsigned> network_cpus = Tuner::parse_cpus(
+            configuration["solver"].value("network_cpus", nlohmann::json::array())
+        );
+
+        // Pools, daemon and HTTP API share network threads
+        Network::Runtime runtime(
+            configuration.value("network", nlohmann::json::object()).value("threads", 1),
+            network_cpus
+        );
+        std::unique_ptr<Server::Control_Server> server;
+        std::unique_ptr<Pools::Solo_V1> solo;
+        std::unique_ptr<Pools::Implementors::Stratum_Socket> pool;
+        std::vector<std::unique_ptr<Pools::Implementors::Stratum_Socket>> secondary_pools;
+
+        // Workers and network threads are stopped before connections 
+        // are destroyed, workers call submit handlers of pools
+        std::shared_ptr<void> stop_network(nullptr, [&runtime, &solver, &solo](void *) { 
+            if (solo)
+                solo->stop();
+            solver.stop();
+            runtime.stop();
+        });
+
+        if (configuration.contains("server"))
+            server = std::make_unique<Server::Control_Server>(
+                runtime.get_context(),
+                configuration["server"],
+                solver
+            );
+        Tuner::Cgroup_Limits limits;
+        Tuner::Topology topology(network_cpus, limits.get_allowed());
+        std::vector<unsigned> placement = Tuner::placement(configuration["solver"], topology);
+        bool automatic = configuration["solver"].value("threads", 0) == 0;
+
+        if (!placement.empty())
+        {
+            solver.set_affinity(placement);
+            if (automatic)
+                solver.set_threads(placement.size());
+        }
+
+        // Explicit thread count in configuration disables tuning
+        if (
+            configuration.contains("tuner") &&
+            configuration["tuner"].value("enabled", false) &&
+            automatic
+        )
+            Tuner::Auto_Tuner(configuration["tuner"]).tune(
+                solver,
+                configuration["solver"].value("mode", string("full")),
+                topology,
+                configuration["solver"].value("affinity", nlohmann::json("off")) == "auto"
+            );
+
+        // More threads than cpu.max allows are throttled
+        if (automatic && limits.get_threads() != 0 && solver.get_threads() > limits.get_threads())
+        {
+            Logger::info("cgroup quota {} cpus, using {} threads", limits.get_quota(), limits.get_threads());
+            solver.set_threads(limits.get_threads());
+        }
+
+        std::unique_ptr<Tuner::Load_Governor> governor;
+
+        if (configuration.contains("governor") && configuration["governor"].value("enabled", false))
+            governor = std::make_unique<Tuner::Load_Governor>(
+                configuration["governor"],
+                solver,
+                limits.get_threads() != 0 ? 
+                    std::min(limits.get_threads(), topology.get_cpus()) : 
+                    topology.get_cpus()
+            );
+
+        auto dump_latency = [&solver]() {
+            cout << endl << "Pipeline latency:" << endl;
+            solver.get_latency().dump(cout);
+        };
+
+        // Signal only wakes this thread, which stops the miner
+        std::promise<void> interrupted;
+        net::signal_set signals(runtime.get_context(), SIGINT, SIGTERM);
+
+        signals.async_wait([&interrupted](const boost::system::error_code &err, int) {
+            if (!err)
+                interrupted.set_value();
+        });
+
+        // Solo mining replaces pools
+        if (configuration.contains("solo") && configuration["solo"].value("enabled", false))
+        {
+            solo = std::make_unique<Pools::Solo_V1>(runtime.get_context(), configuration["solo"], &solver);
+            solo->start();
+        }
+
+        auto connect = [&runtime, &solver](nlohmann::json &config, size_t index) 
+            -> std::unique_ptr<Pools::Implementors::Stratum_Socket>
+        {
+            if (config.value("protocol", "v1") == "v2")
+                return std::make_unique<Pools::Pool_V2>(runtime.get_context(), config, &solver, index);
+            return std::make_unique<Pools::Pool_V1>(runtime.get_context(), config, &solver, index);
+        };
+
+        if (!solo)
+            pool = connect(configuration["pool"], 0);
+
+        // Secondary pools get a part of hashrate by weight
+        if (!solo && configuration.contains("pools"))
+            for (auto &config : configuration["pools"])
+                secondary_pools.push_back(connect(config, solver.add_pool(
+                    config.value("name", (string)config["host"]),
+                    config.value("weight", 1.0)
+                )));
+
+        // Enter stops the miner, without terminal only a signal does
+        std::thread([]() {
+            std::cin.ignore();
+            if (!std::cin.eof())
+                std::raise(SIGINT);
+        }).detach();
+
+        interrupted.get_future().wait();
+
+        // Connections are destroyed when no worker submits shares to
+        // them and runtime is stopped, solo loop waits for requests on
+        // runtime
+        if (solo)
+            solo->stop();
+        solver.stop();
+        runtime.stop();
+        secondary_pools.clear();
+        pool.reset();
+        solo.reset();
+        server.reset();
+        dump_latency();
 
     } catch (std::logic_error& exp) {
         cout 
@@ -9,10 +9,22 @@
 #include <fstream>
 #include <cxxopts.hpp>
 #include <limits>
+#include <memory>
+#include <thread>
+#include <future>
+#include <csignal>
 
 #include "requests/inc/requests.hpp"
+#include "network/inc/network.hpp"
 #include "pools/inc/pools.hpp"
 #include "pools/inc/test.hpp"
+#include "solvers/inc/solvers.hpp"
+#include "server/inc/server.hpp"
+#include "logger/inc/logger.hpp"
+#include "tuner/inc/tuner.hpp"
+#include "bench/inc/bench.hpp"
+#include "verifier/inc/verifier.hpp"
+#include "monero/inc/monero.hpp"
 #include "libs/csv/csv.hpp"
 #include "libs/dotenv/include/dotenv.hpp"
 
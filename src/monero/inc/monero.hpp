@@ -0,0 +1,613 @@
+#pragma once
+
+#ifndef MONERO_HEADER
+#define MONERO_HEADER
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "../../exceptions/inc/exceptions.hpp"
+#include "../../utilities/inc/utilities.hpp"
+#include "../../hashes/inc/hashes.hpp"
+
+using std::string;
+
+/**
+ * @brief Implementators for Monero objects
+ *
+ * @author GerrFrog
+ */
+namespace Monero::Implementors
+{
+    /**
+     * @brief 32-byte hash
+     *
+     * @author GerrFrog
+     */
+    using Hash = std::array<uint8_t, 32>;
+
+    /**
+     * @brief Keccak-256 of data (cn_fast_hash)
+     *
+     * @author GerrFrog
+     *
+     * @param data Data
+     * @param size Size of data
+     * @return Hash
+     */
+    inline Hash fast_hash(const uint8_t *data, size_t size)
+    {
+        Hash hash;
+
+        Hashes::Keccak_256::hash(data, size, hash.data());
+
+        return hash;
+    }
+
+    /**
+     * @brief Keccak-256 of two concatenated hashes (node of tree hash)
+     *
+     * @author GerrFrog
+     *
+     * @param left Left hash
+     * @param right Right hash
+     * @return Hash
+     */
+    inline Hash fast_hash(const Hash &left, const Hash &right)
+    {
+        uint8_t pair[64];
+
+        std::memcpy(pair, left.data(), 32);
+        std::memcpy(pair + 32, right.data(), 32);
+
+        return fast_hash(pair, sizeof(pair));
+    }
+
+    /**
+     * @brief Read varint (7 bits per byte, little endian)
+     *
+     * @author GerrFrog
+     *
+     * @param blob Blob
+     * @param offset Offset of varint, moved after it
+     * @return uint64_t
+     */
+    inline uint64_t read_varint(const binary &blob, size_t &offset)
+    {
+        uint64_t value = 0;
+
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (offset >= blob.size())
+                throw Exceptions::Monero::Template_Error("Unexpected end of blob in varint");
+
+            uint8_t byte = blob[offset++];
+
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+
+        throw Exceptions::Monero::Template_Error("Varint is too long");
+    }
+
+    /**
+     * @brief Append varint
+     *
+     * @author GerrFrog
+     *
+     * @param blob Blob
+     * @param value Value
+     */
+    inline void write_varint(binary &blob, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            blob.push_back((uint8_t)(value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        blob.push_back((uint8_t)value);
+    }
+
+    /**
+     * @brief Skip bytes
+     *
+     * @author GerrFrog
+     *
+     * @param blob Blob
+     * @param offset Offset, moved after skipped bytes
+     * @param size Number of bytes
+     */
+    inline void skip(const binary &blob, size_t &offset, size_t size)
+    {
+        if (blob.size() - offset < size)
+            throw Exceptions::Monero::Template_Error("Unexpected end of blob");
+        offset += size;
+    }
+
+    /**
+     * @brief Siblings on the path of the first leaf of Monero tree hash
+     * (crypto/tree-hash.c). The first leaf is always the leftmost node,
+     * so the root is fold of fast_hash(node, sibling)
+     *
+     * @author GerrFrog
+     *
+     * @param hashes Leaves (the first one is only a placeholder)
+     * @return std::vector<Hash> Siblings from leaves to root
+     */
+    inline std::vector<Hash> tree_branch(const std::vector<Hash> &hashes)
+    {
+        size_t count = hashes.size();
+        std::vector<Hash> branch;
+
+        if (count <= 1)
+            return branch;
+        if (count == 2)
+            return {hashes[1]};
+
+        size_t width = 1;
+
+        while (width * 2 < count)
+            width *= 2;
+
+        // Leaves before copied are kept as they are, the rest is paired
+        size_t copied = 2 * width - count;
+        std::vector<Hash> nodes(hashes.begin(), hashes.begin() + copied);
+
+        for (size_t i = copied; i < count; i += 2)
+            nodes.push_back(fast_hash(hashes[i], hashes[i + 1]));
+        if (copied == 0)
+            branch.push_back(hashes[1]);
+
+        for (; width >= 2; width /= 2)
+        {
+            branch.push_back(nodes[1]);
+            for (size_t i = 0; i < width / 2; i++)
+                nodes[i] = fast_hash(nodes[2 * i], nodes[2 * i + 1]);
+            nodes.resize(width / 2);
+        }
+
+        return branch;
+    }
+
+    /**
+     * @brief Root of tree hash from the first leaf and its branch
+     *
+     * @author GerrFrog
+     *
+     * @param leaf First leaf
+     * @param branch Siblings of tree_branch
+     * @return Hash
+     */
+    inline Hash tree_root(const Hash &leaf, const std::vector<Hash> &branch)
+    {
+        Hash node = leaf;
+
+        for (auto &sibling : branch)
+            node = fast_hash(node, sibling);
+
+        return node;
+    }
+}
+
+/**
+ * @brief Monero block format
+ *
+ * @author GerrFrog
+ */
+namespace Monero
+{
+    /**
+     * @brief Block template of daemon (get_block_template) with local
+     * extranonce rolling. Every extranonce changes the miner transaction,
+     * its hash and the tree hash; only the path of the miner transaction
+     * is hashed again, other transactions are hashed once per template
+     *
+     * @author GerrFrog
+     */
+    class Block_Template
+    {
+        private:
+            /**
+             * @brief Block template blob
+             *
+             * @author GerrFrog
+             */
+            binary blob;
+
+            /**
+             * @brief Size of block header (ends after nonce)
+             *
+             * @author GerrFrog
+             */
+            size_t header_size;
+
+            /**
+             * @brief Offset of miner transaction
+             *
+             * @author GerrFrog
+             */
+            size_t miner_tx_offset;
+
+            /**
+             * @brief Size of miner transaction prefix
+             *
+             * @author GerrFrog
+             */
+            size_t prefix_size;
+
+            /**
+             * @brief Version of miner transaction
+             *
+             * @author GerrFrog
+             */
+            uint64_t tx_version;
+
+            /**
+             * @brief Size of miner transaction (prefix and RingCT base)
+             *
+             * @author GerrFrog
+             */
+            size_t miner_tx_size;
+
+            /**
+             * @brief Offset of reserved space in blob
+             *
+             * @author GerrFrog
+             */
+            size_t reserved_offset;
+
+            /**
+             * @brief Bytes of extranonce in reserved space
+             *
+             * @author GerrFrog
+             */
+            size_t extranonce_size;
+
+            /**
+             * @brief Transactions of block with miner transaction
+             *
+             * @author GerrFrog
+             */
+            uint64_t tx_count;
+
+            /**
+             * @brief Siblings of miner transaction in tree hash
+             *
+             * @author GerrFrog
+             */
+            std::vector<Implementors::Hash> branch;
+
+            /**
+             * @brief Blob to hash of daemon
+             *
+             * @author GerrFrog
+             */
+            binary hashing_blob;
+
+            /**
+             * @brief Seed hash
+             *
+             * @author GerrFrog
+             */
+            binary seed_hash;
+
+            /**
+             * @brief Height
+             *
+             * @author GerrFrog
+             */
+            uint64_t height;
+
+            /**
+             * @brief Difficulty
+             *
+             * @author GerrFrog
+             */
+            uint64_t difficulty;
+
+            /**
+             * @brief Hash of previous block in HEX
+             *
+             * @author GerrFrog
+             */
+            string prev_hash;
+
+            /**
+             * @brief Write extranonce into reserved space
+             *
+             * @author GerrFrog
+             *
+             * @param blob Block blob
+             * @param extranonce Extranonce
+             */
+            void write_extranonce(binary &blob, uint64_t extranonce) const
+            {
+                std::memcpy(blob.data() + this->reserved_offset, &extranonce, this->extranonce_size);
+            }
+
+            /**
+             * @brief Hash of miner transaction
+             *
+             * @author GerrFrog
+             *
+             * @param blob Block blob
+             * @return Implementors::Hash
+             */
+            Implementors::Hash miner_tx_hash(const binary &blob) const
+            {
+                const uint8_t *tx = blob.data() + this->miner_tx_offset;
+
+                if (this->tx_version == 1)
+                    return Implementors::fast_hash(tx, this->miner_tx_size);
+
+                // Prefix, RingCT base (type only for coinbase) and empty prunable part
+                uint8_t parts[96] = {0};
+                Implementors::Hash prefix = Implementors::fast_hash(tx, this->prefix_size);
+                Implementors::Hash base = Implementors::fast_hash(tx + this->prefix_size, this->miner_tx_size - this->prefix_size);
+
+                std::memcpy(parts, prefix.data(), 32);
+                std::memcpy(parts + 32, base.data(), 32);
+
+                return Implementors::fast_hash(parts, sizeof(parts));
+            }
+
+        public:
+            /**
+             * @brief Construct a new Block_Template object
+             *
+             * @author GerrFrog
+             *
+             * @param result Result of get_block_template
+             * @param reserve_size Reserved size requested from daemon
+             */
+            Block_Template(
+                const nlohmann::json &result,
+                size_t reserve_size
+            ) : blob(Utilities::HEX_String(result.at("blocktemplate_blob").get<string>()).get_decoded()),
+                reserved_offset(result.at("reserved_offset").get<size_t>()),
+                extranonce_size(std::min<size_t>(reserve_size, sizeof(uint64_t))),
+                hashing_blob(Utilities::HEX_String(result.value("blockhashing_blob", string())).get_decoded()),
+                seed_hash(Utilities::HEX_String(result.value("seed_hash", string())).get_decoded()),
+                height(result.at("height").get<uint64_t>()),
+                difficulty(result.at("difficulty").get<uint64_t>()),
+                prev_hash(result.value("prev_hash", string()))
+            {
+                size_t offset = 0;
+
+                // Header: major, minor, timestamp, previous block, nonce
+                Implementors::read_varint(this->blob, offset);
+                Implementors::read_varint(this->blob, offset);
+                Implementors::read_varint(this->blob, offset);
+                Implementors::skip(this->blob, offset, 32 + sizeof(uint32_t));
+                this->header_size = offset;
+
+                // Miner transaction prefix
+                this->miner_tx_offset = offset;
+                this->tx_version = Implementors::read_varint(this->blob, offset);
+                Implementors::read_varint(this->blob, offset);
+
+                uint64_t inputs = Implementors::read_varint(this->blob, offset);
+
+                for (uint64_t i = 0; i < inputs; i++)
+                {
+                    Implementors::skip(this->blob, offset, 1);
+                    if (this->blob[offset - 1] != 0xFF)
+                        throw Exceptions::Monero::Template_Error("Miner transaction has non-coinbase input");
+                    Implementors::read_varint(this->blob, offset);
+                }
+
+                uint64_t outputs = Implementors::read_varint(this->blob, offset);
+
+                for (uint64_t i = 0; i < outputs; i++)
+                {
+                    Implementors::read_varint(this->blob, offset);
+                    Implementors::skip(this->blob, offset, 1);
+
+                    uint8_t type = this->blob[offset - 1];
+
+                    // txout_to_key or txout_to_tagged_key (with view tag)
+                    if (type == 0x02)
+                        Implementors::skip(this->blob, offset, 32);
+                    else if (type == 0x03)
+                        Implementors::skip(this->blob, offset, 33);
+                    else
+                        throw Exceptions::Monero::Template_Error("Unknown output type of miner transaction");
+                }
+
+                uint64_t extra_size = Implementors::read_varint(this->blob, offset);
+                size_t extra_offset = offset;
+
+                Implementors::skip(this->blob, offset, extra_size);
+                this->prefix_size = offset - this->miner_tx_offset;
+
+                if (
+                    this->reserved_offset < extra_offset ||
+                    this->reserved_offset + reserve_size > offset ||
+                    this->extranonce_size == 0
+                )
+                    throw Exceptions::Monero::Template_Error("Reserved space is not in miner transaction extra");
+
+                // RingCT type of coinbase (null), nothing else follows
+                if (this->tx_version >= 2)
+                {
+                    Implementors::skip(this->blob, offset, 1);
+                    if (this->blob[offset - 1] != 0)
+                        throw Exceptions::Monero::Template_Error("Miner transaction has RingCT signatures");
+                }
+                this->miner_tx_size = offset - this->miner_tx_offset;
+
+                // Hashes of other transactions
+                std::vector<Implementors::Hash> hashes(1);
+
+                this->tx_count = Implementors::read_varint(this->blob, offset) + 1;
+                for (uint64_t i = 1; i < this->tx_count; i++)
+                {
+                    Implementors::Hash hash;
+
+                    Implementors::skip(this->blob, offset, 32);
+                    std::memcpy(hash.data(), this->blob.data() + offset - 32, 32);
+                    hashes.push_back(hash);
+                }
+
+                this->branch = Implementors::tree_branch(hashes);
+            }
+
+            /**
+             * @brief Destroy the Block_Template object
+             *
+             * @author GerrFrog
+             */
+            ~Block_Template() = default;
+
+            /**
+             * @brief Build hashing blob for extranonce
+             *
+             * @author GerrFrog
+             *
+             * @param extranonce Extranonce
+             * @return binary Header, tree hash and number of transactions
+             */
+            binary get_hashing_blob(uint64_t extranonce) const
+            {
+                binary block = this->blob;
+
+                this->write_extranonce(block, extranonce);
+
+                Implementors::Hash root = Implementors::tree_root(this->miner_tx_hash(block), this->branch);
+                binary hashing(block.begin(), block.begin() + this->header_size);
+
+                hashing.insert(hashing.end(), root.begin(), root.end());
+                Implementors::write_varint(hashing, this->tx_count);
+
+                return hashing;
+            }
+
+            /**
+             * @brief Build block for submitting
+             *
+             * @author GerrFrog
+             *
+             * @param extranonce Extranonce
+             * @param nonce Nonce (4 bytes as in hashing blob)
+             * @return binary Block blob
+             */
+            binary get_block(uint64_t extranonce, const binary &nonce) const
+            {
+                binary block = this->blob;
+
+                this->write_extranonce(block, extranonce);
+                std::memcpy(
+                    block.data() + this->header_size - sizeof(uint32_t),
+                    nonce.data(),
+                    std::min(nonce.size(), sizeof(uint32_t))
+                );
+
+                return block;
+            }
+
+            /**
+             * @brief Check that local hashing blob of unchanged template
+             * equals hashing blob of daemon
+             *
+             * @author GerrFrog
+             *
+             * @return bool
+             */
+            bool is_consistent() const
+            {
+                binary reserved(
+                    this->blob.begin() + this->reserved_offset,
+                    this->blob.begin() + this->reserved_offset + this->extranonce_size
+                );
+                uint64_t extranonce = 0;
+
+                std::memcpy(&extranonce, reserved.data(), reserved.size());
+
+                return this->hashing_blob.empty() || this->get_hashing_blob(extranonce) == this->hashing_blob;
+            }
+
+            /**
+             * @brief Check hash against difficulty (hash * difficulty
+             * fits in 256 bits)
+             *
+             * @author GerrFrog
+             *
+             * @param hash Hash (32 bytes)
+             * @param difficulty Difficulty
+             * @return bool
+             */
+            static bool check_hash(const binary &hash, uint64_t difficulty)
+            {
+                uint64_t words[4];
+                unsigned __int128 carry = 0;
+
+                if (hash.size() != sizeof(words))
+                    return false;
+
+                std::memcpy(words, hash.data(), sizeof(words));
+                for (uint64_t word : words)
+                    carry = (unsigned __int128)word * difficulty + (uint64_t)(carry >> 64);
+
+                return (carry >> 64) == 0;
+            }
+
+            /**
+             * @brief Get the seed hash
+             *
+             * @author GerrFrog
+             *
+             * @return const binary&
+             */
+            const binary &get_seed_hash() const { return this->seed_hash; }
+
+            /**
+             * @brief Get the height
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_height() const { return this->height; }
+
+            /**
+             * @brief Get the difficulty
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_difficulty() const { return this->difficulty; }
+
+            /**
+             * @brief Get hash of previous block in HEX
+             *
+             * @author GerrFrog
+             *
+             * @return const string&
+             */
+            const string &get_prev_hash() const { return this->prev_hash; }
+
+            /**
+             * @brief Get number of transactions with miner transaction
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_tx_count() const { return this->tx_count; }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
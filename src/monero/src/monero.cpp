@@ -0,0 +1 @@
+#include "../inc/monero.hpp"
\ No newline at end of file
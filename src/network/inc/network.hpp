@@ -0,0 +1,150 @@
+#pragma once
+
+#ifndef NETWORK_HEADER
+#define NETWORK_HEADER
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+#include "../../requests/inc/requests.hpp"
+#include "../../solvers/inc/solvers.hpp"
+#include "../../logger/inc/logger.hpp"
+
+using std::string;
+
+/**
+ * @brief Network runtime of application
+ *
+ * @author GerrFrog
+ */
+namespace Network
+{
+    /**
+     * @brief One io_context for all connections (pools, daemon, HTTP
+     * API) run by a few dedicated threads, optionally pinned to network
+     * CPUs, so network work never runs on hashing cores. Connections
+     * serialize their handlers with strands, so a connection costs a
+     * handler rather than a thread
+     *
+     * @author GerrFrog
+     */
+    class Runtime
+    {
+        private:
+            /**
+             * @brief Input/Output context
+             *
+             * @author GerrFrog
+             */
+            net::io_context io_context;
+
+            /**
+             * @brief Keeps io_context running without work
+             *
+             * @author GerrFrog
+             */
+            net::executor_work_guard<net::io_context::executor_type> working;
+
+            /**
+             * @brief Network threads
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::thread> threads;
+
+            /**
+             * @brief Mutex for stopping
+             *
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+        public:
+            /**
+             * @brief Construct a new Runtime object
+             *
+             * @author GerrFrog
+             *
+             * @param threads Number of network threads
+             * @param cpus Network CPUs (empty to not pin)
+             */
+            Runtime(
+                size_t threads = 1,
+                const std::vector<unsigned> &cpus = {}
+            ) : io_context((int)std::max<size_t>(threads, 1)),
+                working(net::make_work_guard(io_context))
+            {
+                for (size_t i = 0; i < std::max<size_t>(threads, 1); i++)
+                    this->threads.emplace_back([this, i, cpus]() {
+                        if (!cpus.empty() && !Solvers::Implementors::set_thread_affinity(cpus))
+                            Logger::warning("network thread {}: cannot pin to cpu {}", i, cpus[0]);
+
+                        this->io_context.run();
+                    });
+            }
+
+            /**
+             * @brief Destroy the Runtime object
+             *
+             * @author GerrFrog
+             */
+            ~Runtime()
+            {
+                this->stop();
+            }
+
+            /**
+             * @brief Stop handlers and join network threads. Connections
+             * on the runtime must not be destroyed before
+             *
+             * @author GerrFrog
+             */
+            void stop()
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                this->working.reset();
+                this->io_context.stop();
+
+                for (auto &thread : this->threads)
+                {
+                    if (!thread.joinable())
+                        continue;
+                    if (thread.get_id() == std::this_thread::get_id())
+                        thread.detach();
+                    else
+                        thread.join();
+                }
+            }
+
+            /**
+             * @brief Get the io_context
+             *
+             * @author GerrFrog
+             *
+             * @return net::io_context&
+             */
+            net::io_context &get_context() { return this->io_context; }
+
+            /**
+             * @brief Get number of network threads
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_threads() const { return this->threads.size(); }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
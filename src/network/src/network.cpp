@@ -0,0 +1 @@
+#include "../inc/network.hpp"
\ No newline at end of file
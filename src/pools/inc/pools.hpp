@@ -6,10 +6,25 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <map>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <array>
+#include <cstring>
+#include <string_view>
 
 #include "../../exceptions/inc/exceptions.hpp"
 #include "../../requests/inc/requests.hpp"
 #include "../../utilities/inc/utilities.hpp"
+#include "../../solvers/inc/solvers.hpp"
+#include "../../statistics/inc/statistics.hpp"
+#include "../../logger/inc/logger.hpp"
+#include "../../monero/inc/monero.hpp"
 
 using std::cout;
 using std::endl;
@@ -23,6 +38,56 @@ using std::string;
  */
 namespace Pools::Implementors
 {
+    /**
+     * @brief Failover endpoints of pool configuration
+     * 
+     * @author GerrFrog
+     * 
+     * @param config Pool configuration ("failover": [{"host", "port"}])
+     * @return vector<std::pair<string, string>> Endpoints (host, port)
+     */
+    inline vector<std::pair<string, string>> failover_endpoints(const nlohmann::json &config)
+    {
+        vector<std::pair<string, string>> endpoints;
+
+        for (auto &endpoint : config.value("failover", nlohmann::json::array()))
+            endpoints.emplace_back(
+                endpoint.at("host").get<string>(),
+                endpoint.at("port").get<string>()
+            );
+
+        return endpoints;
+    }
+
+    /**
+     * @brief Submit waiting for response
+     * 
+     * @author GerrFrog
+     */
+    struct Pending_Submit
+    {
+        /**
+         * @brief Time when submit was queued for writing
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point sent;
+
+        /**
+         * @brief Time when submit was written to socket
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point written;
+
+        /**
+         * @brief Time when share was found
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point found;
+    };
+
     /**
      * @brief Connector with Stratum protocol using JSON method
      * 
@@ -34,23 +99,302 @@ namespace Pools::Implementors
      */
     class Stratum_Socket
     {
+        protected:
+            /**
+             * @brief Strand of connection on shared io_context, all 
+             * handlers and timers of connection run on it (declared 
+             * first, members below are constructed on it)
+             * 
+             * @author GerrFrog
+             */
+            net::strand<net::io_context::executor_type> strand;
+
         private:
+            /**
+             * @brief Messages queued for writing
+             * 
+             * @author GerrFrog
+             */
+            string pending;
+
+            /**
+             * @brief Messages being written (swapped with pending, so
+             * buffers are reused and no handler is allocated per message)
+             * 
+             * @author GerrFrog
+             */
+            string writing;
+
+            /**
+             * @brief Wakes up the writer when a message is queued
+             * 
+             * @author GerrFrog
+             */
+            net::steady_timer write_signal;
+
+            /**
+             * @brief Deadline of connecting or of next server message
+             * 
+             * @author GerrFrog
+             */
+            net::steady_timer deadline;
+
+            /**
+             * @brief Number of connection, handlers of old connection
+             * stop when it changes
+             * 
+             * @author GerrFrog
+             */
+            uint64_t generation = 0;
+
+            /**
+             * @brief Index of current endpoint
+             * 
+             * @author GerrFrog
+             */
+            size_t endpoint = 0;
+
+            /**
+             * @brief Session is stopped
+             * 
+             * @author GerrFrog
+             */
+            bool stopped = false;
+
+            /**
+             * @brief Connection was closed by watchdog
+             * 
+             * @author GerrFrog
+             */
+            bool timed_out = false;
+
+            /**
+             * @brief Maximal size of server message
+             * 
+             * @author GerrFrog
+             */
+            static constexpr size_t max_message = 1 << 20;
+
+            /**
+             * @brief Close socket when deadline passes
+             * 
+             * @author GerrFrog
+             * 
+             * @param connection Generation of connection
+             */
+            net::awaitable<void> watchdog(uint64_t connection)
+            {
+                boost::system::error_code err;
+
+                while (connection == this->generation)
+                {
+                    co_await this->deadline.async_wait(net::redirect_error(net::use_awaitable, err));
+
+                    if (connection == this->generation && this->deadline.expiry() <= std::chrono::steady_clock::now())
+                    {
+                        this->timed_out = true;
+                        this->socket.close(err);
+                        co_return;
+                    }
+                }
+            }
+
+            /**
+             * @brief Write queued messages until connection is closed
+             * 
+             * @author GerrFrog
+             * 
+             * @param connection Generation of connection
+             */
+            net::awaitable<void> writer(uint64_t connection)
+            {
+                boost::system::error_code err;
+
+                while (connection == this->generation)
+                {
+                    if (this->pending.empty())
+                    {
+                        co_await this->write_signal.async_wait(net::redirect_error(net::use_awaitable, err));
+                        continue;
+                    }
+
+                    this->writing.swap(this->pending);
+                    co_await net::async_write(this->socket, net::buffer(this->writing), net::redirect_error(net::use_awaitable, err));
+                    this->writing.clear();
+
+                    if (err || connection != this->generation)
+                        co_return;
+                    this->handle_written();
+                }
+            }
 
-        protected:
             /**
-             * @brief Input/Output Service
+             * @brief Handle server message, malformed message drops the
+             * connection instead of the whole session
              * 
              * @author GerrFrog
+             * 
+             * @param message Line without '\n' or whole binary frame
+             */
+            void dispatch(std::string_view message)
+            {
+                try {
+                    this->handle_server_msg(message);
+                } catch (std::exception &exp) {
+                    Logger::error("pool {}:{}: {}", this->server, this->port, exp.what());
+                    this->failover();
+                }
+            }
+
+            /**
+             * @brief Read lines until connection is closed
+             * 
+             * @author GerrFrog
+             * 
+             * @return boost::system::error_code Reason of disconnection
+             */
+            net::awaitable<boost::system::error_code> reader()
+            {
+                boost::system::error_code err;
+
+                while (true)
+                {
+                    this->deadline.expires_after(this->timeout);
+
+                    if (this->binary_framing)
+                    {
+                        size_t size = co_await this->read_frame(err);
+
+                        if (err)
+                            co_return err;
+
+                        this->dispatch(std::string_view(this->read_buffer.data(), size));
+                        this->read_buffer.erase(0, size);
+                        continue;
+                    }
+
+                    size_t size = co_await net::async_read_until(
+                        this->socket,
+                        net::dynamic_buffer(this->read_buffer, max_message),
+                        '\n',
+                        net::redirect_error(net::use_awaitable, err)
+                    );
+
+                    if (err)
+                        co_return err;
+
+                    // Line without '\n', the rest is kept for next message
+                    if (size > 1)
+                        this->dispatch(std::string_view(this->read_buffer.data(), size - 1));
+                    this->read_buffer.erase(0, size);
+                }
+            }
+
+            /**
+             * @brief Read binary frame (6 bytes header with 24 bit 
+             * length of payload, then payload) into read buffer. Bytes
+             * after the frame are kept for next message
+             * 
+             * @author GerrFrog
+             * 
+             * @param err Error code
+             * @return net::awaitable<size_t> Size of frame with header
              */
-            net::io_service io_service;
+            net::awaitable<size_t> read_frame(boost::system::error_code &err)
+            {
+                size_t size = 6;
+
+                for (int part = 0; part < 2; part++)
+                {
+                    if (this->read_buffer.size() < size)
+                        co_await net::async_read(
+                            this->socket,
+                            net::dynamic_buffer(this->read_buffer, max_message),
+                            net::transfer_at_least(size - this->read_buffer.size()),
+                            net::redirect_error(net::use_awaitable, err)
+                        );
+
+                    if (err)
+                        co_return 0;
+
+                    if (part == 0)
+                        size += 
+                            (size_t)(uint8_t)this->read_buffer[3] |
+                            (size_t)(uint8_t)this->read_buffer[4] << 8 |
+                            (size_t)(uint8_t)this->read_buffer[5] << 16;
+
+                    if (size > max_message)
+                    {
+                        err = net::error::message_size;
+                        co_return 0;
+                    }
+                }
+
+                co_return size;
+            }
 
             /**
-             * @brief Working thread
+             * @brief Connect, run reader and writer, and connect again
+             * after delay (to next endpoint) until stopped
              * 
              * @author GerrFrog
              */
-            net::io_service::work working;
+            net::awaitable<void> session()
+            {
+                boost::system::error_code err;
+
+                while (!this->stopped)
+                {
+                    uint64_t connection = ++this->generation;
+                    boost::system::error_code ignored;
+
+                    this->server = this->endpoints[this->endpoint].first;
+                    this->port = this->endpoints[this->endpoint].second;
+                    this->read_buffer.clear();
+                    this->pending.clear();
+                    this->timed_out = false;
+
+                    this->deadline.expires_after(this->timeout);
+                    net::co_spawn(this->strand, this->watchdog(connection), net::detached);
+
+                    auto endpoints = co_await this->resolver.async_resolve(
+                        this->server,
+                        this->port,
+                        net::redirect_error(net::use_awaitable, err)
+                    );
+
+                    if (!err)
+                        co_await net::async_connect(this->socket, endpoints, net::redirect_error(net::use_awaitable, err));
 
+                    if (!err)
+                    {
+                        this->socket.set_option(tcp::no_delay(true), ignored);
+                        this->handle_connect();
+                        net::co_spawn(this->strand, this->writer(connection), net::detached);
+                        err = co_await this->reader();
+                    }
+
+                    if (this->timed_out)
+                        err = net::error::timed_out;
+
+                    // Handlers of this connection stop on the new generation
+                    this->generation++;
+                    this->socket.close(ignored);
+                    this->deadline.cancel();
+                    this->write_signal.cancel();
+
+                    if (this->stopped)
+                        break;
+
+                    this->handle_disconnect(err);
+                    this->endpoint = (this->endpoint + 1) % this->endpoints.size();
+
+                    this->reconnect_timer.expires_after(std::chrono::seconds(5));
+                    co_await this->reconnect_timer.async_wait(net::redirect_error(net::use_awaitable, ignored));
+                }
+            }
+
+        protected:
             /**
              * @brief Resolver for host
              * 
@@ -66,11 +410,19 @@ namespace Pools::Implementors
             tcp::socket socket;
 
             /**
-             * @brief Buffer for reading from server
+             * @brief Timer for reconnection
+             * 
+             * @author GerrFrog
+             */
+            net::steady_timer reconnect_timer;
+
+            /**
+             * @brief Buffer for reading from server (partial line is 
+             * kept until the rest arrives)
              * 
              * @author GerrFrog
              */
-            std::array<char, 65536> read_buffer;
+            string read_buffer;
 
             /**
              * @brief Subscribe message
@@ -91,19 +443,34 @@ namespace Pools::Implementors
             };
 
             /**
-             * @brief Server (host)
+             * @brief Endpoints (host, port), the next one is used after
+             * connection is lost
+             * 
+             * @author GerrFrog
+             */
+            vector<std::pair<string, string>> endpoints;
+
+            /**
+             * @brief Server (host) of current connection
              * 
              * @author GerrFrog
              */
             string server;
 
             /**
-             * @brief Port
+             * @brief Port of current connection
              * 
              * @author GerrFrog
              */
             string port;
 
+            /**
+             * @brief Timeout of connecting and of silence of server
+             * 
+             * @author GerrFrog
+             */
+            std::chrono::seconds timeout;
+
             /**
              * @brief Command ID number
              * 
@@ -111,6 +478,14 @@ namespace Pools::Implementors
              */
             int command_id = 1;
 
+            /**
+             * @brief Messages are binary frames instead of lines (set
+             * before start)
+             * 
+             * @author GerrFrog
+             */
+            bool binary_framing = false;
+
             /**
              * @brief Prepare messagge for requesting
              * 
@@ -137,122 +512,90 @@ namespace Pools::Implementors
             }
 
             /**
-             * @brief Convert streambuffer to string
+             * @brief Queue message for writing. Must be called on strand
              * 
              * @author GerrFrog
              * 
-             * @param streambuf Streambuf object
-             * @return string String value
+             * @param message Message with '\n' or binary frame
+             * @return bool Message is queued (connection is open)
              */
-            string streambuf2string(net::streambuf& streambuf)
+            bool send(std::string_view message)
             {
-                return {
-                    buffers_begin(streambuf.data()), 
-                    buffers_end(streambuf.data())
-                };
+                if (!this->socket.is_open())
+                    return false;
+
+                this->pending.append(message);
+                this->write_signal.cancel_one();
+
+                return true;
             }
 
             /**
-             * @brief Connect to pool
+             * @brief Start session on strand
              * 
              * @author GerrFrog
              */
-            void connect()
+            void start()
             {
-                tcp::resolver::query query(
-                    this->server,
-                    this->port
-                );
+                net::co_spawn(this->strand, this->session(), [this](std::exception_ptr exp) {
+                    if (!exp)
+                        return;
+
+                    try {
+                        std::rethrow_exception(exp);
+                    } catch (std::exception &err) {
+                        Logger::error("pool {}:{}: session: {}", this->server, this->port, err.what());
+                    } catch (...) {
+                        Logger::error("pool {}:{}: session failed", this->server, this->port);
+                    }
 
-                this->resolver.async_resolve(
-                    query,
-                    boost::bind(
-                        &Stratum_Socket::handle_resolve,
-                        this,
-                        net::placeholders::error,
-                        net::placeholders::iterator
-                    )
-                );
+                    boost::system::error_code ignored;
+
+                    // Session is restarted with the next connection
+                    this->generation++;
+                    this->socket.close(ignored);
+                    if (!this->stopped)
+                        this->start();
+                });
             }
 
             /**
-             * @brief Callback when resolve server
+             * @brief Callback when connection is lost
              * 
              * @author GerrFrog
              * 
              * @param err Error code
-             * @param endpoint_iterator Endpoint iterator
              */
-            void handle_resolve(
-                const boost::system::error_code &err,
-                tcp::resolver::iterator endpoint_iterator
-            ) 
+            virtual void handle_disconnect(
+                const boost::system::error_code &err
+            )
             {
-                if (!err)
-                {
-                    this->socket.async_connect(
-                        endpoint_iterator->endpoint(),
-                        boost::bind(
-                            &Stratum_Socket::handle_connect,
-                            this,
-                            net::placeholders::error
-                        )
-                    );
-                } else {
-                    // TODO: Error
-                }
+                Logger::warning("pool {}:{}: {}", this->server, this->port, err.message());
             }
 
             /**
-             * @brief Callback when written to server
+             * @brief Callback when queued messages are written
              * 
              * @author GerrFrog
-             * 
-             * @param err Error code
              */
-            void handle_write_completed(
-                const boost::system::error_code& err,
-                std::size_t bytes_transferred
-            )
-            {
-                if (!err && bytes_transferred != 0)
-                {
-                    this->socket.async_receive(
-                        net::buffer(this->read_buffer),
-                        boost::bind(
-                            &Stratum_Socket::handle_server_msg,
-                            this,
-                            net::placeholders::error,
-                            net::placeholders::bytes_transferred
-                        )
-                    );
-                } else {
-                    // TODO: Error
-                }
-            }
+            virtual void handle_written() { }
 
             /**
              * @brief Callback when read server message
              * 
              * @author GerrFrog
              * 
-             * @param err Error code
+             * @param message Line without '\n' or whole binary frame 
+             * (valid during the call)
              */
-            virtual void handle_server_msg(
-                const boost::system::error_code& err,
-                std::size_t bytes_transferred
-            ) = 0;
+            virtual void handle_server_msg(std::string_view message) = 0;
 
             /**
              * @brief Callback when connected to server
              * 
              * @author GerrFrog
-             * 
-             * @param err Error code
              */
-            virtual void handle_connect(
-                const boost::system::error_code& err
-            ) = 0;
+            virtual void handle_connect() = 0;
 
         public:
             /**
@@ -260,354 +603,1851 @@ namespace Pools::Implementors
              * 
              * @author GerrFrog
              * 
+             * @param io_context Shared io_context (must be stopped 
+             * before the socket is destroyed)
              * @param server Server
              * @param port Port
+             * @param failover Other endpoints (host, port)
+             * @param timeout Timeout of connecting and of silence of 
+             * server
              */
             Stratum_Socket(
+                net::io_context &io_context,
                 const string &server,
-                const string &port
-            ) : working(io_service),
-                resolver(io_service),
-                socket(io_service),
+                const string &port,
+                const vector<std::pair<string, string>> &failover = {},
+                std::chrono::seconds timeout = std::chrono::seconds(300)
+            ) : strand(net::make_strand(io_context)),
+                write_signal(strand, std::chrono::steady_clock::time_point::max()),
+                deadline(strand),
+                resolver(strand),
+                socket(strand),
+                reconnect_timer(strand),
+                endpoints({{server, port}}),
                 server(server),
-                port(port)
-            { }
+                port(port),
+                timeout(timeout)
+            {
+                this->endpoints.insert(this->endpoints.end(), failover.begin(), failover.end());
+            }
 
             /**
              * @brief Destroy the Stratum_Socket object
              * 
              * @author GerrFrog
              */
-            ~Stratum_Socket()
+            virtual ~Stratum_Socket() = default;
+
+            /**
+             * @brief Drop current connection and continue with next
+             * endpoint. Pending reads, writes and timers are cancelled
+             * 
+             * @author GerrFrog
+             */
+            void failover()
+            {
+                net::post(this->strand, [this]() {
+                    boost::system::error_code ignored;
+
+                    this->socket.close(ignored);
+                    this->reconnect_timer.cancel();
+                });
+            }
+
+            /**
+             * @brief Stop session
+             * 
+             * @author GerrFrog
+             */
+            void stop()
             {
-                this->io_service.stop();
+                net::post(this->strand, [this]() {
+                    boost::system::error_code ignored;
+
+                    this->stopped = true;
+                    this->socket.close(ignored);
+                    this->reconnect_timer.cancel();
+                    this->write_signal.cancel();
+                    this->deadline.cancel();
+                });
             }
     };
 }
 
 /**
- * @brief Parsers for Stratum V1 messages (specific type)
+ * @brief Binary framing and messages of Stratum V2 mining protocol
+ * (plain connection, without Noise encryption)
+ * 
+ * @note https://github.com/stratum-mining/sv2-spec
  * 
  * @author GerrFrog
  */
-namespace Pools::Implementors::Parsers
+namespace Pools::Implementors::Stratum_V2
 {
     /**
-     * @brief Parser for XMR pools
+     * @brief Size of frame header (extension_type U16, msg_type U8,
+     * msg_length U24)
      * 
      * @author GerrFrog
      */
-    class Parser_V1
+    constexpr size_t header_size = 6;
+
+    /**
+     * @brief Bit of extension_type for messages of channel
+     * 
+     * @author GerrFrog
+     */
+    constexpr uint16_t channel_bit = 0x8000;
+
+    /**
+     * @brief Extension with seed hash of RandomX (mining protocol has 
+     * no field for it)
+     * 
+     * @author GerrFrog
+     */
+    constexpr uint16_t randomx_extension = 0x4000;
+
+    /**
+     * @brief Message types of mining protocol
+     * 
+     * @author GerrFrog
+     */
+    enum Message : uint8_t
     {
-        // TODO: Implement
-        private:
+        Setup_Connection = 0x00,
+        Setup_Connection_Success = 0x01,
+        Setup_Connection_Error = 0x02,
+        Open_Standard_Mining_Channel = 0x10,
+        Open_Standard_Mining_Channel_Success = 0x11,
+        Open_Mining_Channel_Error = 0x12,
+        New_Mining_Job = 0x15,
+        Submit_Shares_Standard = 0x1a,
+        Submit_Shares_Success = 0x1c,
+        Submit_Shares_Error = 0x1d,
+        Set_New_Prev_Hash = 0x20,
+        Set_Target = 0x21
+    };
 
-        protected:
+    /**
+     * @brief Message type of RandomX extension: SetSeedHash 
+     * (channel_id U32, seed_hash U256)
+     * 
+     * @author GerrFrog
+     */
+    constexpr uint8_t set_seed_hash = 0x00;
+
+    /**
+     * @brief Encoder of frames into fixed buffer, which is reused for 
+     * every message
+     * 
+     * @author GerrFrog
+     */
+    class Writer
+    {
         private:
             /**
-             * @brief Response ID when login to pool
+             * @brief Frame buffer
              * 
              * @author GerrFrog
              */
-            string rpc_id;
+            std::array<char, 1024> buffer;
 
             /**
-             * @brief Login status
+             * @brief Size of frame
              * 
              * @author GerrFrog
              */
-            bool status = false;
+            size_t size = 0;
+
+            /**
+             * @brief Reserve bytes at the end of frame
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of bytes
+             * @return char* Reserved bytes
+             */
+            char *reserve(size_t count)
+            {
+                if (count > this->buffer.size() - this->size)
+                    throw Exceptions::Pools::Protocol_Error("stratum v2: message is too long");
+
+                char *data = this->buffer.data() + this->size;
+
+                this->size += count;
+
+                return data;
+            }
+
+            /**
+             * @brief Write little endian integer
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             * @param count Number of bytes
+             * @return Writer& 
+             */
+            Writer &integer(uint64_t value, size_t count)
+            {
+                char *data = this->reserve(count);
+
+                for (size_t i = 0; i < count; i++)
+                    data[i] = (char)(value >> (8 * i));
+
+                return *this;
+            }
+
+        public:
+            /**
+             * @brief Start frame (length is written by end)
+             * 
+             * @author GerrFrog
+             * 
+             * @param extension Extension type (with channel bit)
+             * @param type Message type
+             * @return Writer& 
+             */
+            Writer &begin(uint16_t extension, uint8_t type)
+            {
+                this->size = 0;
+
+                return this->u16(extension).u8(type).integer(0, 3);
+            }
+
+            /**
+             * @brief Finish frame
+             * 
+             * @author GerrFrog
+             * 
+             * @return std::string_view Frame (valid until next begin)
+             */
+            std::string_view end()
+            {
+                size_t length = this->size - header_size;
+
+                for (size_t i = 0; i < 3; i++)
+                    this->buffer[3 + i] = (char)(length >> (8 * i));
+
+                return std::string_view(this->buffer.data(), this->size);
+            }
+
+            /**
+             * @brief Write U8, U16 or U32
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             * @return Writer& 
+             */
+            Writer &u8(uint8_t value) { return this->integer(value, 1); }
+            Writer &u16(uint16_t value) { return this->integer(value, 2); }
+            Writer &u32(uint32_t value) { return this->integer(value, 4); }
+
+            /**
+             * @brief Write F32
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             * @return Writer& 
+             */
+            Writer &f32(float value)
+            {
+                uint32_t bits;
+
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                return this->u32(bits);
+            }
+
+            /**
+             * @brief Write U256 (little endian bytes)
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             * @return Writer& 
+             */
+            Writer &u256(const std::array<unsigned char, 32> &value)
+            {
+                std::memcpy(this->reserve(value.size()), value.data(), value.size());
+
+                return *this;
+            }
+
+            /**
+             * @brief Write STR0_255 or B0_255 (length byte, then bytes)
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value (at most 255 bytes)
+             * @return Writer& 
+             */
+            Writer &str(std::string_view value)
+            {
+                if (value.size() > 255)
+                    throw Exceptions::Pools::Protocol_Error("stratum v2: string is too long");
+
+                this->u8((uint8_t)value.size());
+                std::memcpy(this->reserve(value.size()), value.data(), value.size());
+
+                return *this;
+            }
+    };
+
+    /**
+     * @brief Decoder of fields of frame. Strings are views into frame,
+     * nothing is copied
+     * 
+     * @author GerrFrog
+     */
+    class Reader
+    {
+        private:
+            /**
+             * @brief Payload of frame
+             * 
+             * @author GerrFrog
+             */
+            std::string_view payload;
+
+            /**
+             * @brief Offset of next field
+             * 
+             * @author GerrFrog
+             */
+            size_t offset = 0;
+
+            /**
+             * @brief Take bytes of next field
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of bytes
+             * @return const unsigned char* Bytes
+             */
+            const unsigned char *take(size_t count)
+            {
+                if (count > this->payload.size() - this->offset)
+                    throw Exceptions::Pools::Protocol_Error("stratum v2: message is truncated");
+
+                const unsigned char *data = (const unsigned char *)this->payload.data() + this->offset;
+
+                this->offset += count;
+
+                return data;
+            }
+
+            /**
+             * @brief Read little endian integer
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of bytes
+             * @return uint64_t 
+             */
+            uint64_t integer(size_t count)
+            {
+                const unsigned char *data = this->take(count);
+                uint64_t value = 0;
+
+                for (size_t i = 0; i < count; i++)
+                    value |= (uint64_t)data[i] << (8 * i);
+
+                return value;
+            }
+
+        public:
+            /**
+             * @brief Extension type (without channel bit)
+             * 
+             * @author GerrFrog
+             */
+            uint16_t extension = 0;
+
+            /**
+             * @brief Message type
+             * 
+             * @author GerrFrog
+             */
+            uint8_t type = 0;
+
+            /**
+             * @brief Construct a new Reader object
+             * 
+             * @author GerrFrog
+             * 
+             * @param frame Frame with header
+             */
+            explicit Reader(std::string_view frame)
+            {
+                if (frame.size() < header_size)
+                    throw Exceptions::Pools::Protocol_Error("stratum v2: frame is truncated");
+
+                this->payload = frame;
+                this->extension = (uint16_t)this->integer(2) & ~channel_bit;
+                this->type = (uint8_t)this->integer(1);
+
+                if (this->integer(3) != frame.size() - header_size)
+                    throw Exceptions::Pools::Protocol_Error("stratum v2: wrong frame length");
+            }
+
+            /**
+             * @brief Read U8, U16, U32 or U64
+             * 
+             * @author GerrFrog
+             * 
+             * @return Value
+             */
+            uint8_t u8() { return (uint8_t)this->integer(1); }
+            uint16_t u16() { return (uint16_t)this->integer(2); }
+            uint32_t u32() { return (uint32_t)this->integer(4); }
+            uint64_t u64() { return this->integer(8); }
+
+            /**
+             * @brief Read U256 (little endian bytes)
+             * 
+             * @author GerrFrog
+             * 
+             * @param value Value
+             */
+            void u256(std::array<unsigned char, 32> &value)
+            {
+                std::memcpy(value.data(), this->take(value.size()), value.size());
+            }
+
+            /**
+             * @brief Read STR0_255, B0_32 or B0_255 (length byte, then 
+             * bytes)
+             * 
+             * @author GerrFrog
+             * 
+             * @return std::string_view View into frame
+             */
+            std::string_view str()
+            {
+                size_t size = this->u8();
+
+                return std::string_view((const char *)this->take(size), size);
+            }
+    };
+}
+
+/**
+ * @brief Parsers for Stratum V1 and V2 messages (specific type)
+ * 
+ * @author GerrFrog
+ */
+namespace Pools::Implementors::Parsers
+{
+    /**
+     * @brief Parser for XMR pools
+     * 
+     * @author GerrFrog
+     */
+    class Parser_V1
+    {
+        // TODO: Implement
+        private:
+
+        protected:
+            /**
+             * @brief Response ID when login to pool
+             * 
+             * @author GerrFrog
+             */
+            string rpc_id;
+
+            /**
+             * @brief Login status
+             * 
+             * @author GerrFrog
+             */
+            bool status = false;
+
+        public:
+            /**
+             * @brief Construct a new xmr parser object
+             * 
+             * @author GerrFrog
+             */
+            Parser_V1() = default;
+
+            /**
+             * @brief Destroy the xmr parser object
+             * 
+             * @author GerrFrog
+             */
+            ~Parser_V1() = default;
+
+            /**
+             * @brief Check if server message contains a job (login 
+             * response or job notification)
+             * 
+             * @author GerrFrog
+             * 
+             * @param json_message Server message
+             * @return bool
+             */
+            bool is_job(const nlohmann::json &json_message)
+            {
+                if (json_message.contains("params"))
+                    return 
+                        json_message.value("method", "") == "job" &&
+                        json_message["params"].is_object();
+
+                return 
+                    json_message.contains("result") &&
+                    json_message["result"].is_object() &&
+                    json_message["result"].contains("job");
+            }
+
+            /**
+             * @brief Parse server message
+             * 
+             * @author GerrFrog
+             * 
+             * @param message Server message
+             */
+            Utilities::Pools::New_Job_V1 parse(string &message)
+            {
+                nlohmann::json json_message = nlohmann::json::parse(message);
+                nlohmann::json params;
+
+                Utilities::Pools::New_Job_V1 new_job;
+
+                if (!json_message.contains("params"))
+                {
+                    if ((string)json_message["result"]["status"] == "OK")
+                        this->status = true;
+                    if (json_message["result"].contains("id"))
+                    {
+                        this->rpc_id = (string)json_message["result"]["id"];
+                        params = json_message["result"]["job"];
+                    } else {
+                    }
+                } else {
+                    params = json_message["params"];
+                }
+
+                string blob = params["blob"];
+                string seed_hash = params["seed_hash"];
+
+                new_job.height = params["height"];
+                new_job.blob = Utilities::HEX_String(blob);
+                new_job.job_id = params["job_id"];
+                new_job.target = params["target"];
+                new_job.seed_hash = Utilities::HEX_String(seed_hash);
+
+                return new_job;
+            }
+    };
+
+    /**
+     * @brief Parser for Stratum V2 messages (standard channel). Job of
+     * RandomX is mapped to header fields: prev_hash of SetNewPrevHash 
+     * is previous block ID, ntime is timestamp, merkle_root is tree 
+     * hash of transactions, version has major (bits 0-7) and minor 
+     * (bits 8-15) version of block and number of transactions (bits 
+     * 16-31). Seed hash comes with SetSeedHash of RandomX extension
+     * 
+     * @author GerrFrog
+     */
+    class Parser_V2
+    {
+        private:
+            /**
+             * @brief Maximal number of kept jobs (for submits)
+             * 
+             * @author GerrFrog
+             */
+            static constexpr size_t max_jobs = 16;
+
+            /**
+             * @brief Build job for solver (hashing blob of RandomX)
+             * 
+             * @author GerrFrog
+             * 
+             * @param job Job of channel
+             * @param new_job Job for solver
+             */
+            void make_job(
+                const Utilities::Pools::New_Job_V2 &job,
+                Utilities::Pools::New_Job_V1 &new_job
+            )
+            {
+                binary blob;
+
+                blob.reserve(80);
+                Monero::Implementors::write_varint(blob, job.version & 0xFF);
+                Monero::Implementors::write_varint(blob, (job.version >> 8) & 0xFF);
+                Monero::Implementors::write_varint(blob, job.min_ntime);
+                blob.insert(blob.end(), this->prev_hash.begin(), this->prev_hash.end());
+                blob.insert(blob.end(), sizeof(uint32_t), 0);
+                blob.insert(blob.end(), job.merkle_root.begin(), job.merkle_root.end());
+                Monero::Implementors::write_varint(blob, job.version >> 16);
+
+                new_job.height = 0;
+                new_job.blob = Utilities::HEX_String(blob);
+                new_job.job_id = std::to_string(job.job_id);
+                // Solver compares high 64 bits of hash
+                new_job.target = Utilities::HEX_String(binary(this->target.begin() + 24, this->target.end())).get_encoded();
+                new_job.seed_hash = Utilities::HEX_String(binary(this->seed_hash.begin(), this->seed_hash.end()));
+            }
+
+            /**
+             * @brief Build job for solver of active job if channel has 
+             * everything for it
+             * 
+             * @author GerrFrog
+             * 
+             * @param new_job Job for solver
+             * @return bool Job is built
+             */
+            bool make_active_job(Utilities::Pools::New_Job_V1 &new_job)
+            {
+                auto job = this->jobs.find(this->active_job);
+
+                if (
+                    !this->channel_open || !this->has_seed_hash || !this->has_prev_hash ||
+                    job == this->jobs.end() || job->second.future
+                )
+                    return false;
+
+                this->make_job(job->second, new_job);
+
+                return true;
+            }
+
+        protected:
+            /**
+             * @brief Encoder of messages to pool
+             * 
+             * @author GerrFrog
+             */
+            Stratum_V2::Writer writer;
+
+            /**
+             * @brief Channel is opened
+             * 
+             * @author GerrFrog
+             */
+            bool channel_open = false;
+
+            /**
+             * @brief Channel ID
+             * 
+             * @author GerrFrog
+             */
+            uint32_t channel_id = 0;
+
+            /**
+             * @brief Target of channel
+             * 
+             * @author GerrFrog
+             */
+            std::array<unsigned char, 32> target{};
+
+            /**
+             * @brief Seed hash of RandomX
+             * 
+             * @author GerrFrog
+             */
+            std::array<unsigned char, 32> seed_hash{};
+
+            /**
+             * @brief Seed hash is received
+             * 
+             * @author GerrFrog
+             */
+            bool has_seed_hash = false;
+
+            /**
+             * @brief Previous block ID
+             * 
+             * @author GerrFrog
+             */
+            std::array<unsigned char, 32> prev_hash{};
+
+            /**
+             * @brief Previous block ID is received
+             * 
+             * @author GerrFrog
+             */
+            bool has_prev_hash = false;
+
+            /**
+             * @brief Jobs of channel by job ID (future and recent ones)
+             * 
+             * @author GerrFrog
+             */
+            std::map<uint32_t, Utilities::Pools::New_Job_V2> jobs;
+
+            /**
+             * @brief Job ID of active job
+             * 
+             * @author GerrFrog
+             */
+            uint32_t active_job = 0;
+
+        public:
+            /**
+             * @brief Construct a new Stratum_Parser_V2 object
+             * 
+             * @author GerrFrog
+             */
+            Parser_V2() = default;
+
+            /**
+             * @brief Destroy the Stratum_Parser_V2 object
+             * 
+             * @author GerrFrog
+             */
+            ~Parser_V2() = default;
+
+            /**
+             * @brief Forget channel (connection is lost)
+             * 
+             * @author GerrFrog
+             */
+            void reset()
+            {
+                this->channel_open = false;
+                this->has_seed_hash = false;
+                this->has_prev_hash = false;
+                this->jobs.clear();
+            }
+
+            /**
+             * @brief Encode SetupConnection
+             * 
+             * @author GerrFrog
+             * 
+             * @param host Host of pool
+             * @param port Port of pool
+             * @param device Device ID
+             * @return std::string_view Frame (valid until next message 
+             * is encoded)
+             */
+            std::string_view setup_connection(
+                std::string_view host, 
+                uint16_t port,
+                std::string_view device
+            )
+            {
+                return this->writer.begin(0, Stratum_V2::Setup_Connection)
+                    .u8(0)      // Mining protocol
+                    .u16(2)     // min_version
+                    .u16(2)     // max_version
+                    .u32(0)     // flags
+                    .str(host)
+                    .u16(port)
+                    .str("CPUMinerRandomX")
+                    .str("cpu")
+                    .str("0.1")
+                    .str(device)
+                    .end();
+            }
+
+            /**
+             * @brief Encode OpenStandardMiningChannel
+             * 
+             * @author GerrFrog
+             * 
+             * @param request_id Request ID
+             * @param user User identity (login)
+             * @param hashrate Nominal hashrate (H/s)
+             * @return std::string_view Frame
+             */
+            std::string_view open_standard_mining_channel(
+                uint32_t request_id,
+                std::string_view user,
+                float hashrate
+            )
+            {
+                std::array<unsigned char, 32> max_target;
+
+                max_target.fill(0xFF);
+
+                return this->writer.begin(0, Stratum_V2::Open_Standard_Mining_Channel)
+                    .u32(request_id)
+                    .str(user)
+                    .f32(hashrate)
+                    .u256(max_target)
+                    .end();
+            }
+
+            /**
+             * @brief Encode SubmitSharesStandard
+             * 
+             * @author GerrFrog
+             * 
+             * @param sequence Sequence number
+             * @param job_id Job ID
+             * @param nonce Nonce
+             * @return std::string_view Frame (empty if job is unknown)
+             */
+            std::string_view submit_shares_standard(
+                uint32_t sequence,
+                uint32_t job_id,
+                uint32_t nonce
+            )
+            {
+                auto job = this->jobs.find(job_id);
+
+                if (!this->channel_open || job == this->jobs.end())
+                    return std::string_view();
+
+                return this->writer.begin(Stratum_V2::channel_bit, Stratum_V2::Submit_Shares_Standard)
+                    .u32(this->channel_id)
+                    .u32(sequence)
+                    .u32(job_id)
+                    .u32(nonce)
+                    .u32(job->second.min_ntime)
+                    .u32(job->second.version)
+                    .end();
+            }
+
+            /**
+             * @brief Check if server message changes job (channel 
+             * opening, target, seed hash, job or previous block)
+             * 
+             * @author GerrFrog
+             * 
+             * @param message Frame of server
+             * @return bool
+             */
+            bool is_job(const Stratum_V2::Reader &message)
+            {
+                if (message.extension == Stratum_V2::randomx_extension)
+                    return message.type == Stratum_V2::set_seed_hash;
+
+                return 
+                    message.extension == 0 && (
+                        message.type == Stratum_V2::Open_Standard_Mining_Channel_Success ||
+                        message.type == Stratum_V2::New_Mining_Job ||
+                        message.type == Stratum_V2::Set_New_Prev_Hash ||
+                        message.type == Stratum_V2::Set_Target
+                    );
+            }
+
+            /**
+             * @brief Parse server message which changes job
+             * 
+             * @author GerrFrog
+             * 
+             * @param message Frame of server
+             * @param new_job Job for solver
+             * @return bool Solver has to switch to new job
+             */
+            bool parse(
+                Stratum_V2::Reader &message, 
+                Utilities::Pools::New_Job_V1 &new_job
+            )
+            {
+                if (message.type == Stratum_V2::Open_Standard_Mining_Channel_Success)
+                {
+                    message.u32();  // request_id
+                    this->channel_id = message.u32();
+                    message.u256(this->target);
+                    this->channel_open = true;
+
+                    return this->make_active_job(new_job);
+                }
+
+                if (message.u32() != this->channel_id)
+                    return false;
+
+                if (message.extension == Stratum_V2::randomx_extension)
+                {
+                    message.u256(this->seed_hash);
+                    this->has_seed_hash = true;
+
+                    return this->make_active_job(new_job);
+                }
+
+                switch (message.type)
+                {
+                    case Stratum_V2::New_Mining_Job:
+                    {
+                        Utilities::Pools::New_Job_V2 job;
+
+                        job.channel_id = this->channel_id;
+                        job.job_id = message.u32();
+                        job.future = message.u8() == 0;
+                        if (!job.future)
+                            job.min_ntime = message.u32();
+                        job.version = message.u32();
+
+                        std::string_view merkle_root = message.str();
+
+                        if (merkle_root.size() != job.merkle_root.size())
+                            throw Exceptions::Pools::Protocol_Error("stratum v2: wrong size of merkle root");
+                        std::memcpy(job.merkle_root.data(), merkle_root.data(), merkle_root.size());
+
+                        this->jobs[job.job_id] = job;
+                        while (this->jobs.size() > max_jobs)
+                            this->jobs.erase(this->jobs.begin());
+
+                        if (job.future)
+                            return false;
+
+                        this->active_job = job.job_id;
+
+                        return this->make_active_job(new_job);
+                    }
+
+                    case Stratum_V2::Set_New_Prev_Hash:
+                    {
+                        uint32_t job_id = message.u32();
+
+                        message.u256(this->prev_hash);
+                        this->has_prev_hash = true;
+
+                        uint32_t ntime = message.u32();
+                        auto job = this->jobs.find(job_id);
+
+                        // Jobs of previous block are stale
+                        for (auto it = this->jobs.begin(); it != this->jobs.end(); )
+                            it = it->first < job_id ? this->jobs.erase(it) : std::next(it);
+
+                        if (job == this->jobs.end())
+                            return false;
+
+                        job->second.future = false;
+                        job->second.min_ntime = ntime;
+                        this->active_job = job_id;
+
+                        return this->make_active_job(new_job);
+                    }
+
+                    case Stratum_V2::Set_Target:
+                        message.u256(this->target);
+
+                        return this->make_active_job(new_job);
+                }
+
+                return false;
+            }
+    };
+}
+
+/**
+ * @brief All pools
+ * 
+ * @author GerrFrog
+ */
+namespace Pools
+{
+    /**
+     * @brief Connector to pool with specific method of Stratum V1 protocol
+     * 
+     * @author GerrFrog
+     */
+    class Pool_V1
+        : virtual public Pools::Implementors::Stratum_Socket,
+          virtual public Pools::Implementors::Parsers::Parser_V1
+    {
+        private:
+            /**
+             * @brief Solver for jobs (optional)
+             * 
+             * @author GerrFrog
+             */
+            Solvers::Solver *solver;
+
+            /**
+             * @brief Pool index in solver (for hashrate split and 
+             * accounting)
+             * 
+             * @author GerrFrog
+             */
+            size_t pool;
+
+            /**
+             * @brief Submits waiting for response by command ID
+             * 
+             * @author GerrFrog
+             */
+            std::map<int, Implementors::Pending_Submit> submits;
+
+            /**
+             * @brief Callback when connected to server
+             * 
+             * @author GerrFrog
+             */
+            void handle_connect()
+            {
+                this->send(this->prepare_message(this->authorize_message));
+            }
+
+            /**
+             * @brief Callback when connection is lost. Submits without
+             * response are forgotten
+             * 
+             * @author GerrFrog
+             * 
+             * @param err Error code
+             */
+            void handle_disconnect(
+                const boost::system::error_code &err
+            )
+            {
+                this->submits.clear();
+
+                if (this->solver != nullptr)
+                    this->solver->add_reconnect(this->pool);
+
+                Stratum_Socket::handle_disconnect(err);
+            }
+
+            /**
+             * @brief Callback when queued messages are written
+             * 
+             * @author GerrFrog
+             */
+            void handle_written()
+            {
+                auto written = std::chrono::steady_clock::now();
+
+                for (auto &submit : this->submits)
+                {
+                    if (submit.second.written != std::chrono::steady_clock::time_point())
+                        continue;
+
+                    submit.second.written = written;
+                    this->solver->trace(Statistics::Stage::Submit, written - submit.second.found);
+                }
+            }
+
+            /**
+             * @brief Submit share to pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param share Found share
+             */
+            void submit(const Solvers::Implementors::Share &share)
+            {
+                nlohmann::json submit_message = {
+                    {"jsonrpc", "2.0"},
+                    {"method", "submit"},
+                    {"params", {
+                        {"id", this->rpc_id},
+                        {"job_id", share.job_id},
+                        {"nonce", share.nonce},
+                        {"result", share.result}
+                    }}
+                };
+
+                int id = this->command_id;
+
+                // Shares found while reconnecting belong to an old session
+                if (this->send(this->prepare_message(submit_message)))
+                    this->submits[id] = {std::chrono::steady_clock::now(), {}, share.found};
+            }
+
+            /**
+             * @brief Count pool response for submitted share
+             * 
+             * @author GerrFrog
+             * 
+             * @param json_message Server message
+             */
+            void handle_submit_result(const nlohmann::json &json_message)
+            {
+                if (this->solver == nullptr || !json_message["id"].is_number_integer())
+                    return;
+
+                auto submit = this->submits.find(json_message["id"].get<int>());
+
+                if (submit == this->submits.end())
+                    return;
+
+                auto now = std::chrono::steady_clock::now();
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - submit->second.sent
+                );
+
+                this->solver->get_submit_latency().record(latency);
+                this->solver->get_share_rtt().record(latency);
+                this->solver->trace(Statistics::Stage::Response, now - submit->second.written);
+                this->submits.erase(submit);
+
+                Statistics::Share_Counter &shares = this->solver->get_shares(this->pool);
+
+                if (json_message.contains("error") && !json_message["error"].is_null())
+                {
+                    string error = json_message["error"].is_object() 
+                        ? json_message["error"].value("message", "")
+                        : json_message["error"].dump();
+
+                    Logger::warning("share rejected: {}", error);
+
+                    std::transform(error.begin(), error.end(), error.begin(), ::tolower);
+
+                    if (
+                        error.find("stale") != string::npos ||
+                        error.find("expired") != string::npos
+                    )
+                        shares.add_stale();
+                    else
+                        shares.add_rejected();
+                } else if (
+                    json_message.contains("result") &&
+                    json_message["result"].is_object() &&
+                    json_message["result"].value("status", "") == "OK"
+                ) {
+                    Logger::info("share accepted ({} ms)", latency.count() / 1000.0);
+                    shares.add_accepted();
+                } else {
+                    Logger::warning("share rejected: {}", json_message.dump());
+                    shares.add_rejected();
+                }
+            }
+
+            /**
+             * @brief Callback when read server message
+             * 
+             * @author GerrFrog
+             * 
+             * @param message Line of server
+             */
+            void handle_server_msg(std::string_view message)
+            {
+                auto received = std::chrono::steady_clock::now();
+                string raw_message(message);
+                nlohmann::json json_message = nlohmann::json::parse(raw_message, nullptr, false);
+
+                Logger::debug("pool: {}", raw_message);
+
+                if (json_message.is_discarded())
+                    return;
+
+                if (this->is_job(json_message))
+                {
+                    Utilities::Pools::New_Job_V1 new_job = this->parse(raw_message);
+
+                    if (this->solver != nullptr)
+                    {
+                        this->solver->trace(
+                            Statistics::Stage::Parse,
+                            std::chrono::steady_clock::now() - received
+                        );
+                        this->solver->set_job(new_job, received, this->pool);
+                        Logger::info("new job {} height {}", new_job.job_id, new_job.height);
+                    }
+                } else if (json_message.contains("id")) {
+                    this->handle_submit_result(json_message);
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct a new xmr pool object
+             * 
+             * @author GerrFrog
+             * 
+             * @param io_context Shared io_context
+             * @param config Pool configuration
+             * @param solver Solver for jobs (optional)
+             * @param pool Pool index in solver
+             */
+            Pool_V1(
+                net::io_context &io_context,
+                nlohmann::json &config,
+                Solvers::Solver *solver = nullptr,
+                size_t pool = 0
+            ) : Stratum_Socket(
+                    io_context,
+                    (string)config["host"],
+                    (string)config["port"],
+                    Implementors::failover_endpoints(config),
+                    std::chrono::seconds(config.value("timeout", 300))
+                ),
+                Parser_V1(),
+                solver(solver),
+                pool(pool)
+            {
+                if (this->solver != nullptr)
+                    this->solver->set_submit_handler(
+                        [this](const Solvers::Implementors::Share &share) {
+                            net::post(
+                                this->strand,
+                                boost::bind(&Pool_V1::submit, this, share)
+                            );
+                        },
+                        this->pool
+                    );
+
+                nlohmann::json mining_authorize({
+                    {"method", "login"},
+                    {"params", {
+                        {"login", (string)config["login"]},
+                        {"pass", (string)config["password"]},
+                        {"agent", "user-agent/0.1"},
+                        {"mode", "self-select"}
+                    }}
+                });
+
+                this->authorize_message.insert(
+                    mining_authorize.begin(),
+                    mining_authorize.end()
+                );
+
+                this->start();
+            }
+    
+            /**
+             * @brief Destroy the xmr pool object
+             * 
+             * @author GerrFrog
+             */
+            virtual ~Pool_V1() = default;
+    };
+
+    /**
+     * @brief Solo mining with block templates of daemon (JSON-RPC of 
+     * monerod). Extranonce in reserved space of miner transaction is 
+     * rolled locally, so new work needs no daemon round trip. Daemon 
+     * has no long polling, so the cheap get_info is polled and template 
+     * is fetched again only when chain tip changes
+     * 
+     * @author GerrFrog
+     */
+    class Solo_V1
+    {
+        private:
+            /**
+             * @brief Solver for jobs
+             * 
+             * @author GerrFrog
+             */
+            Solvers::Solver *solver;
+
+            /**
+             * @brief Kept-alive connection to daemon on shared io_context
+             * 
+             * @author GerrFrog
+             */
+            Requests::HTTP_Pool daemon;
+
+            /**
+             * @brief Host of daemon
+             * 
+             * @author GerrFrog
+             */
+            string host;
+
+            /**
+             * @brief Port of daemon
+             * 
+             * @author GerrFrog
+             */
+            string port;
+
+            /**
+             * @brief Identifier of JSON-RPC call
+             * 
+             * @author GerrFrog
+             */
+            uint64_t rpc_id = 0;
+
+            /**
+             * @brief Wallet address for block reward
+             * 
+             * @author GerrFrog
+             */
+            string wallet;
+
+            /**
+             * @brief Reserved space in miner transaction (bytes)
+             * 
+             * @author GerrFrog
+             */
+            size_t reserve_size;
+
+            /**
+             * @brief Interval of chain tip polling
+             * 
+             * @author GerrFrog
+             */
+            std::chrono::milliseconds poll_interval;
+
+            /**
+             * @brief Template is fetched again after this time even if 
+             * chain tip is the same (new transactions of mempool)
+             * 
+             * @author GerrFrog
+             */
+            std::chrono::seconds refresh;
+
+            /**
+             * @brief Interval of extranonce rolling
+             * 
+             * @author GerrFrog
+             */
+            std::chrono::seconds roll_interval;
+
+            /**
+             * @brief Current and previous templates by template ID 
+             * (shares of previous one may still arrive)
+             * 
+             * @author GerrFrog
+             */
+            std::map<uint64_t, std::shared_ptr<const Monero::Block_Template>> templates;
+
+            /**
+             * @brief ID of current template
+             * 
+             * @author GerrFrog
+             */
+            uint64_t template_id = 0;
+
+            /**
+             * @brief Current extranonce
+             * 
+             * @author GerrFrog
+             */
+            uint64_t extranonce = 0;
+
+            /**
+             * @brief Mutex for found shares
+             * 
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+            /**
+             * @brief Wakes up the loop when share is found
+             * 
+             * @author GerrFrog
+             */
+            std::condition_variable wakeup;
+
+            /**
+             * @brief Found shares waiting for submit
+             * 
+             * @author GerrFrog
+             */
+            std::deque<Solvers::Implementors::Share> found;
+
+            /**
+             * @brief Loop is stopped (guarded by mutex)
+             * 
+             * @author GerrFrog
+             */
+            bool stopped = false;
+
+            /**
+             * @brief Thread of loop
+             * 
+             * @author GerrFrog
+             */
+            std::thread thread;
+
+            /**
+             * @brief Call JSON-RPC method of daemon and wait for result
+             * 
+             * @author GerrFrog
+             * 
+             * @param method Method
+             * @param params Parameters
+             * @return nlohmann::json Result of call
+             */
+            nlohmann::json call(
+                const string &method,
+                const nlohmann::json &params = nlohmann::json::object()
+            )
+            {
+                nlohmann::json reply = nlohmann::json::parse(
+                    this->daemon.request(
+                        this->host,
+                        this->port,
+                        http::verb::post,
+                        "/json_rpc",
+                        nlohmann::json({
+                            {"jsonrpc", "2.0"},
+                            {"id", std::to_string(++this->rpc_id)},
+                            {"method", method},
+                            {"params", params}
+                        }).dump()
+                    ).get()
+                );
+
+                if (reply.contains("error"))
+                    throw Exceptions::Requests::HTTP_Response_Error(
+                        method + ": " + reply["error"].value("message", reply["error"].dump()),
+                        reply["error"].value("code", 0),
+                        0
+                    );
+
+                return reply.at("result");
+            }
+
+            /**
+             * @brief Fetch new block template
+             * 
+             * @author GerrFrog
+             */
+            void fetch_template()
+            {
+                auto block_template = std::make_shared<const Monero::Block_Template>(
+                    this->call("get_block_template", {
+                        {"wallet_address", this->wallet},
+                        {"reserve_size", this->reserve_size}
+                    }),
+                    this->reserve_size
+                );
+
+                // Own tree hash must give the same blob as daemon
+                if (!block_template->is_consistent())
+                    throw Exceptions::Monero::Template_Error("Hashing blob differs from hashing blob of daemon");
+
+                this->templates[++this->template_id] = block_template;
+                while (this->templates.size() > 2)
+                    this->templates.erase(this->templates.begin());
+                this->extranonce = 0;
+
+                Logger::info(
+                    "block template {} height {} difficulty {} transactions {}", 
+                    this->template_id,
+                    block_template->get_height(),
+                    block_template->get_difficulty(),
+                    block_template->get_tx_count()
+                );
+            }
+
+            /**
+             * @brief Publish job for current template and extranonce
+             * 
+             * @author GerrFrog
+             */
+            void publish()
+            {
+                auto received = std::chrono::steady_clock::now();
+                const Monero::Block_Template &block_template = *this->templates.at(this->template_id);
+                uint64_t difficulty = block_template.get_difficulty();
+                uint64_t target = difficulty > 1 ? 0xFFFFFFFFFFFFFFFFULL / difficulty : 0xFFFFFFFFFFFFFFFFULL;
+                binary target_bytes(sizeof(target));
+
+                std::memcpy(target_bytes.data(), &target, sizeof(target));
+
+                this->solver->set_job({
+                    block_template.get_height(),
+                    Utilities::HEX_String(block_template.get_hashing_blob(this->extranonce)),
+                    std::to_string(this->template_id) + "." + std::to_string(this->extranonce),
+                    Utilities::HEX_String(target_bytes).get_encoded(),
+                    Utilities::HEX_String(block_template.get_seed_hash())
+                }, received);
+            }
+
+            /**
+             * @brief Submit block of found share to daemon
+             * 
+             * @author GerrFrog
+             * 
+             * @param share Found share
+             * @return bool Block was sent to daemon
+             */
+            bool submit(const Solvers::Implementors::Share &share)
+            {
+                Statistics::Share_Counter &shares = this->solver->get_shares();
+                size_t dot = share.job_id.find('.');
+                auto block_template = this->templates.find(std::stoull(share.job_id.substr(0, dot)));
+
+                if (block_template == this->templates.end())
+                {
+                    Logger::warning("share of job {} is stale", share.job_id);
+                    shares.add_stale();
+                    return false;
+                }
+
+                // Solver compares only the highest 64 bits of hash
+                if (!Monero::Block_Template::check_hash(
+                    Utilities::HEX_String(share.result).get_decoded(),
+                    block_template->second->get_difficulty()
+                ))
+                    return false;
+
+                binary block = block_template->second->get_block(
+                    std::stoull(share.job_id.substr(dot + 1)),
+                    Utilities::HEX_String(share.nonce).get_decoded()
+                );
+                auto sent = std::chrono::steady_clock::now();
+
+                try {
+                    nlohmann::json result = this->call(
+                        "submit_block", 
+                        {Utilities::HEX_String(block).get_encoded()}
+                    );
+                    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - sent
+                    );
+
+                    this->solver->get_submit_latency().record(latency);
+                    this->solver->get_share_rtt().record(latency);
+
+                    if (result.value("status", "") == "OK")
+                    {
+                        Logger::info("block accepted at height {} ({} ms)", block_template->second->get_height(), latency.count() / 1000.0);
+                        shares.add_accepted();
+
+                        // Chain tip moved, other shares of templates are stale
+                        this->templates.clear();
+                    } else {
+                        Logger::warning("block rejected: {}", result.dump());
+                        shares.add_rejected();
+                    }
+                } catch (const Exceptions::Requests::HTTP_Response_Error &exp) {
+                    Logger::warning("block rejected: {}", exp.what());
+                    shares.add_rejected();
+                }
+
+                return true;
+            }
 
         public:
             /**
-             * @brief Construct a new xmr parser object
+             * @brief Construct a new Solo_V1 object
              * 
              * @author GerrFrog
+             * 
+             * @param io_context Shared io_context
+             * @param config Solo configuration
+             * @param solver Solver for jobs
              */
-            Parser_V1() = default;
+            Solo_V1(
+                net::io_context &io_context,
+                nlohmann::json &config,
+                Solvers::Solver *solver
+            ) : solver(solver),
+                daemon(io_context, 1),
+                host(config.value("host", string("127.0.0.1"))),
+                port(config.value("port", string("18081"))),
+                wallet(config.at("wallet").get<string>()),
+                reserve_size(std::clamp<size_t>(config.value("reserve_size", 8), 1, 255)),
+                poll_interval(config.value("poll_interval", 500)),
+                refresh(config.value("refresh", 60)),
+                roll_interval(std::max(config.value("roll_interval", 30), 1))
+            {
+                this->solver->set_submit_handler(
+                    [this](const Solvers::Implementors::Share &share) {
+                        {
+                            std::lock_guard<std::mutex> lock(this->mutex);
+                            this->found.push_back(share);
+                        }
+                        this->wakeup.notify_one();
+                    }
+                );
+            }
 
             /**
-             * @brief Destroy the xmr parser object
+             * @brief Destroy the Solo_V1 object
              * 
              * @author GerrFrog
              */
-            ~Parser_V1() = default;
+            ~Solo_V1() { this->stop(); }
 
             /**
-             * @brief Parse server message
+             * @brief Start loop on own thread
              * 
              * @author GerrFrog
+             */
+            void start()
+            {
+                this->thread = std::thread(&Solo_V1::run, this);
+            }
+
+            /**
+             * @brief Stop loop and wait for its thread. Must be called 
+             * while io_context runs, requests of loop complete on it
              * 
-             * @param message Server message
+             * @author GerrFrog
              */
-            Utilities::Pools::New_Job_V1 parse(string &message)
+            void stop()
             {
-                nlohmann::json json_message = nlohmann::json::parse(message);
-                nlohmann::json params;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->stopped = true;
+                }
+                this->wakeup.notify_one();
 
-                Utilities::Pools::New_Job_V1 new_job;
+                if (this->thread.joinable())
+                    this->thread.join();
+            }
 
-                if (!json_message.contains("params"))
+            /**
+             * @brief Poll daemon, roll extranonce and submit blocks 
+             * until stopped
+             * 
+             * @author GerrFrog
+             */
+            void run()
+            {
+                using clock = std::chrono::steady_clock;
+
+                clock::time_point fetched, rolled, polled;
+
+                while (true)
                 {
-                    if ((string)json_message["result"]["status"] == "OK")
-                        this->status = true;
-                    if (json_message["result"].contains("id"))
+                    std::deque<Solvers::Implementors::Share> shares;
+
                     {
-                        this->rpc_id = (string)json_message["result"]["id"];
-                        params = json_message["result"]["job"];
-                    } else {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+
+                        this->wakeup.wait_until(lock, polled + this->poll_interval, [this]() {
+                            return !this->found.empty() || this->stopped;
+                        });
+                        if (this->stopped)
+                            return;
+                        shares.swap(this->found);
                     }
-                } else {
-                    params = json_message["params"];
-                }
 
-                string blob = params["blob"];
-                string seed_hash = params["seed_hash"];
+                    try {
+                        bool submitted = false;
 
-                new_job.height = params["height"];
-                new_job.blob = Utilities::HEX_String(blob);
-                new_job.job_id = params["job_id"];
-                new_job.target = params["target"];
-                new_job.seed_hash = Utilities::HEX_String(seed_hash);
+                        for (auto &share : shares)
+                            submitted = this->submit(share) || submitted;
 
-                return new_job;
+                        auto now = clock::now();
+
+                        if (now - polled < this->poll_interval && !submitted)
+                            continue;
+                        polled = now;
+
+                        bool changed = this->templates.empty() || submitted;
+
+                        if (!changed)
+                            changed = this->call("get_info").value("top_block_hash", string()) !=
+                                this->templates.at(this->template_id)->get_prev_hash();
+
+                        if (changed || now - fetched >= this->refresh)
+                        {
+                            this->fetch_template();
+                            fetched = rolled = now;
+                            this->publish();
+                        } else if (now - rolled >= this->roll_interval) {
+                            this->extranonce++;
+                            rolled = now;
+                            this->publish();
+                        }
+                    } catch (std::exception &exp) {
+                        Logger::warning("daemon: {}", exp.what());
+                    }
+                }
             }
     };
 
     /**
-     * @brief Parser for Stratum V2 messages (standard type)
+     * @brief Connector to pool with standard channel of Stratum V2 
+     * mining protocol (binary frames)
      * 
      * @author GerrFrog
      */
-    class Parser_V2
+    class Pool_V2
+        : virtual public Pools::Implementors::Stratum_Socket,
+          virtual public Pools::Implementors::Parsers::Parser_V2
     {
-        // TODO: Implement
         private:
+            /**
+             * @brief Solver for jobs (optional)
+             * 
+             * @author GerrFrog
+             */
+            Solvers::Solver *solver;
 
-        protected:
-
-        public:
             /**
-             * @brief Construct a new Stratum_Parser_V2 object
+             * @brief Pool index in solver (for hashrate split and 
+             * accounting)
              * 
              * @author GerrFrog
              */
-            Parser_V2() = default;
+            size_t pool;
 
             /**
-             * @brief Destroy the Stratum_Parser_V2 object
+             * @brief User identity of channel
              * 
              * @author GerrFrog
              */
-            ~Parser_V2() = default;
+            string login;
 
             /**
-             * @brief Parse server message
+             * @brief Nominal hashrate for initial target of channel
              * 
              * @author GerrFrog
+             */
+            float hashrate;
+
+            /**
+             * @brief Sequence number of next submit
              * 
-             * @param message Server message
+             * @author GerrFrog
              */
-            Utilities::Pools::New_Job_V2 parse(string &message)
-            {
-                // TODO: Implement parse message
-                Utilities::Pools::New_Job_V2 new_job;
-                cout << message << endl;
+            uint32_t sequence = 0;
 
-                return new_job;
-            }
-    };
-}
+            /**
+             * @brief Submits waiting for response by sequence number
+             * 
+             * @author GerrFrog
+             */
+            std::map<uint32_t, Implementors::Pending_Submit> submits;
 
-/**
- * @brief All pools
- * 
- * @author GerrFrog
- */
-namespace Pools
-{
-    /**
-     * @brief Connector to pool with specific method of Stratum V1 protocol
-     * 
-     * @author GerrFrog
-     */
-    class Pool_V1
-        : virtual public Pools::Implementors::Stratum_Socket,
-          virtual public Pools::Implementors::Parsers::Parser_V1
-    {
-        private:
             /**
              * @brief Callback when connected to server
              * 
              * @author GerrFrog
-             * 
-             * @param err Error code
              */
-            void handle_connect(
-                const boost::system::error_code& err
-            )
+            void handle_connect()
             {
-                if (!err)
-                {
-                    string message = this->prepare_message(this->authorize_message);
-
-                    this->socket.async_send(
-                        net::buffer(message),
-                        boost::bind(
-                            &Pool_V1::handle_write_completed,
-                            this,
-                            net::placeholders::error,
-                            net::placeholders::bytes_transferred
-                        )
-                    );
-                }
+                this->reset();
+                this->send(this->setup_connection(
+                    this->server,
+                    (uint16_t)std::stoul(this->port),
+                    this->login
+                ));
             }
 
             /**
-             * @brief Callback when read server message
+             * @brief Callback when connection is lost. Channel and 
+             * submits without response are forgotten
              * 
              * @author GerrFrog
              * 
              * @param err Error code
-             * @param bytes_transferred Raw transferred bytes
              */
-            void handle_server_msg(
-                const boost::system::error_code& err,
-                std::size_t bytes_transferred
+            void handle_disconnect(
+                const boost::system::error_code &err
             )
             {
-               if (!err)
-                {
-                    for (std::size_t start = 0, end = 0; end < bytes_transferred; end++, start = end)
-                    {
-                        while (end < bytes_transferred && read_buffer[ end ] != '\n')
-                            end++;
+                this->submits.clear();
+                this->reset();
 
-                        if (end == bytes_transferred)
-                        {
-                            string unfinished_message(
-                                std::next(std::begin(read_buffer), start),
-                                std::next(std::begin(read_buffer), end + 1)
-                            );
-                            cout << "[ERROR] unfinished data: " << unfinished_message << std::endl;
-                            break;
-                        }
+                if (this->solver != nullptr)
+                    this->solver->add_reconnect(this->pool);
 
-                        if (start == end)
-                            continue;
+                Stratum_Socket::handle_disconnect(err);
+            }
 
-                        string raw_message(
-                            std::next(std::begin(read_buffer), start),
-                            std::next(std::begin(read_buffer), end)
-                        );
+            /**
+             * @brief Callback when queued messages are written
+             * 
+             * @author GerrFrog
+             */
+            void handle_written()
+            {
+                auto written = std::chrono::steady_clock::now();
 
-                        Utilities::Pools::New_Job_V1 new_job = this->parse(raw_message);
-                        cout << raw_message << endl;
-
-                        this->socket.async_receive(
-                            net::buffer(this->read_buffer),
-                            boost::bind(
-                                &Pool_V1::handle_server_msg,
-                                this,
-                                net::placeholders::error,
-                                net::placeholders::bytes_transferred
-                            )
-                        );
-                    }
-                } else {
-                    // TODO: Error
+                for (auto &submit : this->submits)
+                {
+                    if (submit.second.written != std::chrono::steady_clock::time_point())
+                        continue;
+
+                    submit.second.written = written;
+                    this->solver->trace(Statistics::Stage::Submit, written - submit.second.found);
                 }
             }
 
-        public:
             /**
-             * @brief Construct a new xmr pool object
+             * @brief Submit share to pool
              * 
              * @author GerrFrog
              * 
-             * @param config Pool configuration
+             * @param share Found share
              */
-            Pool_V1(
-                nlohmann::json &config
-            ) : Stratum_Socket(
-                    (string)config["host"],
-                    (string)config["port"]
-                ),
-                Parser_V1()
+            void submit(const Solvers::Implementors::Share &share)
             {
-                nlohmann::json mining_authorize({
-                    {"method", "login"},
-                    {"params", {
-                        {"login", (string)config["login"]},
-                        {"pass", (string)config["password"]},
-                        {"agent", "user-agent/0.1"},
-                        {"mode", "self-select"}
-                    }}
-                });
+                binary decoded = Utilities::HEX_String(share.nonce).get_decoded();
+                uint32_t nonce = 0;
 
-                this->authorize_message.insert(
-                    mining_authorize.begin(),
-                    mining_authorize.end()
-                );
+                std::memcpy(&nonce, decoded.data(), std::min(decoded.size(), sizeof(nonce)));
 
-                auto _ = std::async(
-                    boost::bind(
-                        &net::io_service::run,
-                        &this->io_service
-                    )
-                );
-                this->io_service.post(
-                    boost::bind(
-                        &Pool_V1::connect,
-                        this
-                    )
+                std::string_view message = this->submit_shares_standard(
+                    this->sequence,
+                    (uint32_t)std::stoul(share.job_id),
+                    nonce
                 );
+
+                // Job is replaced by new block (or channel is lost)
+                if (message.empty())
+                {
+                    Logger::warning("share of job {} is stale", share.job_id);
+                    this->solver->get_shares(this->pool).add_stale();
+                    return;
+                }
+
+                if (this->send(message))
+                    this->submits[this->sequence++] = {std::chrono::steady_clock::now(), {}, share.found};
             }
-    
+
             /**
-             * @brief Destroy the xmr pool object
+             * @brief Count response of submit
              * 
              * @author GerrFrog
+             * 
+             * @param submit Submit
+             * @param accepted Share is accepted
+             * @param error Error code of pool
              */
-            virtual ~Pool_V1() = default;
-    };
+            void count_submit(
+                std::map<uint32_t, Implementors::Pending_Submit>::iterator submit,
+                bool accepted,
+                std::string_view error = {}
+            )
+            {
+                auto now = std::chrono::steady_clock::now();
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - submit->second.sent
+                );
+
+                this->solver->get_submit_latency().record(latency);
+                this->solver->get_share_rtt().record(latency);
+                this->solver->trace(Statistics::Stage::Response, now - submit->second.written);
+                this->submits.erase(submit);
+
+                Statistics::Share_Counter &shares = this->solver->get_shares(this->pool);
+
+                if (accepted)
+                {
+                    Logger::info("share accepted ({} ms)", latency.count() / 1000.0);
+                    shares.add_accepted();
+                } else {
+                    Logger::warning("share rejected: {}", string(error));
+
+                    if (error.find("stale") != std::string_view::npos)
+                        shares.add_stale();
+                    else
+                        shares.add_rejected();
+                }
+            }
 
-    /**
-     * @brief Connector to pool with specific method of Stratum V1 protocol
-     * 
-     * @author GerrFrog
-     */
-    class Pool_V2
-        : virtual public Pools::Implementors::Stratum_Socket,
-          virtual public Pools::Implementors::Parsers::Parser_V2
-    {
-        private:
             /**
-             * @brief Callback when connected to server
+             * @brief Count pool response for submitted shares. Success
+             * acknowledges all submits up to sequence number
              * 
              * @author GerrFrog
              * 
-             * @param err Error code
+             * @param message Frame of server
              */
-            void handle_connect(
-                const boost::system::error_code& err
-            )
+            void handle_submit_result(Implementors::Stratum_V2::Reader &message)
             {
-                if (!err)
+                if (this->solver == nullptr || message.u32() != this->channel_id)
+                    return;
+
+                uint32_t sequence = message.u32();
+
+                if (message.type == Implementors::Stratum_V2::Submit_Shares_Error)
                 {
-                    // TODO: Send messages to authorize via this->prepare_message(this->authorize_message)
-                    string message;
-
-                    this->socket.async_send(
-                        net::buffer(message),
-                        boost::bind(
-                            &Pool_V2::handle_write_completed,
-                            this,
-                            net::placeholders::error,
-                            net::placeholders::bytes_transferred
-                        )
-                    );
+                    auto submit = this->submits.find(sequence);
+
+                    if (submit != this->submits.end())
+                        this->count_submit(submit, false, message.str());
+                    return;
                 }
+
+                while (!this->submits.empty() && this->submits.begin()->first <= sequence)
+                    this->count_submit(this->submits.begin(), true);
             }
 
             /**
@@ -615,54 +2455,63 @@ namespace Pools
              * 
              * @author GerrFrog
              * 
-             * @param err Error code
-             * @param bytes_transferred Raw transferred bytes
+             * @param frame Frame of server
              */
-            void handle_server_msg(
-                const boost::system::error_code& err,
-                std::size_t bytes_transferred
-            )
+            void handle_server_msg(std::string_view frame)
             {
-               if (!err)
-                {
-                    for (std::size_t start = 0, end = 0; end < bytes_transferred; end++, start = end)
+                auto received = std::chrono::steady_clock::now();
+
+                try {
+                    Implementors::Stratum_V2::Reader message(frame);
+
+                    if (this->is_job(message))
                     {
-                        while (end < bytes_transferred && read_buffer[ end ] != '\n')
-                            end++;
+                        Utilities::Pools::New_Job_V1 new_job;
 
-                        if (end == bytes_transferred)
+                        if (this->parse(message, new_job) && this->solver != nullptr)
                         {
-                            string unfinished_message(
-                                std::next(std::begin(read_buffer), start),
-                                std::next(std::begin(read_buffer), end + 1)
+                            this->solver->trace(
+                                Statistics::Stage::Parse,
+                                std::chrono::steady_clock::now() - received
                             );
-                            cout << "[ERROR] unfinished data: " << unfinished_message << std::endl;
-                            break;
+                            this->solver->set_job(new_job, received, this->pool);
+                            Logger::info("new job {}", new_job.job_id);
                         }
+                        return;
+                    }
 
-                        if (start == end)
-                            continue;
+                    if (message.extension != 0)
+                        return;
 
-                        string raw_message(
-                            std::next(std::begin(read_buffer), start),
-                            std::next(std::begin(read_buffer), end)
-                        );
+                    switch (message.type)
+                    {
+                        case Implementors::Stratum_V2::Setup_Connection_Success:
+                            this->send(this->open_standard_mining_channel(1, this->login, this->hashrate));
+                            break;
 
-                        // TODO: Handle raw message
-                        cout << raw_message << endl;
-
-                        this->socket.async_receive(
-                            net::buffer(this->read_buffer),
-                            boost::bind(
-                                &Pool_V2::handle_server_msg,
-                                this,
-                                net::placeholders::error,
-                                net::placeholders::bytes_transferred
-                            )
-                        );
+                        case Implementors::Stratum_V2::Setup_Connection_Error:
+                            message.u32();  // flags
+                            Logger::error("pool {}:{}: setup connection: {}", this->server, this->port, string(message.str()));
+                            this->failover();
+                            break;
+
+                        case Implementors::Stratum_V2::Open_Mining_Channel_Error:
+                            message.u32();  // request_id
+                            Logger::error("pool {}:{}: open channel: {}", this->server, this->port, string(message.str()));
+                            this->failover();
+                            break;
+
+                        case Implementors::Stratum_V2::Submit_Shares_Success:
+                        case Implementors::Stratum_V2::Submit_Shares_Error:
+                            this->handle_submit_result(message);
+                            break;
+
+                        default:
+                            Logger::debug("pool: message {}", message.type);
                     }
-                } else {
-                    // TODO: Error
+                } catch (Exceptions::Pools::Protocol_Error &exp) {
+                    Logger::error("pool {}:{}: {}", this->server, this->port, exp.what());
+                    this->failover();
                 }
             }
 
@@ -672,30 +2521,42 @@ namespace Pools
              * 
              * @author GerrFrog
              * 
+             * @param io_context Shared io_context
              * @param config Pool configuration
+             * @param solver Solver for jobs (optional)
+             * @param pool Pool index in solver
              */
             Pool_V2(
-                nlohmann::json &config
+                net::io_context &io_context,
+                nlohmann::json &config,
+                Solvers::Solver *solver = nullptr,
+                size_t pool = 0
             ) : Stratum_Socket(
+                    io_context,
                     (string)config["host"],
-                    (string)config["port"]
+                    (string)config["port"],
+                    Implementors::failover_endpoints(config),
+                    std::chrono::seconds(config.value("timeout", 300))
                 ),
-                Parser_V2()
+                Parser_V2(),
+                solver(solver),
+                pool(pool),
+                login((string)config["login"]),
+                hashrate(config.value("hashrate", 1000.0f))
             {
-                // TODO: Create authorize messages
+                if (this->solver != nullptr)
+                    this->solver->set_submit_handler(
+                        [this](const Solvers::Implementors::Share &share) {
+                            net::post(
+                                this->strand,
+                                boost::bind(&Pool_V2::submit, this, share)
+                            );
+                        },
+                        this->pool
+                    );
 
-                auto _ = std::async(
-                    boost::bind(
-                        &net::io_service::run,
-                        &this->io_service
-                    )
-                );
-                this->io_service.post(
-                    boost::bind(
-                        &Pool_V2::connect,
-                        this
-                    )
-                );
+                this->binary_framing = true;
+                this->start();
             }
     
             /**
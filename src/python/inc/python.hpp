@@ -0,0 +1,607 @@
+#pragma once
+
+#ifndef PYTHON_HEADER
+#define PYTHON_HEADER
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <randomx.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../solvers/inc/solvers.hpp"
+
+using std::string;
+
+/**
+ * @brief Implementators for Python objects
+ *
+ * @author GerrFrog
+ */
+namespace Python::Implementors
+{
+    /**
+     * @brief Caches shared by all hashers of the module
+     *
+     * @author GerrFrog
+     *
+     * @return Solvers::Implementors::Cache_Storage&
+     */
+    inline Solvers::Implementors::Cache_Storage &caches()
+    {
+        static Solvers::Implementors::Cache_Storage storage(randomx_get_flags());
+
+        return storage;
+    }
+
+    /**
+     * @brief Get dataset for seed, shared by all hashers of the seed.
+     * Built with threads if no hasher holds it
+     *
+     * @author GerrFrog
+     *
+     * @param seed_hash Seed hash
+     * @param cache Initialized cache of seed
+     * @param threads Threads for building
+     * @return std::shared_ptr<randomx_dataset>
+     */
+    inline std::shared_ptr<randomx_dataset> get_dataset(
+        const binary &seed_hash,
+        randomx_cache *cache,
+        size_t threads
+    )
+    {
+        static std::map<binary, std::weak_ptr<randomx_dataset>> datasets;
+        static std::mutex mutex;
+
+        // Held while building: the same seed is never built twice
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<randomx_dataset> dataset = datasets[seed_hash].lock();
+
+        if (dataset)
+            return dataset;
+
+        randomx_dataset *memory = randomx_alloc_dataset((randomx_flags)(randomx_get_flags() | RANDOMX_FLAG_FULL_MEM));
+
+        if (memory == nullptr)
+            throw Exceptions::Solvers::RandomX_Error("Cannot allocate RandomX dataset");
+
+        unsigned long item_count = randomx_dataset_item_count();
+        unsigned long per_thread = item_count / threads;
+        std::vector<std::thread> init_threads;
+
+        for (size_t i = 0; i < threads; i++)
+        {
+            unsigned long start = i * per_thread;
+            unsigned long count = (i == threads - 1) ? item_count - start : per_thread;
+
+            init_threads.emplace_back(randomx_init_dataset, memory, cache, start, count);
+        }
+        for (auto &thread : init_threads)
+            thread.join();
+
+        dataset = std::shared_ptr<randomx_dataset>(memory, randomx_release_dataset);
+        datasets[seed_hash] = dataset;
+
+        return dataset;
+    }
+}
+
+/**
+ * @brief Python bindings
+ *
+ * @author GerrFrog
+ */
+namespace Python
+{
+    /**
+     * @brief Persistent hashing handle of one seed: cache (and dataset)
+     * and one VM per thread
+     *
+     * @author GerrFrog
+     */
+    class Hasher
+    {
+        private:
+            /**
+             * @brief Seed hash
+             *
+             * @author GerrFrog
+             */
+            binary seed_hash;
+
+            /**
+             * @brief Dataset mode
+             *
+             * @author GerrFrog
+             */
+            bool full_memory;
+
+            /**
+             * @brief Initialized cache
+             *
+             * @author GerrFrog
+             */
+            std::shared_ptr<randomx_cache> cache;
+
+            /**
+             * @brief Initialized dataset (empty in light mode)
+             *
+             * @author GerrFrog
+             */
+            std::shared_ptr<randomx_dataset> dataset;
+
+            /**
+             * @brief VM of every thread
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::unique_ptr<randomx_vm, void(*)(randomx_vm*)>> vms;
+
+            /**
+             * @brief Serializes batches, VMs are not shared
+             *
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+            /**
+             * @brief Hash range of blobs with one VM. Next blob is hashed
+             * while the result of the previous one is finished
+             *
+             * @author GerrFrog
+             *
+             * @param vm VM
+             * @param data Blobs one after another
+             * @param offsets Offsets of blobs in data (blobs + 1)
+             * @param begin First blob
+             * @param end Blob after the last one
+             * @param output Hashes of all blobs
+             */
+            static void hash_range(
+                randomx_vm *vm,
+                const uint8_t *data,
+                const std::vector<size_t> &offsets,
+                size_t begin,
+                size_t end,
+                uint8_t *output
+            )
+            {
+                if (begin == end)
+                    return;
+
+                randomx_calculate_hash_first(vm, data + offsets[begin], offsets[begin + 1] - offsets[begin]);
+                for (size_t i = begin + 1; i < end; i++)
+                    randomx_calculate_hash_next(
+                        vm,
+                        data + offsets[i],
+                        offsets[i + 1] - offsets[i],
+                        output + (i - 1) * RANDOMX_HASH_SIZE
+                    );
+                randomx_calculate_hash_last(vm, output + (end - 1) * RANDOMX_HASH_SIZE);
+            }
+
+        public:
+            /**
+             * @brief Construct a new Hasher object
+             *
+             * @author GerrFrog
+             *
+             * @param seed_hash Seed hash
+             * @param full_memory Dataset mode
+             * @param threads Hashing threads (0 for all CPUs)
+             */
+            Hasher(
+                const binary &seed_hash,
+                bool full_memory,
+                size_t threads
+            ) : seed_hash(seed_hash),
+                full_memory(full_memory),
+                cache(Implementors::caches().get(seed_hash))
+            {
+                if (threads == 0)
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+
+                randomx_flags flags = randomx_get_flags();
+
+                if (this->full_memory)
+                {
+                    this->dataset = Implementors::get_dataset(seed_hash, this->cache.get(), threads);
+                    flags |= RANDOMX_FLAG_FULL_MEM;
+                }
+
+                for (size_t i = 0; i < threads; i++)
+                {
+                    this->vms.emplace_back(
+                        randomx_create_vm(flags, this->cache.get(), this->dataset.get()),
+                        randomx_destroy_vm
+                    );
+                    if (!this->vms.back())
+                        throw Exceptions::Solvers::RandomX_Error(
+                            "Cannot create RandomX virtual machine"
+                        );
+                }
+            }
+
+            /**
+             * @brief Destroy the Hasher object
+             *
+             * @author GerrFrog
+             */
+            ~Hasher() = default;
+
+            /**
+             * @brief Hash blobs on all threads, every thread hashes a
+             * contiguous range
+             *
+             * @author GerrFrog
+             *
+             * @param data Blobs one after another
+             * @param offsets Offsets of blobs in data (blobs + 1)
+             * @param output Hashes of all blobs (RANDOMX_HASH_SIZE each)
+             */
+            void hash_many(const uint8_t *data, const std::vector<size_t> &offsets, uint8_t *output)
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                size_t count = offsets.size() - 1;
+                size_t threads = std::min(this->vms.size(), count);
+                std::vector<std::thread> workers;
+
+                for (size_t t = 1; t < threads; t++)
+                    workers.emplace_back(
+                        hash_range,
+                        this->vms[t].get(),
+                        data,
+                        std::cref(offsets),
+                        count * t / threads,
+                        count * (t + 1) / threads,
+                        output
+                    );
+                if (threads != 0)
+                    hash_range(this->vms[0].get(), data, offsets, 0, count / threads, output);
+                for (auto &worker : workers)
+                    worker.join();
+            }
+
+            /**
+             * @brief Get the seed hash
+             *
+             * @author GerrFrog
+             *
+             * @return const binary&
+             */
+            const binary &get_seed_hash() const { return this->seed_hash; }
+
+            /**
+             * @brief Check if dataset mode is used
+             *
+             * @author GerrFrog
+             *
+             * @return bool
+             */
+            bool is_full_memory() const { return this->full_memory; }
+
+            /**
+             * @brief Get number of threads
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_threads() const { return this->vms.size(); }
+    };
+}
+
+/**
+ * @brief CPython glue of the cpuminer module
+ *
+ * @author GerrFrog
+ */
+namespace Python::Bindings
+{
+    /**
+     * @brief Python object of Hasher
+     *
+     * @author GerrFrog
+     */
+    struct Hasher_Object
+    {
+        PyObject_HEAD
+        Python::Hasher *hasher;
+    };
+
+    /**
+     * @brief Hasher(seed, full=False, threads=0). Cache and dataset are
+     * prepared without the GIL
+     *
+     * @author GerrFrog
+     *
+     * @param type Type
+     * @param args Positional arguments
+     * @param kwargs Keyword arguments
+     * @return PyObject* New hasher (nullptr with exception)
+     */
+    inline PyObject *hasher_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+    {
+        static const char *keywords[] = {"seed", "full", "threads", nullptr};
+        Py_buffer seed;
+        int full = 0;
+        Py_ssize_t threads = 0;
+
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*|pn", (char **)keywords, &seed, &full, &threads))
+            return nullptr;
+
+        binary seed_hash((uint8_t *)seed.buf, (uint8_t *)seed.buf + seed.len);
+
+        PyBuffer_Release(&seed);
+        if (seed_hash.empty() || threads < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "seed must not be empty and threads must not be negative");
+            return nullptr;
+        }
+
+        Hasher_Object *self = (Hasher_Object *)type->tp_alloc(type, 0);
+        string error;
+
+        if (self == nullptr)
+            return nullptr;
+
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            self->hasher = new Python::Hasher(seed_hash, full, threads);
+        } catch (const std::exception &err) {
+            error = err.what();
+        }
+        Py_END_ALLOW_THREADS
+
+        if (!error.empty())
+        {
+            Py_DECREF(self);
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return nullptr;
+        }
+
+        return (PyObject *)self;
+    }
+
+    /**
+     * @brief Destroy hasher
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     */
+    inline void hasher_dealloc(Hasher_Object *self)
+    {
+        PyTypeObject *type = Py_TYPE(self);
+
+        delete self->hasher;
+        type->tp_free((PyObject *)self);
+        Py_DECREF(type);
+    }
+
+    /**
+     * @brief hash_many(blobs) -> bytes of 32-byte hashes in order of
+     * blobs. Blobs are copied, hashing runs without the GIL
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     * @param blobs Iterable of bytes-like objects
+     * @return PyObject* Hashes (nullptr with exception)
+     */
+    inline PyObject *hasher_hash_many(Hasher_Object *self, PyObject *blobs)
+    {
+        PyObject *sequence = PySequence_Fast(blobs, "blobs must be iterable");
+
+        if (sequence == nullptr)
+            return nullptr;
+
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+        std::vector<size_t> offsets = {0};
+        binary data;
+
+        for (Py_ssize_t i = 0; i < count; i++)
+        {
+            Py_buffer blob;
+
+            if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(sequence, i), &blob, PyBUF_SIMPLE) != 0)
+            {
+                Py_DECREF(sequence);
+                return nullptr;
+            }
+            data.insert(data.end(), (uint8_t *)blob.buf, (uint8_t *)blob.buf + blob.len);
+            offsets.push_back(data.size());
+            PyBuffer_Release(&blob);
+        }
+        Py_DECREF(sequence);
+
+        PyObject *hashes = PyBytes_FromStringAndSize(nullptr, count * RANDOMX_HASH_SIZE);
+
+        if (hashes == nullptr)
+            return nullptr;
+
+        // Not visible to other threads before it is returned
+        uint8_t *output = (uint8_t *)PyBytes_AS_STRING(hashes);
+
+        Py_BEGIN_ALLOW_THREADS
+        self->hasher->hash_many(data.data(), offsets, output);
+        Py_END_ALLOW_THREADS
+
+        return hashes;
+    }
+
+    /**
+     * @brief hash(blob) -> 32-byte hash
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     * @param blob Bytes-like object
+     * @return PyObject* Hash (nullptr with exception)
+     */
+    inline PyObject *hasher_hash(Hasher_Object *self, PyObject *blob)
+    {
+        PyObject *blobs = PyTuple_Pack(1, blob);
+
+        if (blobs == nullptr)
+            return nullptr;
+
+        PyObject *hashes = hasher_hash_many(self, blobs);
+
+        Py_DECREF(blobs);
+
+        return hashes;
+    }
+
+    /**
+     * @brief Hasher.seed
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     * @return PyObject* Seed hash
+     */
+    inline PyObject *hasher_seed(Hasher_Object *self, void *)
+    {
+        const binary &seed = self->hasher->get_seed_hash();
+
+        return PyBytes_FromStringAndSize((const char *)seed.data(), seed.size());
+    }
+
+    /**
+     * @brief Hasher.full
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     * @return PyObject* Dataset mode
+     */
+    inline PyObject *hasher_full(Hasher_Object *self, void *)
+    {
+        return PyBool_FromLong(self->hasher->is_full_memory());
+    }
+
+    /**
+     * @brief Hasher.threads
+     *
+     * @author GerrFrog
+     *
+     * @param self Hasher
+     * @return PyObject* Number of threads
+     */
+    inline PyObject *hasher_threads(Hasher_Object *self, void *)
+    {
+        return PyLong_FromSize_t(self->hasher->get_threads());
+    }
+
+    /**
+     * @brief Methods of Hasher
+     *
+     * @author GerrFrog
+     */
+    inline PyMethodDef hasher_methods[] = {
+        {"hash_many", (PyCFunction)hasher_hash_many, METH_O, "hash_many(blobs) -> bytes of 32-byte hashes in order of blobs"},
+        {"hash", (PyCFunction)hasher_hash, METH_O, "hash(blob) -> 32-byte hash"},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    /**
+     * @brief Properties of Hasher
+     *
+     * @author GerrFrog
+     */
+    inline PyGetSetDef hasher_getset[] = {
+        {"seed", (getter)hasher_seed, nullptr, "Seed hash", nullptr},
+        {"full", (getter)hasher_full, nullptr, "Dataset mode", nullptr},
+        {"threads", (getter)hasher_threads, nullptr, "Number of threads", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+
+    /**
+     * @brief Slots of Hasher type
+     *
+     * @author GerrFrog
+     */
+    inline PyType_Slot hasher_slots[] = {
+        {Py_tp_new, (void *)hasher_new},
+        {Py_tp_dealloc, (void *)hasher_dealloc},
+        {Py_tp_methods, hasher_methods},
+        {Py_tp_getset, hasher_getset},
+        {Py_tp_doc, (void *)"Hasher(seed, full=False, threads=0): RandomX cache (and dataset) of seed with one VM per thread"},
+        {0, nullptr}
+    };
+
+    /**
+     * @brief Specification of Hasher type
+     *
+     * @author GerrFrog
+     */
+    inline PyType_Spec hasher_spec = {
+        "cpuminer.Hasher",
+        sizeof(Hasher_Object),
+        0,
+        Py_TPFLAGS_DEFAULT,
+        hasher_slots
+    };
+
+    /**
+     * @brief Definition of the module
+     *
+     * @author GerrFrog
+     */
+    inline PyModuleDef module = {
+        PyModuleDef_HEAD_INIT,
+        "cpuminer",
+        "RandomX batch hashing of CPUMinerRandomX",
+        -1,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr
+    };
+}
+
+/**
+ * @brief Initialize the cpuminer module
+ *
+ * @author GerrFrog
+ *
+ * @return PyMODINIT_FUNC Module
+ */
+PyMODINIT_FUNC PyInit_cpuminer()
+{
+    PyObject *module = PyModule_Create(&Python::Bindings::module);
+
+    if (module == nullptr)
+        return nullptr;
+
+    PyObject *type = PyType_FromSpec(&Python::Bindings::hasher_spec);
+
+    if (type == nullptr || PyModule_AddObject(module, "Hasher", type) != 0)
+    {
+        Py_XDECREF(type);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    PyModule_AddIntConstant(module, "HASH_SIZE", RANDOMX_HASH_SIZE);
+
+    return module;
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../inc/python.hpp"
\ No newline at end of file
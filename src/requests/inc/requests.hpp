@@ -13,6 +13,10 @@
 #include <string>
 #include <thread>
 #include <future>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <vector>
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -42,6 +46,37 @@ using std::endl;
 using std::string;
 using std::unordered_map;
 
+/**
+ * @brief Implementators for Request objects
+ *
+ * @author GerrFrog
+ */
+namespace Requests::Implementors
+{
+    /**
+     * @brief Check if request with method may be sent twice
+     *
+     * @author GerrFrog
+     *
+     * @param method HTTP method
+     * @return bool
+     */
+    inline bool is_idempotent(http::verb method)
+    {
+        switch (method)
+        {
+            case http::verb::get:
+            case http::verb::head:
+            case http::verb::put:
+            case http::verb::delete_:
+            case http::verb::options:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
 /**
  * @brief Abstracts classes for Request objects
  *
@@ -148,6 +183,48 @@ namespace Requests::Abstracts
              */
             virtual http::request<http::string_body> setup_http(string &target) = 0;
 
+            /**
+             * @brief Write request and read response on kept-alive
+             * connection. Response is cleared before reading (its buffer
+             * is reused), connection is opened again once if server
+             * closed it. Written request is sent again only if it is 
+             * idempotent, server may have processed it
+             *
+             * @author GerrFrog
+             *
+             * @param request_message Request
+             * @return string Content of Response
+             */
+            string exchange(const http::request<http::string_body> &request_message)
+            {
+                for (int attempt = 0; ; attempt++)
+                {
+                    bool written = false;
+
+                    try {
+                        this->response.clear();
+                        this->response.body().consume(this->response.body().size());
+
+                        http::write(this->stream, request_message);
+                        written = true;
+                        http::read(this->stream, this->buffer, this->response);
+                        break;
+                    } catch (const beast::system_error &e) {
+                        if (attempt > 0 || (written && !Requests::Implementors::is_idempotent(request_message.method())))
+                            throw;
+
+                        beast::error_code ec;
+
+                        this->stream.socket().close(ec);
+                        this->buffer.consume(this->buffer.size());
+                        this->stream.connect(
+                            this->resolver.resolve(this->host, this->port));
+                    }
+                }
+
+                return beast::buffers_to_string(this->response.body().data());
+            }
+
         public:
             /**
              * @brief Construct a new Request object
@@ -218,6 +295,409 @@ namespace Requests::Abstracts
     };
 }
 
+/**
+ * @brief Implementators for Request objects
+ *
+ * @author GerrFrog
+ */
+namespace Requests::Implementors
+{
+    /**
+     * @brief Response of pooled client
+     *
+     * @author GerrFrog
+     */
+    using Response = http::response<http::string_body>;
+
+    /**
+     * @brief Completion handler of pooled request. Response is reused
+     * by connection and valid only during the call
+     *
+     * @author GerrFrog
+     */
+    using Response_Handler = std::function<void(beast::error_code, const Response&)>;
+
+    /**
+     * @brief Request waiting for connection or response
+     *
+     * @author GerrFrog
+     */
+    struct Pending_Request
+    {
+        /**
+         * @brief Request
+         *
+         * @author GerrFrog
+         */
+        http::request<http::string_body> request;
+
+        /**
+         * @brief Completion handler
+         *
+         * @author GerrFrog
+         */
+        Response_Handler handler;
+
+        /**
+         * @brief Time when request times out
+         *
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point deadline;
+
+        /**
+         * @brief Request was already sent again on new connection
+         *
+         * @author GerrFrog
+         */
+        bool retried = false;
+    };
+
+    /**
+     * @brief Persistent HTTP/1.1 connection. Requests are pipelined:
+     * they are written as soon as they are queued and responses are read
+     * in the same order. All handlers run on the strand of pool
+     *
+     * @author GerrFrog
+     */
+    class Connection : public std::enable_shared_from_this<Connection>
+    {
+        private:
+            /**
+             * @brief Resolver for TCP connection
+             *
+             * @author GerrFrog
+             */
+            tcp::resolver resolver;
+
+            /**
+             * @brief TCP Stream
+             *
+             * @author GerrFrog
+             */
+            beast::tcp_stream stream;
+
+            /**
+             * @brief Timeout of the oldest request
+             *
+             * @author GerrFrog
+             */
+            net::steady_timer timer;
+
+            /**
+             * @brief Buffer for reading (may hold pipelined responses)
+             *
+             * @author GerrFrog
+             */
+            beast::flat_buffer buffer;
+
+            /**
+             * @brief Response, cleared and reused for every request
+             *
+             * @author GerrFrog
+             */
+            Response response;
+
+            /**
+             * @brief Host
+             *
+             * @author GerrFrog
+             */
+            string host;
+
+            /**
+             * @brief Port
+             *
+             * @author GerrFrog
+             */
+            string port;
+
+            /**
+             * @brief Requests waiting for writing
+             *
+             * @author GerrFrog
+             */
+            std::deque<std::shared_ptr<Pending_Request>> queued;
+
+            /**
+             * @brief Written requests waiting for response
+             *
+             * @author GerrFrog
+             */
+            std::deque<std::shared_ptr<Pending_Request>> sent;
+
+            /**
+             * @brief Sends requests of failed connection again
+             *
+             * @author GerrFrog
+             */
+            std::function<void(std::shared_ptr<Pending_Request>)> retry;
+
+            /**
+             * @brief Responses read on this connection
+             *
+             * @author GerrFrog
+             */
+            size_t served = 0;
+
+            /**
+             * @brief State flags
+             *
+             * @author GerrFrog
+             */
+            bool connected = false, writing = false, reading = false, closed = false;
+
+            /**
+             * @brief Close connection and complete its requests. Unwritten
+             * requests are sent again on other connection. Written 
+             * requests of a reused connection are sent again only if they
+             * are idempotent, since server may close idle keep-alive 
+             * connection at any time, but may also have processed them
+             *
+             * @author GerrFrog
+             *
+             * @param ec Error code
+             */
+            void fail(beast::error_code ec)
+            {
+                if (this->closed)
+                    return;
+                this->closed = true;
+
+                beast::error_code ignored;
+
+                this->stream.socket().close(ignored);
+                this->timer.cancel();
+
+                std::deque<std::shared_ptr<Pending_Request>> sent, queued;
+
+                sent.swap(this->sent);
+                queued.swap(this->queued);
+
+                // Closed pool and timeouts complete requests with error
+                bool retry = ec != net::error::timed_out && ec != net::error::operation_aborted;
+
+                for (auto &request : sent)
+                {
+                    if (retry && this->served != 0 && !request->retried && is_idempotent(request->request.method()))
+                    {
+                        request->retried = true;
+                        this->retry(request);
+                    } else {
+                        request->handler(ec, this->response);
+                    }
+                }
+
+                for (auto &request : queued)
+                {
+                    if (retry && !request->retried)
+                    {
+                        request->retried = true;
+                        this->retry(request);
+                    } else {
+                        request->handler(ec, this->response);
+                    }
+                }
+            }
+
+            /**
+             * @brief Arm timeout of the oldest request
+             *
+             * @author GerrFrog
+             */
+            void arm_timer()
+            {
+                auto &oldest = !this->sent.empty() ? this->sent.front() : this->queued.front();
+
+                this->timer.expires_at(oldest->deadline);
+                this->timer.async_wait(
+                    [self = this->shared_from_this()](beast::error_code ec) {
+                        if (ec != net::error::operation_aborted && !self->closed)
+                            self->fail(net::error::timed_out);
+                    }
+                );
+            }
+
+            /**
+             * @brief Write next queued request
+             *
+             * @author GerrFrog
+             */
+            void do_write()
+            {
+                if (this->writing || !this->connected || this->closed || this->queued.empty())
+                    return;
+
+                this->writing = true;
+                http::async_write(
+                    this->stream,
+                    this->queued.front()->request,
+                    [self = this->shared_from_this()](beast::error_code ec, std::size_t) {
+                        self->writing = false;
+                        if (ec)
+                            return self->fail(ec);
+                        if (self->closed)
+                            return;
+
+                        self->sent.push_back(self->queued.front());
+                        self->queued.pop_front();
+                        self->do_read();
+                        self->do_write();
+                    }
+                );
+            }
+
+            /**
+             * @brief Read response of the oldest written request
+             *
+             * @author GerrFrog
+             */
+            void do_read()
+            {
+                if (this->reading || this->closed || this->sent.empty())
+                    return;
+
+                this->reading = true;
+                this->arm_timer();
+
+                this->response.clear();
+                this->response.body().clear();
+
+                http::async_read(
+                    this->stream,
+                    this->buffer,
+                    this->response,
+                    [self = this->shared_from_this()](beast::error_code ec, std::size_t) {
+                        self->reading = false;
+                        if (ec)
+                            return self->fail(ec);
+                        if (self->closed)
+                            return;
+
+                        auto request = self->sent.front();
+
+                        self->sent.pop_front();
+                        self->served++;
+                        request->handler({}, self->response);
+
+                        // Pipelined requests go to other connection
+                        if (!self->response.keep_alive())
+                            return self->fail(http::error::end_of_stream);
+
+                        if (self->sent.empty() && self->queued.empty())
+                            self->timer.cancel();
+                        else if (self->sent.empty())
+                            self->arm_timer();
+                        self->do_read();
+                    }
+                );
+            }
+
+        public:
+            /**
+             * @brief Construct a new Connection object
+             *
+             * @author GerrFrog
+             *
+             * @param executor Strand of pool
+             * @param host Host
+             * @param port Port
+             * @param retry Sends request again on other connection
+             */
+            Connection(
+                const net::strand<net::io_context::executor_type> &executor,
+                const string &host,
+                const string &port,
+                std::function<void(std::shared_ptr<Pending_Request>)> retry
+            ) : resolver(executor),
+                stream(executor),
+                timer(executor),
+                host(host),
+                port(port),
+                retry(retry)
+            { }
+
+            /**
+             * @brief Destroy the Connection object
+             *
+             * @author GerrFrog
+             */
+            ~Connection() = default;
+
+            /**
+             * @brief Resolve and connect
+             *
+             * @author GerrFrog
+             */
+            void start()
+            {
+                if (!this->queued.empty())
+                    this->arm_timer();
+
+                this->resolver.async_resolve(
+                    this->host,
+                    this->port,
+                    [self = this->shared_from_this()](beast::error_code ec, tcp::resolver::results_type results) {
+                        if (ec)
+                            return self->fail(ec);
+
+                        self->stream.async_connect(
+                            results,
+                            [self](beast::error_code ec, const tcp::endpoint &) {
+                                if (ec)
+                                    return self->fail(ec);
+
+                                self->stream.socket().set_option(tcp::no_delay(true));
+                                self->connected = true;
+                                self->do_write();
+                            }
+                        );
+                    }
+                );
+            }
+
+            /**
+             * @brief Queue request
+             *
+             * @author GerrFrog
+             *
+             * @param request Request
+             */
+            void enqueue(std::shared_ptr<Pending_Request> request)
+            {
+                this->queued.push_back(request);
+                if (this->sent.empty() && this->queued.size() == 1 && this->connected)
+                    this->arm_timer();
+                this->do_write();
+            }
+
+            /**
+             * @brief Close connection, requests complete with error
+             *
+             * @author GerrFrog
+             */
+            void close() { this->fail(net::error::operation_aborted); }
+
+            /**
+             * @brief Get number of requests on connection
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_pending() const { return this->queued.size() + this->sent.size(); }
+
+            /**
+             * @brief Check if connection is closed
+             *
+             * @author GerrFrog
+             *
+             * @return bool
+             */
+            bool is_closed() const { return this->closed; }
+    };
+}
+
 /**
  * @brief Contains all Requests objects to remote host
  *
@@ -247,6 +727,7 @@ namespace Requests
 
             req.set(http::field::host, this->host);
             req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+            req.keep_alive(true);
 
             return req;
         }
@@ -291,13 +772,7 @@ namespace Requests
             if (!parameters.empty())
                 url += this->joinQueryParameters(parameters);
 
-            http::request<http::string_body> request_message =
-                this->setup_http(url);
-
-            http::write(this->stream, request_message);
-            http::read(this->stream, this->buffer, this->response);
-
-            return beast::buffers_to_string(this->response.body().data());
+            return this->exchange(this->setup_http(url));
         }
 
         /**
@@ -318,13 +793,283 @@ namespace Requests
             if (!parameters.empty())
                 url += this->joinQueryParameters(parameters);
 
-            http::request<http::string_body> request_message =
-                this->setup_http(url);
+            return nlohmann::json::parse(this->exchange(this->setup_http(url)));
+        }
+    };
 
-            http::write(this->stream, request_message);
-            http::read(this->stream, this->buffer, this->response);
+    /**
+     * @brief Pooled asynchronous HTTP/1.1 client. Connections to every
+     * host are persistent (keep-alive) and requests are pipelined on
+     * them; new connection is opened only when all connections of host
+     * have full pipeline. Runs on a strand of given io_context, which
+     * must outlive the pool
+     *
+     * @author GerrFrog
+     */
+    class HTTP_Pool
+    {
+    private:
+        /**
+         * @brief Strand for connections
+         *
+         * @author GerrFrog
+         */
+        net::strand<net::io_context::executor_type> strand;
 
-            return nlohmann::json::parse(beast::buffers_to_string(this->response.body().data()));
+        /**
+         * @brief Connections by "host:port"
+         *
+         * @author GerrFrog
+         */
+        std::map<string, std::vector<std::shared_ptr<Requests::Implementors::Connection>>> connections;
+
+        /**
+         * @brief Maximum connections to one host
+         *
+         * @author GerrFrog
+         */
+        size_t max_connections;
+
+        /**
+         * @brief Maximum requests in flight on one connection
+         *
+         * @author GerrFrog
+         */
+        size_t pipeline;
+
+        /**
+         * @brief Timeout of request
+         *
+         * @author GerrFrog
+         */
+        std::chrono::milliseconds timeout;
+
+        /**
+         * @brief Send request on least loaded connection of host
+         *
+         * @author GerrFrog
+         *
+         * @param host Host
+         * @param port Port
+         * @param request Request
+         */
+        void dispatch(
+            const string &host,
+            const string &port,
+            std::shared_ptr<Requests::Implementors::Pending_Request> request)
+        {
+            auto &pool = this->connections[host + ":" + port];
+
+            pool.erase(
+                std::remove_if(pool.begin(), pool.end(), [](auto &connection) { return connection->is_closed(); }),
+                pool.end()
+            );
+
+            auto least = std::min_element(pool.begin(), pool.end(), [](auto &a, auto &b) {
+                return a->get_pending() < b->get_pending();
+            });
+
+            if (least != pool.end() && ((*least)->get_pending() < this->pipeline || pool.size() >= this->max_connections))
+                return (*least)->enqueue(request);
+
+            auto connection = std::make_shared<Requests::Implementors::Connection>(
+                this->strand,
+                host,
+                port,
+                [this, host, port](std::shared_ptr<Requests::Implementors::Pending_Request> request) {
+                    net::post(this->strand, [this, host, port, request]() {
+                        this->dispatch(host, port, request);
+                    });
+                }
+            );
+
+            pool.push_back(connection);
+            connection->enqueue(request);
+            connection->start();
+        }
+
+        /**
+         * @brief Close all connections (on strand)
+         *
+         * @author GerrFrog
+         */
+        void close_connections()
+        {
+            for (auto &host : this->connections)
+                for (auto &connection : host.second)
+                    connection->close();
+            this->connections.clear();
+        }
+
+    public:
+        /**
+         * @brief Construct a new HTTP_Pool object
+         *
+         * @author GerrFrog
+         *
+         * @param ioc Input/Output context
+         * @param max_connections Maximum connections to one host
+         * @param pipeline Maximum requests in flight on one connection
+         * @param timeout Timeout of request
+         */
+        HTTP_Pool(
+            net::io_context &ioc,
+            size_t max_connections = 4,
+            size_t pipeline = 8,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)
+        ) : strand(net::make_strand(ioc)),
+            max_connections(std::max<size_t>(max_connections, 1)),
+            pipeline(std::max<size_t>(pipeline, 1)),
+            timeout(timeout)
+        { }
+
+        /**
+         * @brief Destroy the HTTP_Pool object. Connections are closed on
+         * strand, their retry handlers refer to the pool
+         *
+         * @author GerrFrog
+         */
+        ~HTTP_Pool()
+        {
+            if (this->strand.get_inner_executor().context().stopped() || this->strand.running_in_this_thread())
+            {
+                this->close_connections();
+                return;
+            }
+
+            std::promise<void> closed;
+
+            net::post(this->strand, [this, &closed]() {
+                this->close_connections();
+                closed.set_value();
+            });
+            closed.get_future().wait();
+        }
+
+        /**
+         * @brief Send request asynchronously
+         *
+         * @author GerrFrog
+         *
+         * @param host Host
+         * @param port Port
+         * @param method HTTP method
+         * @param target URL with query
+         * @param body Body (JSON)
+         * @param handler Completion handler (runs on strand of pool)
+         */
+        void async_request(
+            const string &host,
+            const string &port,
+            http::verb method,
+            const string &target,
+            const string &body,
+            Requests::Implementors::Response_Handler handler)
+        {
+            auto request = std::make_shared<Requests::Implementors::Pending_Request>();
+
+            request->request = {method, target, 11};
+            request->request.set(http::field::host, host);
+            request->request.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+            request->request.keep_alive(true);
+            if (!body.empty())
+            {
+                request->request.set(http::field::content_type, "application/json");
+                request->request.body() = body;
+            }
+            request->request.prepare_payload();
+            request->handler = std::move(handler);
+            request->deadline = std::chrono::steady_clock::now() + this->timeout;
+
+            net::post(this->strand, [this, host, port, request]() {
+                this->dispatch(host, port, request);
+            });
+        }
+
+        /**
+         * @brief Send GET request asynchronously
+         *
+         * @author GerrFrog
+         *
+         * @param host Host
+         * @param port Port
+         * @param target URL with query
+         * @param handler Completion handler (runs on strand of pool)
+         */
+        void async_get(
+            const string &host,
+            const string &port,
+            const string &target,
+            Requests::Implementors::Response_Handler handler)
+        {
+            this->async_request(host, port, http::verb::get, target, "", std::move(handler));
+        }
+
+        /**
+         * @brief Send request, result is waited from other thread than
+         * io_context runs on
+         *
+         * @author GerrFrog
+         *
+         * @param host Host
+         * @param port Port
+         * @param method HTTP method
+         * @param target URL with query
+         * @param body Body (JSON)
+         * @return std::future<string> Content of Response
+         */
+        std::future<string> request(
+            const string &host,
+            const string &port,
+            http::verb method,
+            const string &target,
+            const string &body = "")
+        {
+            auto promise = std::make_shared<std::promise<string>>();
+
+            this->async_request(host, port, method, target, body, [promise, target](beast::error_code ec, const Requests::Implementors::Response &response) {
+                if (ec)
+                    promise->set_exception(std::make_exception_ptr(beast::system_error(ec)));
+                else if (response.result() != http::status::ok)
+                    promise->set_exception(std::make_exception_ptr(Exceptions::Requests::HTTP_Response_Error(
+                        "HTTP status " + std::to_string(response.result_int()) + " for " + target,
+                        response.result_int(),
+                        0
+                    )));
+                else
+                    promise->set_value(response.body());
+            });
+
+            return promise->get_future();
+        }
+
+        /**
+         * @brief Send GET request, result is waited from other thread
+         * than io_context runs on
+         *
+         * @author GerrFrog
+         *
+         * @param host Host
+         * @param port Port
+         * @param target URL with query
+         * @return std::future<string> Content of Response
+         */
+        std::future<string> get(
+            const string &host,
+            const string &port,
+            const string &target)
+        {
+            return this->request(host, port, http::verb::get, target);
+        }
+
+        /**
+         * @brief Close all connections, requests complete with error
+         *
+         * @author GerrFrog
+         */
+        void close()
+        {
+            net::post(this->strand, [this]() { this->close_connections(); });
         }
     };
 }
@@ -0,0 +1,828 @@
+#pragma once
+
+#ifndef SERVER_HEADER
+#define SERVER_HEADER
+
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <sstream>
+
+#include "../../requests/inc/requests.hpp"
+#include "../../solvers/inc/solvers.hpp"
+#include "../../statistics/inc/statistics.hpp"
+#include "../../utilities/inc/utilities.hpp"
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/**
+ * @brief Implementators for Server object
+ *
+ * @author GerrFrog
+ */
+namespace Server::Implementors
+{
+    /**
+     * @brief HTTP request
+     *
+     * @author GerrFrog
+     */
+    using Request = http::request<http::string_body>;
+
+    /**
+     * @brief HTTP response
+     *
+     * @author GerrFrog
+     */
+    using Response = http::response<http::string_body>;
+
+    /**
+     * @brief Escape label value for OpenMetrics (backslash, 
+     * double quote and line feed)
+     *
+     * @author GerrFrog
+     *
+     * @param value Label value
+     * @return string
+     */
+    inline string escape_label(const string &value)
+    {
+        string escaped;
+
+        for (char c : value)
+        {
+            if (c == '\\')
+                escaped += "\\\\";
+            else if (c == '"')
+                escaped += "\\\"";
+            else if (c == '\n')
+                escaped += "\\n";
+            else
+                escaped += c;
+        }
+
+        return escaped;
+    }
+
+    /**
+     * @brief One HTTP connection. Reads requests and writes responses
+     * until the client closes connection
+     *
+     * @note https://www.boost.org/doc/libs/1_74_0/libs/beast/example/http/server/async/http_server_async.cpp
+     *
+     * @author GerrFrog
+     */
+    class Session : public std::enable_shared_from_this<Session>
+    {
+        private:
+            /**
+             * @brief Client socket
+             *
+             * @author GerrFrog
+             */
+            tcp::socket socket;
+
+            /**
+             * @brief Buffer for reading
+             *
+             * @author GerrFrog
+             */
+            beast::flat_buffer buffer;
+
+            /**
+             * @brief Current request
+             *
+             * @author GerrFrog
+             */
+            Request request;
+
+            /**
+             * @brief Current response
+             *
+             * @author GerrFrog
+             */
+            Response response;
+
+            /**
+             * @brief Request handler
+             *
+             * @author GerrFrog
+             */
+            std::function<Response(const Request&)> handler;
+
+            /**
+             * @brief Read next request
+             *
+             * @author GerrFrog
+             */
+            void read()
+            {
+                this->request = {};
+
+                http::async_read(
+                    this->socket,
+                    this->buffer,
+                    this->request,
+                    beast::bind_front_handler(
+                        &Session::handle_read,
+                        this->shared_from_this()
+                    )
+                );
+            }
+
+            /**
+             * @brief Callback when request is read
+             *
+             * @author GerrFrog
+             *
+             * @param err Error code
+             * @param bytes_transferred Raw transferred bytes
+             */
+            void handle_read(
+                beast::error_code err,
+                std::size_t bytes_transferred
+            )
+            {
+                boost::ignore_unused(bytes_transferred);
+
+                if (err)
+                {
+                    this->close();
+                    return;
+                }
+
+                this->response = this->handler(this->request);
+                this->response.keep_alive(this->request.keep_alive());
+                this->response.prepare_payload();
+
+                http::async_write(
+                    this->socket,
+                    this->response,
+                    beast::bind_front_handler(
+                        &Session::handle_write,
+                        this->shared_from_this()
+                    )
+                );
+            }
+
+            /**
+             * @brief Callback when response is written
+             *
+             * @author GerrFrog
+             *
+             * @param err Error code
+             * @param bytes_transferred Raw transferred bytes
+             */
+            void handle_write(
+                beast::error_code err,
+                std::size_t bytes_transferred
+            )
+            {
+                boost::ignore_unused(bytes_transferred);
+
+                if (err || !this->response.keep_alive())
+                {
+                    this->close();
+                    return;
+                }
+
+                this->read();
+            }
+
+            /**
+             * @brief Close connection
+             *
+             * @author GerrFrog
+             */
+            void close()
+            {
+                beast::error_code err;
+
+                this->socket.shutdown(tcp::socket::shutdown_send, err);
+            }
+
+        public:
+            /**
+             * @brief Construct a new Session object
+             *
+             * @author GerrFrog
+             *
+             * @param socket Accepted socket
+             * @param handler Request handler
+             */
+            Session(
+                tcp::socket &&socket,
+                std::function<Response(const Request&)> handler
+            ) : socket(std::move(socket)),
+                handler(handler)
+            { }
+
+            /**
+             * @brief Destroy the Session object
+             *
+             * @author GerrFrog
+             */
+            ~Session() = default;
+
+            /**
+             * @brief Start reading requests
+             *
+             * @author GerrFrog
+             */
+            void run()
+            {
+                this->read();
+            }
+    };
+}
+
+/**
+ * @brief HTTP servers of the miner
+ *
+ * @author GerrFrog
+ */
+namespace Server
+{
+    /**
+     * @brief HTTP API with statistics and control of the solver
+     *
+     * @note GET /stats, GET /metrics (OpenMetrics), POST /pause, 
+     * POST /resume, POST /threads {"threads": N}
+     * @note Requests and hashrate sampling run on one strand of the
+     * network runtime, workers are only read through atomic counters
+     *
+     * @author GerrFrog
+     */
+    class Control_Server
+    {
+        private:
+            /**
+             * @brief Solver
+             *
+             * @author GerrFrog
+             */
+            Solvers::Solver &solver;
+
+            /**
+             * @brief Strand on shared io_context. Connections of server
+             * are accepted on it, so requests and samples never run
+             * concurrently
+             *
+             * @author GerrFrog
+             */
+            net::strand<net::io_context::executor_type> strand;
+
+            /**
+             * @brief Acceptor of connections
+             *
+             * @author GerrFrog
+             */
+            tcp::acceptor acceptor;
+
+            /**
+             * @brief Timer for hashrate samples
+             *
+             * @author GerrFrog
+             */
+            net::steady_timer timer;
+
+            /**
+             * @brief Hashrate over windows
+             *
+             * @author GerrFrog
+             */
+            Statistics::Hashrate_Meter meter;
+
+            /**
+             * @brief Time of start
+             *
+             * @author GerrFrog
+             */
+            std::chrono::steady_clock::time_point started;
+
+            /**
+             * @brief Windows of reported hashrate
+             *
+             * @author GerrFrog
+             */
+            const std::vector<std::pair<string, std::chrono::seconds>> windows = {
+                {"10s", std::chrono::seconds(10)},
+                {"60s", std::chrono::seconds(60)},
+                {"15m", std::chrono::minutes(15)}
+            };
+
+            /**
+             * @brief Accept next connection
+             *
+             * @author GerrFrog
+             */
+            void accept()
+            {
+                this->acceptor.async_accept(
+                    [this](beast::error_code err, tcp::socket socket) {
+                        if (!err)
+                            std::make_shared<Implementors::Session>(
+                                std::move(socket),
+                                [this](const Implementors::Request &request) {
+                                    return this->handle(request);
+                                }
+                            )->run();
+
+                        if (this->acceptor.is_open())
+                            this->accept();
+                    }
+                );
+            }
+
+            /**
+             * @brief Sample counters every second
+             *
+             * @author GerrFrog
+             */
+            void sample()
+            {
+                this->meter.sample(this->solver.get_hashes());
+
+                this->timer.expires_after(std::chrono::seconds(1));
+                this->timer.async_wait([this](beast::error_code err) {
+                    if (!err)
+                        this->sample();
+                });
+            }
+
+            /**
+             * @brief Create JSON response
+             *
+             * @author GerrFrog
+             *
+             * @param request Request
+             * @param status HTTP status
+             * @param body JSON body
+             * @return Implementors::Response
+             */
+            Implementors::Response reply(
+                const Implementors::Request &request,
+                http::status status,
+                const nlohmann::json &body
+            )
+            {
+                Implementors::Response response(status, request.version());
+
+                response.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+                response.set(http::field::content_type, "application/json");
+                response.body() = body.dump();
+
+                return response;
+            }
+
+            /**
+             * @brief Handle request
+             *
+             * @author GerrFrog
+             *
+             * @param request Request
+             * @return Implementors::Response
+             */
+            Implementors::Response handle(const Implementors::Request &request)
+            {
+                string target(request.target());
+
+                if (request.method() == http::verb::get && target == "/stats")
+                    return this->reply(request, http::status::ok, this->stats());
+
+                if (request.method() == http::verb::get && target == "/metrics")
+                {
+                    Implementors::Response response(http::status::ok, request.version());
+
+                    response.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+                    response.set(
+                        http::field::content_type,
+                        "application/openmetrics-text; version=1.0.0; charset=utf-8"
+                    );
+                    response.body() = this->metrics();
+
+                    return response;
+                }
+
+                if (request.method() == http::verb::post && target == "/pause")
+                {
+                    this->solver.pause();
+                    return this->reply(request, http::status::ok, {{"paused", true}});
+                }
+
+                if (request.method() == http::verb::post && target == "/resume")
+                {
+                    this->solver.resume();
+                    return this->reply(request, http::status::ok, {{"paused", false}});
+                }
+
+                if (request.method() == http::verb::post && target == "/threads")
+                {
+                    nlohmann::json body = nlohmann::json::parse(request.body(), nullptr, false);
+
+                    if (
+                        body.is_discarded() ||
+                        !body.contains("threads") ||
+                        !body["threads"].is_number_unsigned()
+                    )
+                        return this->reply(
+                            request,
+                            http::status::bad_request,
+                            {{"error", "expected {\"threads\": N}"}}
+                        );
+
+                    this->solver.set_threads(body["threads"].get<size_t>());
+
+                    return this->reply(
+                        request,
+                        http::status::ok,
+                        {{"threads", this->solver.get_threads()}}
+                    );
+                }
+
+                return this->reply(request, http::status::not_found, {{"error", "not found"}});
+            }
+
+            /**
+             * @brief Average hardware events per hash
+             *
+             * @author GerrFrog
+             *
+             * @param totals Counts of hashes and events
+             * @return nlohmann::json Null for events that are not counted
+             */
+            nlohmann::json per_hash(const Statistics::Perf_Counters::Totals &totals)
+            {
+                const Statistics::Perf_Counters &counters = this->solver.get_perf_counters();
+                nlohmann::json averages = {{"hashes", totals.hashes}};
+
+                for (size_t i = 0; i < totals.events.size(); i++)
+                    if (counters.has(i) && totals.hashes != 0)
+                        averages[Statistics::Perf_Counters::event_names[i]] = (double)totals.events[i] / totals.hashes;
+                    else
+                        averages[Statistics::Perf_Counters::event_names[i]] = nullptr;
+
+                size_t cycles = (size_t)Statistics::Perf_Event::Cycles;
+                size_t instructions = (size_t)Statistics::Perf_Event::Instructions;
+
+                if (counters.has(instructions) && totals.events[cycles] != 0)
+                    averages["ipc"] = (double)totals.events[instructions] / totals.events[cycles];
+                else
+                    averages["ipc"] = nullptr;
+
+                return averages;
+            }
+
+            /**
+             * @brief Collect hardware counters
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json Null if counters are disabled
+             */
+            nlohmann::json perf()
+            {
+                const Statistics::Perf_Counters &counters = this->solver.get_perf_counters();
+
+                if (!counters.is_enabled())
+                    return nullptr;
+
+                nlohmann::json threads = nlohmann::json::array();
+
+                for (size_t i = 0; i < counters.size(); i++)
+                    threads.push_back(this->per_hash(counters.get(i)));
+
+                return {
+                    {"available", counters.is_available()},
+                    {"per_hash", this->per_hash(counters.get())},
+                    {"threads", threads}
+                };
+            }
+
+            /**
+             * @brief Collect statistics
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json
+             */
+            nlohmann::json stats()
+            {
+                nlohmann::json hashrate = {
+                    {"total", nlohmann::json::object()},
+                    {"threads", nlohmann::json::array()}
+                };
+
+                for (auto &window : this->windows)
+                    hashrate["total"][window.first] = this->meter.hashrate(window.second);
+
+                for (size_t i = 0; i < this->solver.get_max_threads(); i++)
+                {
+                    nlohmann::json thread;
+
+                    for (auto &window : this->windows)
+                        thread[window.first] = this->meter.hashrate(window.second, i);
+                    hashrate["threads"].push_back(thread);
+                }
+
+                Statistics::Latency_Window &latency = this->solver.get_submit_latency();
+                std::vector<double> percentiles = latency.percentiles({0.5, 0.9, 0.99});
+
+                nlohmann::json pipeline;
+
+                for (size_t i = 0; i < Statistics::Pipeline_Latency::stage_count; i++)
+                {
+                    auto summary = this->solver.get_latency().summary((Statistics::Stage)i);
+
+                    pipeline[Statistics::Pipeline_Latency::stage_names[i]] = {
+                        {"count", summary.count},
+                        {"p50", summary.p50},
+                        {"p99", summary.p99},
+                        {"p999", summary.p999}
+                    };
+                }
+
+                nlohmann::json pools = nlohmann::json::array();
+                nlohmann::json shares = {{"accepted", 0}, {"rejected", 0}, {"stale", 0}};
+
+                for (size_t i = 0; i < this->solver.get_pools(); i++)
+                {
+                    Statistics::Share_Counter &counter = this->solver.get_shares(i);
+                    nlohmann::json job = nullptr;
+                    auto current = this->solver.get_job(i);
+
+                    if (current)
+                        job = {
+                            {"job_id", current->job_id},
+                            {"height", current->height},
+                            {"target", current->target},
+                            {"seed_hash", Utilities::HEX_String(current->context->seed_hash).get_encoded()}
+                        };
+
+                    pools.push_back({
+                        {"name", this->solver.get_pool_name(i)},
+                        {"weight", this->solver.get_weight(i)},
+                        {"hashes", this->solver.get_pool_hashes(i)},
+                        {"shares", {
+                            {"accepted", counter.get_accepted()},
+                            {"rejected", counter.get_rejected()},
+                            {"stale", counter.get_stale()}
+                        }},
+                        {"reconnects", this->solver.get_reconnects(i)},
+                        {"job", job}
+                    });
+
+                    shares["accepted"] = shares["accepted"].get<uint64_t>() + counter.get_accepted();
+                    shares["rejected"] = shares["rejected"].get<uint64_t>() + counter.get_rejected();
+                    shares["stale"] = shares["stale"].get<uint64_t>() + counter.get_stale();
+                }
+
+                return {
+                    {"uptime", std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::steady_clock::now() - this->started
+                    ).count()},
+                    {"paused", this->solver.is_paused()},
+                    {"threads", {
+                        {"active", this->solver.get_threads()},
+                        {"max", this->solver.get_max_threads()},
+                        {"parked", this->solver.get_parked()},
+                        {"affinity", this->solver.get_affinity()}
+                    }},
+                    {"hashrate", hashrate},
+                    {"shares", shares},
+                    {"job", pools[0]["job"]},
+                    {"pools", pools},
+                    {"dataset", {
+                        {"mode", this->solver.is_full_memory() ? "full" : "light"},
+                        {"huge_pages", this->solver.has_huge_pages()}
+                    }},
+                    {"submit_latency_ms", {
+                        {"p50", percentiles[0]},
+                        {"p90", percentiles[1]},
+                        {"p99", percentiles[2]},
+                        {"count", latency.size()}
+                    }},
+                    {"latency_ms", pipeline},
+                    {"perf", this->perf()}
+                };
+            }
+
+            /**
+             * @brief Write histogram in OpenMetrics format
+             *
+             * @author GerrFrog
+             *
+             * @param output Output stream
+             * @param name Metric name
+             * @param help Description
+             * @param histogram Histogram
+             */
+            static void write_histogram(
+                std::ostringstream &output,
+                const string &name,
+                const string &help,
+                const Statistics::Histogram &histogram
+            )
+            {
+                const std::vector<double> &bounds = histogram.get_bounds();
+
+                output
+                    << "# TYPE " << name << " histogram\n"
+                    << "# UNIT " << name << " seconds\n"
+                    << "# HELP " << name << " " << help << "\n";
+
+                for (size_t i = 0; i < bounds.size(); i++)
+                    output 
+                        << name << "_bucket{le=\"" << bounds[i] << "\"} " 
+                        << histogram.get_cumulative(i) << "\n";
+
+                output
+                    << name << "_bucket{le=\"+Inf\"} " << histogram.get_cumulative(bounds.size()) << "\n"
+                    << name << "_count " << histogram.get_cumulative(bounds.size()) << "\n"
+                    << name << "_sum " << histogram.get_sum() << "\n";
+            }
+
+            /**
+             * @brief Collect metrics in OpenMetrics text format. Per-thread
+             * counters are aggregated only here
+             *
+             * @author GerrFrog
+             *
+             * @return string
+             */
+            string metrics()
+            {
+                std::ostringstream output;
+                std::vector<uint64_t> hashes = this->solver.get_hashes();
+                std::vector<uint64_t> job_hashes = this->solver.get_job_hashes();
+
+                output
+                    << "# TYPE cpuminer_hashes counter\n"
+                    << "# HELP cpuminer_hashes Calculated hashes\n";
+                for (size_t i = 0; i < hashes.size(); i++)
+                    output << "cpuminer_hashes_total{thread=\"" << i << "\"} " << hashes[i] << "\n";
+
+                output
+                    << "# TYPE cpuminer_job_hashes gauge\n"
+                    << "# HELP cpuminer_job_hashes Hashes calculated on the current job\n";
+                for (size_t i = 0; i < job_hashes.size(); i++)
+                    output << "cpuminer_job_hashes{thread=\"" << i << "\"} " << job_hashes[i] << "\n";
+
+                output
+                    << "# TYPE cpuminer_jobs counter\n"
+                    << "# HELP cpuminer_jobs Jobs published to workers\n"
+                    << "cpuminer_jobs_total " << this->solver.get_jobs() << "\n";
+
+                write_histogram(
+                    output,
+                    "cpuminer_job_switch_seconds",
+                    "Time from job received to job published to workers",
+                    this->solver.get_job_switch()
+                );
+
+                output
+                    << "# TYPE cpuminer_dataset_init_seconds gauge\n"
+                    << "# UNIT cpuminer_dataset_init_seconds seconds\n"
+                    << "# HELP cpuminer_dataset_init_seconds Duration of the last cache and dataset initialization\n"
+                    << "cpuminer_dataset_init_seconds " << this->solver.get_dataset_init() << "\n";
+
+                output
+                    << "# TYPE cpuminer_pool_hashes counter\n"
+                    << "# HELP cpuminer_pool_hashes Calculated hashes by pool\n";
+                for (size_t i = 0; i < this->solver.get_pools(); i++)
+                    output 
+                        << "cpuminer_pool_hashes_total{pool=\"" << Implementors::escape_label(this->solver.get_pool_name(i)) << "\"} " 
+                        << this->solver.get_pool_hashes(i) << "\n";
+
+                output
+                    << "# TYPE cpuminer_shares counter\n"
+                    << "# HELP cpuminer_shares Submitted shares by pool response\n";
+                for (size_t i = 0; i < this->solver.get_pools(); i++)
+                {
+                    Statistics::Share_Counter &shares = this->solver.get_shares(i);
+                    string pool = Implementors::escape_label(this->solver.get_pool_name(i));
+
+                    output
+                        << "cpuminer_shares_total{pool=\"" << pool << "\",result=\"accepted\"} " << shares.get_accepted() << "\n"
+                        << "cpuminer_shares_total{pool=\"" << pool << "\",result=\"rejected\"} " << shares.get_rejected() << "\n"
+                        << "cpuminer_shares_total{pool=\"" << pool << "\",result=\"stale\"} " << shares.get_stale() << "\n";
+                }
+
+                write_histogram(
+                    output,
+                    "cpuminer_share_rtt_seconds",
+                    "Time from share submit to pool response",
+                    this->solver.get_share_rtt()
+                );
+
+                output
+                    << "# TYPE cpuminer_pool_reconnects counter\n"
+                    << "# HELP cpuminer_pool_reconnects Reconnections to pool\n";
+                for (size_t i = 0; i < this->solver.get_pools(); i++)
+                    output 
+                        << "cpuminer_pool_reconnects_total{pool=\"" << Implementors::escape_label(this->solver.get_pool_name(i)) << "\"} " 
+                        << this->solver.get_reconnects(i) << "\n";
+
+                output
+                    << "# TYPE cpuminer_threads gauge\n"
+                    << "# HELP cpuminer_threads Running worker threads\n"
+                    << "cpuminer_threads " << this->solver.get_threads() << "\n"
+                    << "# TYPE cpuminer_parked_threads gauge\n"
+                    << "# HELP cpuminer_parked_threads Workers parked by load governor\n"
+                    << "cpuminer_parked_threads " << this->solver.get_parked() << "\n"
+                    << "# TYPE cpuminer_paused gauge\n"
+                    << "# HELP cpuminer_paused Hashing is paused\n"
+                    << "cpuminer_paused " << this->solver.is_paused() << "\n";
+
+                const Statistics::Perf_Counters &counters = this->solver.get_perf_counters();
+
+                if (counters.is_available())
+                {
+                    output
+                        << "# TYPE cpuminer_perf_hashes counter\n"
+                        << "# HELP cpuminer_perf_hashes Hashes covered by hardware counters\n";
+                    for (size_t i = 0; i < counters.size(); i++)
+                        output << "cpuminer_perf_hashes_total{thread=\"" << i << "\"} " << counters.get(i).hashes << "\n";
+
+                    output
+                        << "# TYPE cpuminer_perf_events counter\n"
+                        << "# HELP cpuminer_perf_events Hardware events of workers\n";
+                    for (size_t i = 0; i < counters.size(); i++)
+                    {
+                        Statistics::Perf_Counters::Totals totals = counters.get(i);
+
+                        for (size_t event = 0; event < totals.events.size(); event++)
+                            if (counters.has(event))
+                                output 
+                                    << "cpuminer_perf_events_total{event=\"" 
+                                    << Statistics::Perf_Counters::event_names[event] 
+                                    << "\",thread=\"" << i << "\"} " << totals.events[event] << "\n";
+                    }
+                }
+
+                output << "# EOF\n";
+
+                return output.str();
+            }
+
+        public:
+            /**
+             * @brief Construct a new Control_Server object
+             *
+             * @author GerrFrog
+             *
+             * @param io_context Shared io_context (must be stopped
+             * before the server is destroyed)
+             * @param config Server configuration (host, port)
+             * @param solver Solver
+             */
+            Control_Server(
+                net::io_context &io_context,
+                nlohmann::json &config,
+                Solvers::Solver &solver
+            ) : solver(solver),
+                strand(net::make_strand(io_context)),
+                acceptor(strand),
+                timer(strand),
+                started(std::chrono::steady_clock::now())
+            {
+                tcp::endpoint endpoint(
+                    net::ip::make_address((string)config["host"]),
+                    (unsigned short)config["port"]
+                );
+
+                this->acceptor.open(endpoint.protocol());
+                this->acceptor.set_option(net::socket_base::reuse_address(true));
+                this->acceptor.bind(endpoint);
+                this->acceptor.listen(net::socket_base::max_listen_connections);
+
+                net::post(this->strand, [this]() {
+                    this->accept();
+                    this->sample();
+                });
+            }
+
+            /**
+             * @brief Destroy the Control_Server object
+             *
+             * @author GerrFrog
+             */
+            ~Control_Server() = default;
+    };
+}
+
+
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
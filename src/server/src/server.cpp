@@ -0,0 +1 @@
+#include "../inc/server.hpp"
\ No newline at end of file
@@ -4,46 +4,2446 @@
 #define SOLVERS_HEADER
 
 #include <randomx.h>
+#include <common.hpp>
+#include <nlohmann/json.hpp>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <list>
+#include <map>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <cmath>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../../exceptions/inc/exceptions.hpp"
 #include "../../utilities/inc/utilities.hpp"
+#include "../../statistics/inc/statistics.hpp"
 #include "../../hashes/inc/hashes.hpp"
+#include "../../logger/inc/logger.hpp"
+
+using std::cout;
+using std::endl;
+using std::string;
 
 /**
- * @brief Solvers for algorithm
+ * @brief Implementators for Solver object
  * 
  * @author GerrFrog
  */
-namespace Solvers
+namespace Solvers::Implementors
 {
     /**
-     * @brief Abstract class for solver object
+     * @brief LRU storage of initialized RandomX caches keyed by seed hash
+     * 
+     * @note Every entry keeps Argon2 memory, superscalar programs, 
+     * reciprocals and JIT dataset init code, so switching back to a
+     * recent seed skips randomx_init_cache completely
      * 
      * @author GerrFrog
      */
-    class Solver
+    class Cache_Storage
     {
-        // TODO: Implement solver for algorithm
         private:
+            /**
+             * @brief Cached seed with its initialized cache
+             * 
+             * @author GerrFrog
+             */
+            struct Entry
+            {
+                /**
+                 * @brief Seed hash
+                 * 
+                 * @author GerrFrog
+                 */
+                binary seed_hash;
+
+                /**
+                 * @brief Initialized cache
+                 * 
+                 * @author GerrFrog
+                 */
+                std::shared_ptr<randomx_cache> cache;
+            };
+
+            /**
+             * @brief Entries ordered from most to least recently used
+             * 
+             * @author GerrFrog
+             */
+            std::list<Entry> entries;
+
+            /**
+             * @brief Index of entries by seed hash
+             * 
+             * @author GerrFrog
+             */
+            std::map<binary, std::list<Entry>::iterator> index;
+
+            /**
+             * @brief Caches being filled by seed hash, concurrent misses
+             * of the same seed wait for one fill
+             * 
+             * @author GerrFrog
+             */
+            std::map<binary, std::shared_future<std::shared_ptr<randomx_cache>>> filling;
+
+            /**
+             * @brief Guard for entries and index
+             * 
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+            /**
+             * @brief Flags for allocating caches
+             * 
+             * @author GerrFrog
+             */
+            randomx_flags flags;
+
+            /**
+             * @brief Memory budget in bytes
+             * 
+             * @author GerrFrog
+             */
+            size_t memory_budget;
+
+            /**
+             * @brief Drop least recently used entries over the budget.
+             * At least one entry is always kept
+             * 
+             * @author GerrFrog
+             */
+            void evict()
+            {
+                while (
+                    this->entries.size() > 1 &&
+                    this->entries.size() * cache_memory > this->memory_budget
+                )
+                {
+                    this->index.erase(this->entries.back().seed_hash);
+                    this->entries.pop_back();
+                }
+            }
+
+            /**
+             * @brief Allocate and initialize cache for seed
+             * 
+             * @author GerrFrog
+             * 
+             * @param seed_hash Seed hash
+             * @return std::shared_ptr<randomx_cache> Initialized cache
+             */
+            std::shared_ptr<randomx_cache> create(const binary &seed_hash)
+            {
+                randomx_cache *cache = randomx_alloc_cache(this->flags);
 
-        protected:
+                // Huge pages may run out after the first cache
+                if (cache == nullptr && (this->flags & RANDOMX_FLAG_LARGE_PAGES))
+                    cache = randomx_alloc_cache(
+                        (randomx_flags)(this->flags & ~RANDOMX_FLAG_LARGE_PAGES)
+                    );
+                if (cache == nullptr)
+                    throw Exceptions::Solvers::RandomX_Error(
+                        "Cannot allocate RandomX cache"
+                    );
+
+                randomx_init_cache(cache, seed_hash.data(), seed_hash.size());
+
+                return std::shared_ptr<randomx_cache>(cache, randomx_release_cache);
+            }
 
         public:
             /**
-             * @brief Construct a new Solver object
+             * @brief Memory of one cache in bytes
              * 
              * @author GerrFrog
              */
-            Solver() = default;
+            static constexpr size_t cache_memory = (size_t)RANDOMX_ARGON_MEMORY * randomx::ArgonBlockSize;
 
             /**
-             * @brief Destroy the Solver object
+             * @brief Construct a new Cache_Storage object
+             * 
+             * @author GerrFrog
+             * 
+             * @param flags Flags for allocating caches
+             * @param memory_budget Memory budget in bytes
+             */
+            Cache_Storage(
+                randomx_flags flags,
+                size_t memory_budget = 4 * cache_memory
+            ) : flags(flags),
+                memory_budget(memory_budget)
+            { }
+
+            /**
+             * @brief Destroy the Cache_Storage object
+             * 
+             * @author GerrFrog
+             */
+            ~Cache_Storage() = default;
+
+            /**
+             * @brief Get initialized cache for seed. Evicted caches 
+             * stay alive while someone holds a pointer to them. Misses of
+             * a seed being filled wait for that fill
+             * 
+             * @author GerrFrog
+             * 
+             * @param seed_hash Seed hash
+             * @return std::shared_ptr<randomx_cache> Initialized cache
+             */
+            std::shared_ptr<randomx_cache> get(const binary &seed_hash)
+            {
+                std::promise<std::shared_ptr<randomx_cache>> filled;
+                std::shared_future<std::shared_ptr<randomx_cache>> fill;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+
+                    auto found = this->index.find(seed_hash);
+
+                    if (found != this->index.end())
+                    {
+                        this->entries.splice(
+                            this->entries.begin(), 
+                            this->entries, 
+                            found->second
+                        );
+                        return found->second->cache;
+                    }
+
+                    auto pending = this->filling.find(seed_hash);
+
+                    if (pending != this->filling.end())
+                        fill = pending->second;
+                    else
+                        this->filling[seed_hash] = filled.get_future().share();
+                }
+
+                if (fill.valid())
+                    return fill.get();
+
+                // Argon2 fill takes long, do not block hits for other seeds
+                std::shared_ptr<randomx_cache> cache;
+
+                try {
+                    cache = this->create(seed_hash);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+
+                    this->filling.erase(seed_hash);
+                    filled.set_exception(std::current_exception());
+                    throw;
+                }
+
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                this->filling.erase(seed_hash);
+                this->entries.push_front({seed_hash, cache});
+                this->index[seed_hash] = this->entries.begin();
+                this->evict();
+                filled.set_value(cache);
+
+                return cache;
+            }
+
+            /**
+             * @brief Check if cache for seed is stored
+             * 
+             * @author GerrFrog
+             * 
+             * @param seed_hash Seed hash
+             * @return bool
+             */
+            bool contains(const binary &seed_hash)
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                return this->index.count(seed_hash) != 0;
+            }
+
+            /**
+             * @brief Set the memory budget
+             * 
+             * @author GerrFrog
+             * 
+             * @param memory_budget Memory budget in bytes
+             */
+            void set_memory_budget(size_t memory_budget)
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                this->memory_budget = memory_budget;
+                this->evict();
+            }
+
+            /**
+             * @brief Get number of stored caches
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t size()
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                return this->entries.size();
+            }
+
+            /**
+             * @brief Get the flags
              * 
              * @author GerrFrog
+             * 
+             * @return randomx_flags 
              */
-            ~Solver() = default;
+            randomx_flags get_flags() { return this->flags; }
+    };
+
+    /**
+     * @brief Memory prepared for one seed hash
+     * 
+     * @author GerrFrog
+     */
+    struct Seed_Context
+    {
+        /**
+         * @brief Seed hash
+         * 
+         * @author GerrFrog
+         */
+        binary seed_hash;
+
+        /**
+         * @brief Initialized cache
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<randomx_cache> cache;
+
+        /**
+         * @brief Initialized dataset (empty in light mode)
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<randomx_dataset> dataset;
+    };
+
+    /**
+     * @brief Job prepared for hashing
+     * 
+     * @author GerrFrog
+     */
+    struct Job
+    {
+        /**
+         * @brief Job ID
+         * 
+         * @author GerrFrog
+         */
+        string job_id;
+
+        /**
+         * @brief Hashing blob
+         * 
+         * @author GerrFrog
+         */
+        binary blob;
+
+        /**
+         * @brief Target as sent by pool
+         * 
+         * @author GerrFrog
+         */
+        string target;
+
+        /**
+         * @brief Upper bound of the last 8 bytes of a valid hash
+         * 
+         * @author GerrFrog
+         */
+        uint64_t target_value;
+
+        /**
+         * @brief Height
+         * 
+         * @author GerrFrog
+         */
+        unsigned long long height;
+
+        /**
+         * @brief Memory for the seed hash of the job
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<const Seed_Context> context;
+
+        /**
+         * @brief Time when job bytes were received from pool
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point received;
+
+        /**
+         * @brief Time when job was published to workers
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point published;
+    };
+
+    /**
+     * @brief Found share ready for submitting
+     * 
+     * @author GerrFrog
+     */
+    struct Share
+    {
+        /**
+         * @brief Job ID
+         * 
+         * @author GerrFrog
+         */
+        string job_id;
+
+        /**
+         * @brief Nonce in HEX
+         * 
+         * @author GerrFrog
+         */
+        string nonce;
+
+        /**
+         * @brief Hash in HEX
+         * 
+         * @author GerrFrog
+         */
+        string result;
+
+        /**
+         * @brief Time when share was found
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point found;
+    };
+
+    /**
+     * @brief Pool which gets a share of hashrate by weight. Jobs of all
+     * pools are held at once, so workers switch without waiting for 
+     * dispatcher
+     * 
+     * @author GerrFrog
+     */
+    struct Pool_Slot
+    {
+        /**
+         * @brief Name of pool (for statistics)
+         * 
+         * @author GerrFrog
+         */
+        string name;
+
+        /**
+         * @brief Weight of pool in hashrate
+         * 
+         * @author GerrFrog
+         */
+        std::atomic<double> weight{1};
+
+        /**
+         * @brief Current job (accessed with std::atomic_load/store). 
+         * Empty while dataset of new seed replaces the old one
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<const Job> job;
+
+        /**
+         * @brief Incremented after every published or withdrawn job 
+         * of pool
+         * 
+         * @author GerrFrog
+         */
+        std::atomic<uint64_t> sequence{0};
+
+        /**
+         * @brief Pool has job for workers
+         * 
+         * @author GerrFrog
+         */
+        std::atomic<bool> ready{false};
+
+        /**
+         * @brief Latest job from pool waiting for dispatcher (guarded 
+         * by mutex of solver)
+         * 
+         * @author GerrFrog
+         */
+        std::optional<Utilities::Pools::New_Job_V1> pending_job;
+
+        /**
+         * @brief Time when pending job was received
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point pending_time;
+
+        /**
+         * @brief Time when pending job bytes were received
+         * 
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point pending_received;
+
+        /**
+         * @brief Callback for found shares
+         * 
+         * @author GerrFrog
+         */
+        std::function<void(const Share&)> submit_handler;
+
+        /**
+         * @brief Results of submitted shares
+         * 
+         * @author GerrFrog
+         */
+        Statistics::Share_Counter shares;
+
+        /**
+         * @brief Number of reconnections to pool
+         * 
+         * @author GerrFrog
+         */
+        std::atomic<uint64_t> reconnects{0};
+    };
+
+    /**
+     * @brief Job of one pool as seen by a worker. Kept for every pool,
+     * so a worker returning to pool continues its nonces
+     * 
+     * @author GerrFrog
+     */
+    struct Worker_Job
+    {
+        /**
+         * @brief Sequence of pool when job was taken
+         * 
+         * @author GerrFrog
+         */
+        uint64_t sequence = 0;
+
+        /**
+         * @brief Job
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<const Job> job;
+
+        /**
+         * @brief Hashing blob with nonce
+         * 
+         * @author GerrFrog
+         */
+        binary blob;
+
+        /**
+         * @brief Next nonce
+         * 
+         * @author GerrFrog
+         */
+        uint32_t nonce = 0;
+
+        /**
+         * @brief Virtual machine for memory of job (owned by worker)
+         * 
+         * @author GerrFrog
+         */
+        randomx_vm *vm = nullptr;
+    };
+
+    /**
+     * @brief Hash started on VM of worker, its result comes with the
+     * start of next hash on the same VM
+     * 
+     * @author GerrFrog
+     */
+    struct Pending_Hash
+    {
+        /**
+         * @brief Pool of job
+         * 
+         * @author GerrFrog
+         */
+        size_t pool = 0;
+
+        /**
+         * @brief Job
+         * 
+         * @author GerrFrog
+         */
+        std::shared_ptr<const Job> job;
+
+        /**
+         * @brief Nonce in blob
+         * 
+         * @author GerrFrog
+         */
+        uint32_t nonce = 0;
+
+        /**
+         * @brief VM hashing the blob (nullptr if nothing is started)
+         * 
+         * @author GerrFrog
+         */
+        randomx_vm *vm = nullptr;
+
+        /**
+         * @brief First hash of job on worker
+         * 
+         * @author GerrFrog
+         */
+        bool first = false;
+    };
+
+    /**
+     * @brief Job for benchmarks and tuning. Zero target: nothing is
+     * ever submitted
+     * 
+     * @author GerrFrog
+     * 
+     * @param job_id Job ID
+     * @param seed_hash Seed hash (32 bytes)
+     * @return Utilities::Pools::New_Job_V1 
+     */
+    inline Utilities::Pools::New_Job_V1 synthetic_job(const string &job_id, const binary &seed_hash)
+    {
+        Utilities::Pools::New_Job_V1 job;
+
+        job.job_id = job_id;
+        job.blob = Utilities::HEX_String(binary(76, 0));
+        job.target = "00000000";
+        job.seed_hash = Utilities::HEX_String(seed_hash);
+        job.height = 0;
+
+        return job;
+    }
+
+    /**
+     * @brief Scheduling of hashing and dataset threads on shared hosts
+     * 
+     * @author GerrFrog
+     */
+    struct Background
+    {
+        /**
+         * @brief Background mode is enabled
+         * 
+         * @author GerrFrog
+         */
+        bool enabled = false;
+
+        /**
+         * @brief Use SCHED_IDLE, otherwise only nice level
+         * 
+         * @author GerrFrog
+         */
+        bool idle = true;
+
+        /**
+         * @brief Nice level of threads
+         * 
+         * @author GerrFrog
+         */
+        int nice = 19;
+
+        /**
+         * @brief Use idle I/O priority class (swapping of huge dataset)
+         * 
+         * @author GerrFrog
+         */
+        bool io_idle = true;
+
+        /**
+         * @brief Dataset init threads (0 for all CPUs)
+         * 
+         * @author GerrFrog
+         */
+        size_t init_threads = 1;
+
+        /**
+         * @brief Share of time dataset init threads run, in (0, 1]
+         * 
+         * @author GerrFrog
+         */
+        double init_duty = 1;
     };
+
+    /**
+     * @brief Lower priority of calling thread. Priority of other threads
+     * (network) is not changed
+     * 
+     * @author GerrFrog
+     * 
+     * @param background Background mode
+     * @return true Priority is lowered
+     * @return false Mode is disabled or not supported
+     */
+    inline bool set_background_priority(const Background &background)
+    {
+        if (!background.enabled)
+            return false;
+#ifdef __linux__
+        // ioprio_set(2) has no glibc wrapper
+        constexpr int io_who_process = 1, io_class_idle = 3, io_class_shift = 13;
+        pid_t thread = (pid_t)syscall(SYS_gettid);
+        bool lowered = setpriority(PRIO_PROCESS, thread, background.nice) == 0;
+
+        if (background.idle)
+        {
+            sched_param param{};
+
+            lowered = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0 && lowered;
+        }
+        if (background.io_idle)
+            lowered = syscall(SYS_ioprio_set, io_who_process, thread, io_class_idle << io_class_shift) == 0 && lowered;
+
+        return lowered;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Pin calling thread to CPUs
+     * 
+     * @author GerrFrog
+     * 
+     * @param cpus Allowed CPUs (empty does nothing)
+     * @return true Thread is pinned
+     * @return false CPUs are not available or pinning is not supported
+     */
+    inline bool set_thread_affinity(const std::vector<unsigned> &cpus)
+    {
+        if (cpus.empty())
+            return false;
+#ifdef __linux__
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        for (unsigned cpu : cpus)
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
 }
 
+/**
+ * @brief Solvers for algorithm
+ * 
+ * @author GerrFrog
+ */
+namespace Solvers
+{
+    /**
+     * @brief RandomX solver. Worker threads hash the current job while
+     * dispatcher threads (one per pool) prepare caches and datasets for
+     * new seeds
+     * 
+     * @note Workers never take locks while hashing: the job is published
+     * through an atomic shared pointer with a sequence number and every
+     * worker counts hashes in its own cache line
+     * 
+     * @note Hashrate can be split between several pools by weights. 
+     * Workers hold jobs of all pools and switch between them without 
+     * dispatchers; pools on the same seed share memory
+     * 
+     * @author GerrFrog
+     */
+    class Solver
+    {
+        private:
+            /**
+             * @brief Offset of the 32-bit nonce in hashing blob
+             * 
+             * @author GerrFrog
+             */
+            static constexpr size_t nonce_offset = 39;
+
+            /**
+             * @brief Scheduling of workers and dataset init
+             * 
+             * @author GerrFrog
+             */
+            Implementors::Background background;
+
+            /**
+             * @brief Flags for caches, datasets and virtual machines
+             * 
+             * @author GerrFrog
+             */
+            randomx_flags flags;
+
+            /**
+             * @brief Dataset mode (2080 MiB) or light mode (256 MiB)
+             * 
+             * @author GerrFrog
+             */
+            bool full_memory;
+
+            /**
+             * @brief Memory is allocated in huge pages
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<bool> huge_pages;
+
+            /**
+             * @brief Initialized caches
+             * 
+             * @author GerrFrog
+             */
+            Implementors::Cache_Storage caches;
+
+            /**
+             * @brief Maximum number of worker threads
+             * 
+             * @author GerrFrog
+             */
+            size_t max_threads;
+
+            /**
+             * @brief Hash counters of every worker
+             * 
+             * @author GerrFrog
+             */
+            std::vector<Statistics::Implementors::Thread_Counter> counters;
+
+            /**
+             * @brief Hashes of every worker on the current job
+             * 
+             * @author GerrFrog
+             */
+            std::vector<Statistics::Implementors::Thread_Counter> job_counters;
+
+            /**
+             * @brief Worker threads (by index)
+             * 
+             * @author GerrFrog
+             */
+            std::vector<std::thread> workers;
+
+            /**
+             * @brief Number of running workers. Workers with greater 
+             * index exit
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<size_t> threads{0};
+
+            /**
+             * @brief Hashing is paused
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<bool> paused{false};
+
+            /**
+             * @brief Workers with this or greater index are parked: they
+             * sleep but keep their VMs
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<size_t> unparked{SIZE_MAX};
+
+            /**
+             * @brief Solver is running
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<bool> running{true};
+
+            /**
+             * @brief Maximum number of pools
+             * 
+             * @author GerrFrog
+             */
+            static constexpr size_t max_pools = 8;
+
+            /**
+             * @brief Pools sharing hashrate (pool 0 is the primary one)
+             * 
+             * @author GerrFrog
+             */
+            std::array<Implementors::Pool_Slot, max_pools> pools;
+
+            /**
+             * @brief Number of pools
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<size_t> pool_count{1};
+
+            /**
+             * @brief Hashes of every worker for every pool (worker index
+             * * max_pools + pool)
+             * 
+             * @author GerrFrog
+             */
+            std::vector<Statistics::Implementors::Thread_Counter> pool_counters;
+
+            /**
+             * @brief Pools are time-sliced (otherwise workers are 
+             * partitioned between pools)
+             * 
+             * @author GerrFrog
+             */
+            bool split_time = true;
+
+            /**
+             * @brief Period of time slicing in seconds
+             * 
+             * @author GerrFrog
+             */
+            double split_period = 10;
+
+            /**
+             * @brief Pools other than primary use light VMs when their 
+             * seed differs (instead of second dataset)
+             * 
+             * @author GerrFrog
+             */
+            bool light_secondary = false;
+
+            /**
+             * @brief Incremented after every published job of any pool
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> job_sequence{0};
+
+            /**
+             * @brief Guard for pending jobs and sleeping threads
+             * 
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+            /**
+             * @brief Wakes up dispatcher and idle workers
+             * 
+             * @author GerrFrog
+             */
+            std::condition_variable wakeup;
+
+            /**
+             * @brief Guard for starting and stopping workers
+             * 
+             * @author GerrFrog
+             */
+            std::mutex control_mutex;
+
+            /**
+             * @brief CPUs of workers, worker i runs on affinity[i % size]
+             * (empty if workers are not pinned). Guarded by control_mutex
+             * 
+             * @author GerrFrog
+             */
+            std::vector<unsigned> affinity;
+
+            /**
+             * @brief Dispatcher threads by pool, dataset of one pool does
+             * not delay jobs of other pools
+             * 
+             * @author GerrFrog
+             */
+            std::array<std::thread, max_pools> dispatchers;
+
+            /**
+             * @brief Guard for contexts and preparing
+             * 
+             * @author GerrFrog
+             */
+            std::mutex prepare_mutex;
+
+            /**
+             * @brief Prepared seed memory while anyone uses it
+             * 
+             * @author GerrFrog
+             */
+            std::vector<std::weak_ptr<const Implementors::Seed_Context>> contexts;
+
+            /**
+             * @brief Seed memory being prepared by seed hash and dataset
+             * mode, dispatchers of other pools wait for it
+             * 
+             * @author GerrFrog
+             */
+            std::map<
+                std::pair<binary, bool>, 
+                std::shared_future<std::shared_ptr<const Implementors::Seed_Context>>
+            > preparing;
+
+            /**
+             * @brief Latency between submit and pool response
+             * 
+             * @author GerrFrog
+             */
+            Statistics::Latency_Window submit_latency;
+
+            /**
+             * @brief Time between share submit and pool response
+             * 
+             * @author GerrFrog
+             */
+            Statistics::Histogram share_rtt{{
+                0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+            }};
+
+            /**
+             * @brief Time between job from pool and job published for
+             * workers (includes seed preparation)
+             * 
+             * @author GerrFrog
+             */
+            Statistics::Histogram job_switch{{
+                0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30
+            }};
+
+            /**
+             * @brief Number of published jobs
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> jobs{0};
+
+            /**
+             * @brief Duration of the last seed preparation (cache and 
+             * dataset) in microseconds
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> dataset_init{0};
+
+            /**
+             * @brief Latency of pipeline stages. Slots: workers by index,
+             * then network threads, then dispatchers
+             * 
+             * @author GerrFrog
+             */
+            Statistics::Pipeline_Latency latency;
+
+            /**
+             * @brief Hardware counters of workers (no slots if disabled)
+             * 
+             * @author GerrFrog
+             */
+            Statistics::Perf_Counters perf_counters;
+
+            /**
+             * @brief Unavailable perf events were already reported
+             * 
+             * @author GerrFrog
+             */
+            std::atomic<bool> perf_reported{false};
+
+            /**
+             * @brief Hashes between two reads of hardware counters
+             * 
+             * @author GerrFrog
+             */
+            static constexpr uint64_t perf_interval = 16;
+
+            /**
+             * @brief Parse perf export mode ("off", "map", "jitdump", "both")
+             * 
+             * @author GerrFrog
+             * 
+             * @param perf Perf export mode from configuration
+             * @return randomx_perf_mode 
+             */
+            static randomx_perf_mode select_perf(const string &perf)
+            {
+                if (perf == "map")
+                    return RANDOMX_PERF_MAP;
+                if (perf == "jitdump")
+                    return RANDOMX_PERF_JITDUMP;
+                if (perf == "both")
+                    return (randomx_perf_mode)(RANDOMX_PERF_MAP | RANDOMX_PERF_JITDUMP);
+                if (perf != "off")
+                    Logger::warning("unknown perf mode: {}", perf);
+                return RANDOMX_PERF_NONE;
+            }
+
+            /**
+             * @brief Select flags for configuration
+             * 
+             * @author GerrFrog
+             * 
+             * @param full_memory Dataset mode
+             * @param huge_pages Try to use huge pages
+             * @param perf Export JIT code regions for perf
+             * @return randomx_flags 
+             */
+            static randomx_flags select_flags(bool full_memory, bool huge_pages, randomx_perf_mode perf)
+            {
+                // Must be set before any cache or VM compiles code
+                randomx_set_perf_mode(perf);
+
+                randomx_flags flags = randomx_get_flags();
+
+                if (full_memory)
+                    flags |= RANDOMX_FLAG_FULL_MEM;
+
+                if (huge_pages)
+                {
+                    randomx_cache *cache = randomx_alloc_cache(flags | RANDOMX_FLAG_LARGE_PAGES);
+
+                    if (cache != nullptr)
+                    {
+                        randomx_release_cache(cache);
+                        flags |= RANDOMX_FLAG_LARGE_PAGES;
+                    }
+                }
+
+                return flags;
+            }
+
+            /**
+             * @brief Get value from configuration
+             * 
+             * @author GerrFrog
+             * 
+             * @tparam T Type of value
+             * @param config Solver configuration
+             * @param key Key
+             * @param default_value Value when key is absent
+             * @return T 
+             */
+            template<class T>
+            static T config_value(const nlohmann::json &config, const string &key, T default_value)
+            {
+                if (!config.is_object())
+                    return default_value;
+
+                return config.value(key, default_value);
+            }
+
+            /**
+             * @brief Read background mode from configuration
+             * 
+             * @author GerrFrog
+             * 
+             * @param config Solver configuration
+             * @return Implementors::Background 
+             */
+            static Implementors::Background select_background(const nlohmann::json &config)
+            {
+                Implementors::Background background;
+                nlohmann::json section = config_value<nlohmann::json>(config, "background", nlohmann::json::object());
+
+                background.enabled = section.value("enabled", false);
+                background.idle = section.value("policy", string("idle")) == "idle";
+                background.nice = section.value("nice", 19);
+                background.io_idle = section.value("io_idle", true);
+                background.init_threads = section.value("init_threads", (size_t)1);
+                background.init_duty = std::min(std::max(section.value("init_duty", 1.0), 0.01), 1.0);
+
+                return background;
+            }
+
+            /**
+             * @brief Initialize part of dataset. In background mode runs
+             * with lowered priority and sleeps between chunks to keep
+             * duty cycle
+             * 
+             * @author GerrFrog
+             * 
+             * @param dataset Dataset
+             * @param cache Initialized cache
+             * @param start First item
+             * @param count Number of items
+             */
+            void init_dataset(randomx_dataset *dataset, randomx_cache *cache, unsigned long start, unsigned long count)
+            {
+                constexpr unsigned long chunk = 16384;
+
+                Implementors::set_background_priority(this->background);
+
+                if (!this->background.enabled || this->background.init_duty >= 1)
+                {
+                    randomx_init_dataset(dataset, cache, start, count);
+                    return;
+                }
+
+                for (unsigned long item = start; item < start + count; item += chunk)
+                {
+                    auto started = std::chrono::steady_clock::now();
+
+                    randomx_init_dataset(dataset, cache, item, std::min(chunk, start + count - item));
+                    std::this_thread::sleep_for(
+                        (std::chrono::steady_clock::now() - started) * 
+                        ((1 - this->background.init_duty) / this->background.init_duty)
+                    );
+                }
+            }
+
+            /**
+             * @brief Allocate and initialize dataset with all threads (or
+             * background init threads)
+             * 
+             * @author GerrFrog
+             * 
+             * @param cache Initialized cache
+             * @return std::shared_ptr<randomx_dataset> 
+             */
+            std::shared_ptr<randomx_dataset> create_dataset(randomx_cache *cache)
+            {
+                randomx_dataset *dataset = randomx_alloc_dataset(this->flags);
+
+                if (dataset == nullptr && (this->flags & RANDOMX_FLAG_LARGE_PAGES))
+                {
+                    this->huge_pages.store(false);
+                    dataset = randomx_alloc_dataset(
+                        (randomx_flags)(this->flags & ~RANDOMX_FLAG_LARGE_PAGES)
+                    );
+                }
+                if (dataset == nullptr)
+                    throw Exceptions::Solvers::RandomX_Error(
+                        "Cannot allocate RandomX dataset"
+                    );
+
+                unsigned long item_count = randomx_dataset_item_count();
+                size_t thread_count = this->background.enabled && this->background.init_threads != 0 ?
+                    std::min(this->background.init_threads, this->max_threads) :
+                    this->max_threads;
+                unsigned long per_thread = item_count / thread_count;
+                std::vector<std::thread> init_threads;
+
+                for (size_t i = 0; i < thread_count; i++)
+                {
+                    unsigned long start = i * per_thread;
+                    unsigned long count = (i == thread_count - 1) ? item_count - start : per_thread;
+
+                    init_threads.emplace_back(&Solver::init_dataset, this, dataset, cache, start, count);
+                }
+                for (auto &thread : init_threads)
+                    thread.join();
+
+                return std::shared_ptr<randomx_dataset>(dataset, randomx_release_dataset);
+            }
+
+            /**
+             * @brief Prepare memory for seed hash
+             * 
+             * @author GerrFrog
+             * 
+             * @param seed_hash Seed hash
+             * @param dataset Initialize dataset (otherwise light VMs 
+             * use cache)
+             * @return std::shared_ptr<const Implementors::Seed_Context> 
+             */
+            std::shared_ptr<const Implementors::Seed_Context> prepare(const binary &seed_hash, bool dataset)
+            {
+                auto context = std::make_shared<Implementors::Seed_Context>();
+                auto started = std::chrono::steady_clock::now();
+
+                context->seed_hash = seed_hash;
+                context->cache = this->caches.get(seed_hash);
+
+                if (dataset)
+                    context->dataset = this->create_dataset(context->cache.get());
+
+                this->dataset_init.store(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - started
+                    ).count()
+                );
+
+                return context;
+            }
+
+            /**
+             * @brief Withdraw job of pool before dataset of new seed is 
+             * allocated and wait until workers release its dataset, so 
+             * two datasets do not exhaust huge pages. Dataset shared with
+             * other pool is kept
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool
+             */
+            void withdraw(size_t pool)
+            {
+                auto job = std::atomic_load(&this->pools[pool].job);
+
+                if (!job || !job->context->dataset)
+                    return;
+
+                for (size_t i = 0; i < this->pool_count.load(); i++)
+                {
+                    auto other = std::atomic_load(&this->pools[i].job);
+
+                    if (i != pool && other && other->context == job->context)
+                        return;
+                }
+
+                std::weak_ptr<randomx_dataset> dataset = job->context->dataset;
+
+                job.reset();
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->pools[pool].ready.store(false, std::memory_order_relaxed);
+                    std::atomic_store(&this->pools[pool].job, std::shared_ptr<const Implementors::Job>());
+                    this->pools[pool].sequence.fetch_add(1, std::memory_order_release);
+                    this->job_sequence.fetch_add(1, std::memory_order_release);
+                }
+                this->wakeup.notify_all();
+
+                // Workers drop it after their current hash
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+                while (!dataset.expired() && this->running.load() && std::chrono::steady_clock::now() < deadline)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+                if (!dataset.expired())
+                    Logger::warning("dataset of old seed is still used, new dataset is allocated next to it");
+            }
+
+            /**
+             * @brief Get memory of seed hash. Memory used by any pool or
+             * being prepared for other pool is shared, so pools on the 
+             * same seed share one dataset
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool of job
+             * @param seed_hash Seed hash
+             * @param dataset Memory must have dataset
+             * @return std::shared_ptr<const Implementors::Seed_Context> 
+             */
+            std::shared_ptr<const Implementors::Seed_Context> get_context(size_t pool, const binary &seed_hash, bool dataset)
+            {
+                auto key = std::make_pair(seed_hash, dataset);
+                std::promise<std::shared_ptr<const Implementors::Seed_Context>> prepared;
+                std::shared_future<std::shared_ptr<const Implementors::Seed_Context>> pending;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->prepare_mutex);
+
+                    this->contexts.erase(
+                        std::remove_if(this->contexts.begin(), this->contexts.end(), [](auto &context) { return context.expired(); }),
+                        this->contexts.end()
+                    );
+                    for (auto &weak : this->contexts)
+                    {
+                        auto context = weak.lock();
+
+                        if (context && context->seed_hash == seed_hash && (context->dataset || !dataset))
+                            return context;
+                    }
+
+                    auto found = this->preparing.find(key);
+
+                    if (found != this->preparing.end())
+                        pending = found->second;
+                    else
+                        this->preparing[key] = prepared.get_future().share();
+                }
+
+                if (pending.valid())
+                    return pending.get();
+
+                std::shared_ptr<const Implementors::Seed_Context> context;
+
+                try {
+                    if (dataset)
+                        this->withdraw(pool);
+                    context = this->prepare(seed_hash, dataset);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(this->prepare_mutex);
+
+                    this->preparing.erase(key);
+                    prepared.set_exception(std::current_exception());
+                    throw;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(this->prepare_mutex);
+
+                    this->contexts.push_back(context);
+                    this->preparing.erase(key);
+                }
+                prepared.set_value(context);
+
+                return context;
+            }
+
+            /**
+             * @brief Create virtual machine for seed memory
+             * 
+             * @author GerrFrog
+             * 
+             * @param context Seed memory
+             * @return randomx_vm* 
+             */
+            randomx_vm *create_vm(const Implementors::Seed_Context &context)
+            {
+                // Memory without dataset is hashed by light VM
+                randomx_flags flags = context.dataset ? this->flags : (randomx_flags)(this->flags & ~RANDOMX_FLAG_FULL_MEM);
+                randomx_cache *cache = context.dataset ? nullptr : context.cache.get();
+                randomx_vm *vm = randomx_create_vm(flags, cache, context.dataset.get());
+
+                if (vm == nullptr && (flags & RANDOMX_FLAG_LARGE_PAGES))
+                    vm = randomx_create_vm(
+                        (randomx_flags)(flags & ~RANDOMX_FLAG_LARGE_PAGES),
+                        cache,
+                        context.dataset.get()
+                    );
+                if (vm == nullptr)
+                    throw Exceptions::Solvers::RandomX_Error(
+                        "Cannot create RandomX virtual machine"
+                    );
+
+                return vm;
+            }
+
+            /**
+             * @brief Destroy VMs of worker whose memory no job of worker
+             * uses, so the memory may be released
+             * 
+             * @author GerrFrog
+             * 
+             * @param vms VMs of worker by memory
+             * @param jobs Jobs of worker by pool
+             */
+            static void release_vms(
+                std::vector<std::pair<std::shared_ptr<const Implementors::Seed_Context>, randomx_vm*>> &vms,
+                const std::array<Implementors::Worker_Job, max_pools> &jobs
+            )
+            {
+                for (auto it = vms.begin(); it != vms.end(); )
+                {
+                    bool used = std::any_of(jobs.begin(), jobs.end(), [&it](const Implementors::Worker_Job &job) {
+                        return job.job && job.job->context == it->first;
+                    });
+
+                    if (used)
+                    {
+                        it++;
+                        continue;
+                    }
+
+                    randomx_destroy_vm(it->second);
+                    it = vms.erase(it);
+                }
+            }
+
+            /**
+             * @brief Virtual machine of worker for seed memory. VMs are
+             * kept while a job of any pool uses their memory, so 
+             * switching between pools creates no VM
+             * 
+             * @author GerrFrog
+             * 
+             * @param vms VMs of worker by memory
+             * @param jobs Jobs of worker by pool
+             * @param context Seed memory
+             * @return randomx_vm* 
+             */
+            randomx_vm *worker_vm(
+                std::vector<std::pair<std::shared_ptr<const Implementors::Seed_Context>, randomx_vm*>> &vms,
+                const std::array<Implementors::Worker_Job, max_pools> &jobs,
+                const std::shared_ptr<const Implementors::Seed_Context> &context
+            )
+            {
+                release_vms(vms, jobs);
+
+                for (auto &vm : vms)
+                    if (vm.first == context)
+                        return vm.second;
+
+                vms.emplace_back(context, this->create_vm(*context));
+
+                return vms.back().second;
+            }
+
+            /**
+             * @brief Select pool for worker by weights of pools with 
+             * jobs. In time slicing every worker goes through all pools
+             * in a period, shifted by its index, so every pool gets a
+             * steady part of workers; in partitioning worker stays on 
+             * its pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param index Worker index
+             * @return size_t Pool with job
+             */
+            size_t select_pool(size_t index)
+            {
+                size_t count = this->pool_count.load(std::memory_order_acquire);
+
+                if (count == 1)
+                    return 0;
+
+                std::array<double, max_pools> weights;
+                double total = 0;
+                size_t fallback = 0;
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    bool ready = this->pools[i].ready.load(std::memory_order_relaxed);
+
+                    weights[i] = ready ? this->pools[i].weight.load(std::memory_order_relaxed) : 0;
+                    total += weights[i];
+
+                    if (ready && !this->pools[fallback].ready.load(std::memory_order_relaxed))
+                        fallback = i;
+                }
+
+                if (total <= 0)
+                    return fallback;
+
+                double workers = (double)std::max<size_t>(1, this->get_unparked());
+                double position = (index + 0.5) / workers;
+
+                if (this->split_time)
+                    position = std::fmod(
+                        std::chrono::duration<double>(
+                            std::chrono::steady_clock::now().time_since_epoch()
+                        ).count() / this->split_period + index / workers,
+                        1.0
+                    );
+
+                position *= total;
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (position < weights[i])
+                        return i;
+                    position -= weights[i];
+                }
+
+                return fallback;
+            }
+
+            /**
+             * @brief Decode pool target to upper bound of hash
+             * 
+             * @author GerrFrog
+             * 
+             * @param target Target in HEX (4 or 8 bytes, little endian)
+             * @return uint64_t 
+             */
+            static uint64_t decode_target(const string &target)
+            {
+                binary decoded = Utilities::HEX_String(target).get_decoded();
+                uint64_t value = 0;
+
+                std::memcpy(&value, decoded.data(), std::min<size_t>(decoded.size(), sizeof(value)));
+
+                if (decoded.size() <= sizeof(uint32_t))
+                {
+                    if (value == 0)
+                        return 0;
+                    return 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / value);
+                }
+
+                return value;
+            }
+
+            /**
+             * @brief Wait until there is work for the worker
+             * 
+             * @author GerrFrog
+             * 
+             * @param index Worker index
+             */
+            void idle(size_t index)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+
+                this->wakeup.wait_for(lock, std::chrono::milliseconds(100), [this, index] {
+                    return 
+                        !this->running.load() ||
+                        index >= this->threads.load() ||
+                        (
+                            !this->paused.load() && 
+                            index < this->unparked.load() && 
+                            this->job_sequence.load() != 0
+                        );
+                });
+            }
+
+            /**
+             * @brief Wait until withdrawn job of pool is replaced
+             * 
+             * @author GerrFrog
+             * 
+             * @param index Worker index
+             * @param pool Pool
+             * @param sequence Sequence of withdrawn job
+             */
+            void wait_job(size_t index, size_t pool, uint64_t sequence)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+
+                this->wakeup.wait_for(lock, std::chrono::milliseconds(100), [this, index, pool, sequence] {
+                    return 
+                        !this->running.load() ||
+                        index >= this->threads.load() ||
+                        this->pools[pool].sequence.load() != sequence;
+                });
+            }
+
+            /**
+             * @brief Hashing loop of one worker. Hashes are pipelined:
+             * a hash is started while the result of previous one on the
+             * same VM is finished
+             * 
+             * @author GerrFrog
+             * 
+             * @param index Worker index
+             * @param cpus CPU of worker (empty if not pinned)
+             */
+            void work(size_t index, std::vector<unsigned> cpus)
+            {
+                // Before the VM is created, so scratchpad is first touched on the node of CPU
+                if (!cpus.empty() && !Implementors::set_thread_affinity(cpus))
+                    Logger::warning("worker {}: cannot pin to cpu {}", index, cpus[0]);
+                if (this->background.enabled && !Implementors::set_background_priority(this->background))
+                    Logger::warning("worker {}: cannot lower priority", index);
+
+                Statistics::Implementors::Thread_Counter &counter = this->counters[index];
+                Statistics::Implementors::Thread_Counter &job_counter = this->job_counters[index];
+                std::array<Implementors::Worker_Job, max_pools> jobs;
+                std::vector<std::pair<std::shared_ptr<const Implementors::Seed_Context>, randomx_vm*>> vms;
+                Implementors::Pending_Hash pending;
+                bool first_hash = false;
+                uint64_t seen = 0;
+                uint64_t hash[RANDOMX_HASH_SIZE / sizeof(uint64_t)];
+                Statistics::Perf_Group perf;
+                bool sampling = this->perf_counters.is_enabled() && perf.open();
+                uint64_t unsampled = 0;
+
+                if (sampling)
+                    this->perf_counters.attach(perf);
+                else if (this->perf_counters.is_enabled() && !this->perf_reported.exchange(true))
+                    Logger::warning("perf events are unavailable, hardware counters are disabled");
+
+                // Result of finished hash is in `hash`
+                auto report = [&](const Implementors::Pending_Hash &done) {
+                    const Implementors::Job *job = done.job.get();
+
+                    counter.add(1);
+                    job_counter.add(1);
+                    this->pool_counters[index * max_pools + done.pool].add(1);
+
+                    if (sampling && ++unsampled == perf_interval)
+                    {
+                        this->perf_counters.sample(index, perf, unsampled);
+                        unsampled = 0;
+                    }
+
+                    if (done.first)
+                        this->latency.record(
+                            index,
+                            Statistics::Stage::First_Hash,
+                            std::chrono::steady_clock::now() - job->published
+                        );
+
+                    if (hash[3] < job->target_value && this->pools[done.pool].submit_handler)
+                    {
+                        auto found = std::chrono::steady_clock::now();
+                        binary result(
+                            (unsigned char*)hash, 
+                            (unsigned char*)hash + sizeof(hash)
+                        );
+
+                        this->latency.record(index, Statistics::Stage::Found, found - job->received);
+                        this->pools[done.pool].submit_handler({
+                            job->job_id,
+                            Utilities::HEX_String(done.nonce).get_encoded(),
+                            Utilities::HEX_String(result).get_encoded(),
+                            found
+                        });
+                    }
+                };
+
+                // Hash in flight is finished before its VM or job is dropped
+                auto flush = [&]() {
+                    if (!pending.vm)
+                        return;
+                    randomx_calculate_hash_last(pending.vm, hash);
+                    report(pending);
+                    pending = {};
+                };
+
+                try {
+                    while (
+                        this->running.load(std::memory_order_relaxed) &&
+                        index < this->threads.load(std::memory_order_relaxed)
+                    )
+                    {
+                        uint64_t job_sequence = this->job_sequence.load(std::memory_order_acquire);
+
+                        // Old jobs of all pools are dropped, so memory of 
+                        // withdrawn job is released even by idle workers
+                        if (job_sequence != seen)
+                        {
+                            flush();
+                            seen = job_sequence;
+                            for (size_t i = 0; i < max_pools; i++)
+                                if (jobs[i].job && jobs[i].sequence != this->pools[i].sequence.load(std::memory_order_acquire))
+                                    jobs[i] = {};
+                            release_vms(vms, jobs);
+                        }
+
+                        if (
+                            job_sequence == 0 || 
+                            this->paused.load(std::memory_order_relaxed) ||
+                            index >= this->unparked.load(std::memory_order_relaxed)
+                        )
+                        {
+                            this->idle(index);
+                            continue;
+                        }
+
+                        size_t pool = this->select_pool(index);
+                        Implementors::Worker_Job &current = jobs[pool];
+                        uint64_t sequence = this->pools[pool].sequence.load(std::memory_order_acquire);
+
+                        if (current.sequence != sequence)
+                        {
+                            flush();
+                            current.sequence = sequence;
+                            current.job = std::atomic_load(&this->pools[pool].job);
+                            current.vm = nullptr;
+                            if (!current.job)
+                            {
+                                release_vms(vms, jobs);
+                                continue;
+                            }
+                            current.vm = this->worker_vm(vms, jobs, current.job->context);
+                            current.blob = current.job->blob;
+                            // Every worker owns a range of nonces
+                            current.nonce = (uint32_t)((0x100000000ULL / this->max_threads) * index);
+
+                            job_counter.reset();
+                            first_hash = true;
+                        }
+
+                        if (!current.job)
+                        {
+                            this->wait_job(index, pool, sequence);
+                            continue;
+                        }
+
+                        uint32_t nonce = current.nonce++;
+                        Implementors::Pending_Hash started{pool, current.job, nonce, current.vm, first_hash};
+
+                        first_hash = false;
+                        std::memcpy(current.blob.data() + nonce_offset, &nonce, sizeof(nonce));
+
+                        // Pools with the same seed share VM, so pipeline 
+                        // is kept while switching between them
+                        if (pending.vm == current.vm)
+                        {
+                            randomx_calculate_hash_next(current.vm, current.blob.data(), current.blob.size(), hash);
+                            report(std::exchange(pending, std::move(started)));
+                            continue;
+                        }
+
+                        flush();
+                        randomx_calculate_hash_first(current.vm, current.blob.data(), current.blob.size());
+                        pending = std::move(started);
+                    }
+
+                    flush();
+                } catch (std::exception &exp) {
+                    Logger::error("worker {}: {}", index, exp.what());
+                }
+
+                if (sampling)
+                    this->perf_counters.sample(index, perf, unsampled);
+                for (auto &vm : vms)
+                    randomx_destroy_vm(vm.second);
+            }
+
+            /**
+             * @brief Dispatcher loop of pool. Prepares memory for new 
+             * seeds and publishes jobs for workers
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool
+             */
+            void dispatch(size_t pool)
+            {
+                // Cache init (Argon2) runs here
+                Implementors::set_background_priority(this->background);
+
+                while (true)
+                {
+                    Utilities::Pools::New_Job_V1 new_job;
+                    std::chrono::steady_clock::time_point received, parsed;
+
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+
+                        this->wakeup.wait(lock, [this, pool] {
+                            return !this->running.load() || this->pools[pool].pending_job.has_value();
+                        });
+
+                        if (!this->running.load())
+                            return;
+
+                        new_job = std::move(*this->pools[pool].pending_job);
+                        received = this->pools[pool].pending_received;
+                        parsed = this->pools[pool].pending_time;
+                        this->pools[pool].pending_job.reset();
+                    }
+
+                    try {
+                        binary seed_hash = new_job.seed_hash.get_decoded();
+                        auto job = std::make_shared<Implementors::Job>();
+                        bool dataset = this->full_memory && (pool == 0 || !this->light_secondary);
+
+                        if (new_job.blob.get_decoded().size() < nonce_offset + sizeof(uint32_t))
+                            throw Exceptions::Solvers::RandomX_Error(
+                                "Hashing blob is too short"
+                            );
+
+                        // Only a seed which no pool uses needs new memory
+                        std::shared_ptr<const Implementors::Seed_Context> context = this->get_context(pool, seed_hash, dataset);
+
+                        job->job_id = new_job.job_id;
+                        job->blob = new_job.blob.get_decoded();
+                        job->target = new_job.target;
+                        job->target_value = decode_target(new_job.target);
+                        job->height = new_job.height;
+                        job->context = context;
+                        job->received = received;
+                        job->published = std::chrono::steady_clock::now();
+
+                        std::atomic_store(
+                            &this->pools[pool].job, 
+                            std::shared_ptr<const Implementors::Job>(job)
+                        );
+                    } catch (std::exception &exp) {
+                        Logger::error("job {}: {}", new_job.job_id, exp.what());
+                        continue;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(this->mutex);
+                        this->pools[pool].ready.store(true, std::memory_order_relaxed);
+                        this->pools[pool].sequence.fetch_add(1, std::memory_order_release);
+                        this->job_sequence.fetch_add(1, std::memory_order_release);
+                    }
+                    this->wakeup.notify_all();
+
+                    auto published = std::chrono::steady_clock::now();
+
+                    this->jobs.fetch_add(1, std::memory_order_relaxed);
+                    this->job_switch.record(
+                        std::chrono::duration_cast<std::chrono::microseconds>(published - parsed)
+                    );
+                    this->latency.record_shared(this->max_threads + 1, Statistics::Stage::Publish, published - parsed);
+                }
+            }
+
+            /**
+             * @brief Start or stop workers. Caller holds control_mutex
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of threads
+             */
+            void resize(size_t count)
+            {
+                size_t current = this->threads.load();
+
+                // Stopped solver does not start workers again
+                if (!this->running.load())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->threads.store(count);
+                }
+                this->wakeup.notify_all();
+
+                for (size_t i = count; i < current; i++)
+                    if (this->workers[i].joinable())
+                        this->workers[i].join();
+                for (size_t i = current; i < count; i++)
+                {
+                    std::vector<unsigned> cpus;
+
+                    if (!this->affinity.empty())
+                        cpus.push_back(this->affinity[i % this->affinity.size()]);
+                    this->workers[i] = std::thread(&Solver::work, this, i, cpus);
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct a new Solver object
+             * 
+             * @author GerrFrog
+             * 
+             * @param config Solver configuration (threads, mode, huge_pages, perf, perf_counters, caches, background, split)
+             */
+            Solver(
+                const nlohmann::json &config
+            ) : background(select_background(config)),
+                flags(select_flags(
+                    config_value<string>(config, "mode", "full") == "full",
+                    config_value<bool>(config, "huge_pages", true),
+                    select_perf(config_value<string>(config, "perf", "off"))
+                )),
+                full_memory(flags & RANDOMX_FLAG_FULL_MEM),
+                huge_pages(flags & RANDOMX_FLAG_LARGE_PAGES),
+                caches(
+                    (randomx_flags)(flags & ~RANDOMX_FLAG_FULL_MEM),
+                    std::max<size_t>(config_value<size_t>(config, "caches", 4), 1) * Implementors::Cache_Storage::cache_memory
+                ),
+                max_threads(std::max(1u, std::thread::hardware_concurrency())),
+                counters(max_threads),
+                job_counters(max_threads),
+                workers(max_threads),
+                pool_counters(max_threads * max_pools),
+                latency(max_threads + 2),
+                perf_counters(config_value<bool>(config, "perf_counters", false), max_threads)
+            {
+                size_t threads = config_value<size_t>(config, "threads", 0);
+                nlohmann::json split = config_value<nlohmann::json>(config, "split", nlohmann::json::object());
+
+                this->split_time = split.value("schedule", string("time")) != "threads";
+                this->split_period = std::max(split.value("period", 10.0), 0.001);
+                this->light_secondary = split.value("light", false);
+                this->pools[0].name = "pool";
+
+                this->dispatchers[0] = std::thread(&Solver::dispatch, this, 0);
+                this->set_threads(threads == 0 ? this->max_threads : threads);
+            }
+
+            /**
+             * @brief Destroy the Solver object
+             * 
+             * @author GerrFrog
+             */
+            ~Solver()
+            {
+                this->stop();
+            }
+
+            /**
+             * @brief Stop dispatcher and workers and join them. After 
+             * return no submit handler is called, so pools may be 
+             * destroyed
+             * 
+             * @author GerrFrog
+             */
+            void stop()
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->running.store(false);
+                }
+                this->wakeup.notify_all();
+
+                for (auto &dispatcher : this->dispatchers)
+                    if (dispatcher.joinable())
+                        dispatcher.join();
+                for (auto &worker : this->workers)
+                    if (worker.joinable())
+                        worker.join();
+            }
+
+            /**
+             * @brief Set new job from pool. Returns immediately, memory
+             * for a new seed is prepared by dispatcher of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param new_job New job
+             * @param received Time when job bytes were received
+             * @param pool Pool of job
+             */
+            void set_job(
+                const Utilities::Pools::New_Job_V1 &new_job,
+                std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now(),
+                size_t pool = 0
+            )
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->pools[pool].pending_job = new_job;
+                    this->pools[pool].pending_time = std::chrono::steady_clock::now();
+                    this->pools[pool].pending_received = received;
+                }
+                this->wakeup.notify_all();
+            }
+
+            /**
+             * @brief Set callback for found shares. Called from worker 
+             * threads, so it must not block. Must be set before first job
+             * 
+             * @author GerrFrog
+             * 
+             * @param handler Callback
+             * @param pool Pool of shares
+             */
+            void set_submit_handler(
+                std::function<void(const Implementors::Share&)> handler,
+                size_t pool = 0
+            )
+            {
+                this->pools[pool].submit_handler = handler;
+            }
+
+            /**
+             * @brief Add pool which gets a part of hashrate. Must be 
+             * called before its first job
+             * 
+             * @author GerrFrog
+             * 
+             * @param name Name of pool
+             * @param weight Weight of pool in hashrate
+             * @return size_t Pool index
+             */
+            size_t add_pool(const string &name, double weight)
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+                size_t pool = this->pool_count.load();
+
+                if (pool == max_pools)
+                    throw Exceptions::Solvers::RandomX_Error(
+                        "Too many pools"
+                    );
+
+                this->pools[pool].name = name;
+                this->pools[pool].weight.store(std::max(weight, 0.0));
+                this->pool_count.store(pool + 1, std::memory_order_release);
+                this->dispatchers[pool] = std::thread(&Solver::dispatch, this, pool);
+
+                return pool;
+            }
+
+            /**
+             * @brief Set name and weight of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @param name Name of pool
+             * @param weight Weight of pool in hashrate
+             */
+            void set_pool(size_t pool, const string &name, double weight)
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+
+                this->pools[pool].name = name;
+                this->pools[pool].weight.store(std::max(weight, 0.0));
+            }
+
+            /**
+             * @brief Set number of worker threads
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of threads (clamped to [1, max threads])
+             */
+            void set_threads(size_t count)
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+
+                this->resize(std::min(std::max<size_t>(count, 1), this->max_threads));
+            }
+
+            /**
+             * @brief Pin workers to CPUs. Running workers are restarted,
+             * so their VMs are allocated again on the new CPUs
+             * 
+             * @author GerrFrog
+             * 
+             * @param cpus CPUs by worker index (empty to unpin new workers)
+             */
+            void set_affinity(const std::vector<unsigned> &cpus)
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+                size_t current = this->threads.load();
+
+                this->resize(0);
+                this->affinity = cpus;
+                this->resize(current);
+            }
+
+            /**
+             * @brief Get CPUs of workers
+             * 
+             * @author GerrFrog
+             * 
+             * @return std::vector<unsigned> Empty if workers are not pinned
+             */
+            std::vector<unsigned> get_affinity()
+            {
+                std::lock_guard<std::mutex> control(this->control_mutex);
+
+                return this->affinity;
+            }
+
+            /**
+             * @brief Pause hashing
+             * 
+             * @author GerrFrog
+             */
+            void pause()
+            {
+                this->paused.store(true);
+            }
+
+            /**
+             * @brief Park workers above count without stopping them, so
+             * unparking does not recreate VMs
+             * 
+             * @author GerrFrog
+             * 
+             * @param count Number of hashing workers (at least 1)
+             */
+            void set_unparked(size_t count)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->unparked.store(std::max<size_t>(count, 1));
+                }
+                this->wakeup.notify_all();
+            }
+
+            /**
+             * @brief Resume hashing
+             * 
+             * @author GerrFrog
+             */
+            void resume()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->paused.store(false);
+                }
+                this->wakeup.notify_all();
+            }
+
+            /**
+             * @brief Get current job of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return std::shared_ptr<const Implementors::Job> Job (empty before first job)
+             */
+            std::shared_ptr<const Implementors::Job> get_job(size_t pool = 0) const
+            {
+                return std::atomic_load(&this->pools[pool].job);
+            }
+
+            /**
+             * @brief Get number of pools
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t get_pools() const { return this->pool_count.load(); }
+
+            /**
+             * @brief Get name of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return const string& 
+             */
+            const string &get_pool_name(size_t pool) const { return this->pools[pool].name; }
+
+            /**
+             * @brief Get weight of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return double 
+             */
+            double get_weight(size_t pool) const { return this->pools[pool].weight.load(); }
+
+            /**
+             * @brief Get hashes of all workers for pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return uint64_t 
+             */
+            uint64_t get_pool_hashes(size_t pool) const
+            {
+                uint64_t hashes = 0;
+
+                for (size_t i = 0; i < this->max_threads; i++)
+                    hashes += this->pool_counters[i * max_pools + pool].get();
+
+                return hashes;
+            }
+
+            /**
+             * @brief Get hashes of every worker
+             * 
+             * @author GerrFrog
+             * 
+             * @return std::vector<uint64_t> 
+             */
+            std::vector<uint64_t> get_hashes() const
+            {
+                std::vector<uint64_t> hashes;
+
+                for (auto &counter : this->counters)
+                    hashes.push_back(counter.get());
+
+                return hashes;
+            }
+
+            /**
+             * @brief Get hashes of every worker on the current job
+             * 
+             * @author GerrFrog
+             * 
+             * @return std::vector<uint64_t> 
+             */
+            std::vector<uint64_t> get_job_hashes() const
+            {
+                std::vector<uint64_t> hashes;
+
+                for (auto &counter : this->job_counters)
+                    hashes.push_back(counter.get());
+
+                return hashes;
+            }
+
+            /**
+             * @brief Get number of running workers
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t get_threads() const { return this->threads.load(); }
+
+            /**
+             * @brief Get number of running workers which are not parked
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t get_unparked() const { return std::min(this->threads.load(), this->unparked.load()); }
+
+            /**
+             * @brief Get number of parked workers
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t get_parked() const 
+            { 
+                size_t threads = this->threads.load();
+
+                return threads - std::min(threads, this->unparked.load()); 
+            }
+
+            /**
+             * @brief Get maximum number of workers
+             * 
+             * @author GerrFrog
+             * 
+             * @return size_t 
+             */
+            size_t get_max_threads() const { return this->max_threads; }
+
+            /**
+             * @brief Check if hashing is paused
+             * 
+             * @author GerrFrog
+             * 
+             * @return bool
+             */
+            bool is_paused() const { return this->paused.load(); }
+
+            /**
+             * @brief Check if dataset mode is used
+             * 
+             * @author GerrFrog
+             * 
+             * @return bool
+             */
+            bool is_full_memory() const { return this->full_memory; }
+
+            /**
+             * @brief Check if memory is allocated in huge pages
+             * 
+             * @author GerrFrog
+             * 
+             * @return bool
+             */
+            bool has_huge_pages() const { return this->huge_pages.load(); }
+
+            /**
+             * @brief Get results of submitted shares of pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return Statistics::Share_Counter& 
+             */
+            Statistics::Share_Counter &get_shares(size_t pool = 0) { return this->pools[pool].shares; }
+
+            /**
+             * @brief Get latency between submit and pool response
+             * 
+             * @author GerrFrog
+             * 
+             * @return Statistics::Latency_Window& 
+             */
+            Statistics::Latency_Window &get_submit_latency() { return this->submit_latency; }
+
+            /**
+             * @brief Get histogram of share round-trip time
+             * 
+             * @author GerrFrog
+             * 
+             * @return Statistics::Histogram& 
+             */
+            Statistics::Histogram &get_share_rtt() { return this->share_rtt; }
+
+            /**
+             * @brief Get histogram of job switch latency
+             * 
+             * @author GerrFrog
+             * 
+             * @return const Statistics::Histogram& 
+             */
+            const Statistics::Histogram &get_job_switch() const { return this->job_switch; }
+
+            /**
+             * @brief Get number of published jobs
+             * 
+             * @author GerrFrog
+             * 
+             * @return uint64_t 
+             */
+            uint64_t get_jobs() const { return this->jobs.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Get duration of the last seed preparation
+             * 
+             * @author GerrFrog
+             * 
+             * @return double Seconds
+             */
+            double get_dataset_init() const { return this->dataset_init.load() / 1e6; }
+
+            /**
+             * @brief Record latency of stage on network thread. Strands
+             * of connections may run on several network threads at once
+             * 
+             * @author GerrFrog
+             * 
+             * @param stage Stage
+             * @param latency Latency
+             */
+            void trace(Statistics::Stage stage, std::chrono::nanoseconds latency)
+            {
+                this->latency.record_shared(this->max_threads, stage, latency);
+            }
+
+            /**
+             * @brief Get latency of pipeline stages
+             * 
+             * @author GerrFrog
+             * 
+             * @return const Statistics::Pipeline_Latency& 
+             */
+            const Statistics::Pipeline_Latency &get_latency() const { return this->latency; }
+
+            /**
+             * @brief Get background mode
+             * 
+             * @author GerrFrog
+             * 
+             * @return const Implementors::Background& 
+             */
+            const Implementors::Background &get_background() const { return this->background; }
+
+            /**
+             * @brief Get hardware counters of workers
+             * 
+             * @author GerrFrog
+             * 
+             * @return const Statistics::Perf_Counters& 
+             */
+            const Statistics::Perf_Counters &get_perf_counters() const { return this->perf_counters; }
+
+            /**
+             * @brief Count reconnection to pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             */
+            void add_reconnect(size_t pool = 0) { this->pools[pool].reconnects.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Get number of reconnections to pool
+             * 
+             * @author GerrFrog
+             * 
+             * @param pool Pool index
+             * @return uint64_t 
+             */
+            uint64_t get_reconnects(size_t pool = 0) const { return this->pools[pool].reconnects.load(std::memory_order_relaxed); }
+    };
+}
 
 
 
@@ -0,0 +1,1385 @@
+#pragma once
+
+#ifndef STATISTICS_HEADER
+#define STATISTICS_HEADER
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <array>
+#include <deque>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Implementators for Statistics objects
+ *
+ * @author GerrFrog
+ */
+namespace Statistics::Implementors
+{
+    /**
+     * @brief Hash counter of one worker thread. Padded to a cache line,
+     * so neighbouring workers never write into the same line
+     *
+     * @author GerrFrog
+     */
+    struct alignas(64) Thread_Counter
+    {
+        /**
+         * @brief Calculated hashes
+         *
+         * @author GerrFrog
+         */
+        std::atomic<uint64_t> hashes{0};
+
+        /**
+         * @brief Add hashes. Only the owning worker writes the counter,
+         * so plain load and store are enough (no locked instruction)
+         *
+         * @author GerrFrog
+         *
+         * @param count Number of hashes
+         */
+        void add(uint64_t count)
+        {
+            this->hashes.store(
+                this->hashes.load(std::memory_order_relaxed) + count,
+                std::memory_order_relaxed
+            );
+        }
+
+        /**
+         * @brief Get calculated hashes
+         *
+         * @author GerrFrog
+         *
+         * @return uint64_t
+         */
+        uint64_t get() const
+        {
+            return this->hashes.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Reset counter. Only the owning worker may call it
+         *
+         * @author GerrFrog
+         */
+        void reset()
+        {
+            this->hashes.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief HDR-style histogram of nanoseconds with logarithmic buckets:
+     * every power of two is split into 16 linear sub-buckets, so the
+     * relative error is below 6% from 1 ns up to 18 minutes
+     *
+     * @note Written by one thread (or by any thread with record_shared), 
+     * read by any thread without locks
+     *
+     * @author GerrFrog
+     */
+    class Log_Histogram
+    {
+        public:
+            /**
+             * @brief Bits of linear range
+             *
+             * @author GerrFrog
+             */
+            static constexpr unsigned sub_bits = 5;
+
+            /**
+             * @brief Bits of the largest value (greater are clamped)
+             *
+             * @author GerrFrog
+             */
+            static constexpr unsigned max_bits = 40;
+
+            /**
+             * @brief Number of buckets
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t bucket_count = 
+                (max_bits - sub_bits) * (1 << (sub_bits - 1)) + (1 << sub_bits);
+
+        private:
+            /**
+             * @brief Observations in every bucket
+             *
+             * @author GerrFrog
+             */
+            std::array<std::atomic<uint64_t>, bucket_count> buckets{};
+
+        public:
+            /**
+             * @brief Get bucket of value
+             *
+             * @author GerrFrog
+             *
+             * @param value Value
+             * @return size_t
+             */
+            static size_t index(uint64_t value)
+            {
+                constexpr uint64_t half = 1 << (sub_bits - 1);
+
+                if (value >= (1ULL << max_bits))
+                    value = (1ULL << max_bits) - 1;
+                if (value < (1 << sub_bits))
+                    return value;
+
+                unsigned magnitude = 63 - __builtin_clzll(value);
+                unsigned shift = magnitude - sub_bits + 1;
+
+                return shift * half + (value >> shift);
+            }
+
+            /**
+             * @brief Get middle value of bucket
+             *
+             * @author GerrFrog
+             *
+             * @param index Bucket
+             * @return double
+             */
+            static double value(size_t index)
+            {
+                constexpr size_t half = 1 << (sub_bits - 1);
+
+                if (index < (1 << sub_bits))
+                    return index;
+
+                size_t shift = index / half - 1;
+                uint64_t top = index - shift * half;
+
+                return ((top << shift) + ((top + 1) << shift)) / 2.0;
+            }
+
+            /**
+             * @brief Get value at quantile of bucket counts
+             *
+             * @author GerrFrog
+             *
+             * @param counts Observations in every bucket
+             * @param quantile Quantile in range [0, 1]
+             * @return double Value (0 if nothing recorded)
+             */
+            static double percentile(const std::vector<uint64_t> &counts, double quantile)
+            {
+                uint64_t total = 0;
+
+                for (auto count : counts)
+                    total += count;
+                if (total == 0)
+                    return 0;
+
+                uint64_t rank = std::max<uint64_t>(1, (uint64_t)(quantile * total + 0.5));
+                uint64_t seen = 0;
+
+                for (size_t i = 0; i < counts.size(); i++)
+                {
+                    seen += counts[i];
+                    if (seen >= rank)
+                        return value(i);
+                }
+
+                return value(counts.size() - 1);
+            }
+
+            /**
+             * @brief Record value
+             *
+             * @author GerrFrog
+             *
+             * @param value Value
+             */
+            void record(uint64_t value)
+            {
+                std::atomic<uint64_t> &bucket = this->buckets[index(value)];
+
+                bucket.store(
+                    bucket.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed
+                );
+            }
+
+            /**
+             * @brief Record value from one of several writer threads
+             *
+             * @author GerrFrog
+             *
+             * @param value Value
+             */
+            void record_shared(uint64_t value)
+            {
+                this->buckets[index(value)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Add observations to bucket counts
+             *
+             * @author GerrFrog
+             *
+             * @param counts Observations in every bucket (bucket_count size)
+             */
+            void add_to(std::vector<uint64_t> &counts) const
+            {
+                for (size_t i = 0; i < bucket_count; i++)
+                    counts[i] += this->buckets[i].load(std::memory_order_relaxed);
+            }
+    };
+}
+
+/**
+ * @brief Statistics of the miner
+ *
+ * @author GerrFrog
+ */
+namespace Statistics
+{
+    /**
+     * @brief Hashrate over sliding windows. Keeps periodic samples of
+     * the per-thread counters and compares the newest one with the
+     * oldest sample inside the window
+     *
+     * @note Not thread-safe, all calls must come from the sampling thread
+     *
+     * @author GerrFrog
+     */
+    class Hashrate_Meter
+    {
+        private:
+            /**
+             * @brief Counters at a moment of time
+             *
+             * @author GerrFrog
+             */
+            struct Sample
+            {
+                /**
+                 * @brief Time of sample
+                 *
+                 * @author GerrFrog
+                 */
+                std::chrono::steady_clock::time_point time;
+
+                /**
+                 * @brief Hashes of every thread
+                 *
+                 * @author GerrFrog
+                 */
+                std::vector<uint64_t> hashes;
+            };
+
+            /**
+             * @brief Samples from oldest to newest
+             *
+             * @author GerrFrog
+             */
+            std::deque<Sample> samples;
+
+            /**
+             * @brief Longest window to keep samples for
+             *
+             * @author GerrFrog
+             */
+            std::chrono::seconds max_window;
+
+        public:
+            /**
+             * @brief Construct a new Hashrate_Meter object
+             *
+             * @author GerrFrog
+             *
+             * @param max_window Longest window to keep samples for
+             */
+            Hashrate_Meter(
+                std::chrono::seconds max_window = std::chrono::minutes(15)
+            ) : max_window(max_window)
+            { }
+
+            /**
+             * @brief Destroy the Hashrate_Meter object
+             *
+             * @author GerrFrog
+             */
+            ~Hashrate_Meter() = default;
+
+            /**
+             * @brief Add sample of counters
+             *
+             * @author GerrFrog
+             *
+             * @param hashes Hashes of every thread
+             */
+            void sample(const std::vector<uint64_t> &hashes)
+            {
+                auto now = std::chrono::steady_clock::now();
+
+                this->samples.push_back({now, hashes});
+
+                // Keep one sample older than the window to cover it completely
+                while (
+                    this->samples.size() > 2 &&
+                    now - this->samples[1].time >= this->max_window
+                )
+                    this->samples.pop_front();
+            }
+
+            /**
+             * @brief Get hashrate of one thread
+             *
+             * @author GerrFrog
+             *
+             * @param window Window
+             * @param thread Thread index
+             * @return double Hashes per second
+             */
+            double hashrate(std::chrono::seconds window, size_t thread) const
+            {
+                return this->rate(window, [thread](const Sample &sample) {
+                    return thread < sample.hashes.size() ? sample.hashes[thread] : 0;
+                });
+            }
+
+            /**
+             * @brief Get hashrate of all threads
+             *
+             * @author GerrFrog
+             *
+             * @param window Window
+             * @return double Hashes per second
+             */
+            double hashrate(std::chrono::seconds window) const
+            {
+                return this->rate(window, [](const Sample &sample) {
+                    uint64_t total = 0;
+                    for (auto hashes : sample.hashes)
+                        total += hashes;
+                    return total;
+                });
+            }
+
+        private:
+            /**
+             * @brief Calculate rate of counter inside window
+             *
+             * @author GerrFrog
+             *
+             * @tparam Counter Callable to extract counter from sample
+             * @param window Window
+             * @param counter Counter
+             * @return double Counter change per second
+             */
+            template<class Counter>
+            double rate(std::chrono::seconds window, Counter counter) const
+            {
+                if (this->samples.size() < 2)
+                    return 0;
+
+                const Sample &newest = this->samples.back();
+                auto oldest = std::find_if(
+                    this->samples.begin(),
+                    this->samples.end(),
+                    [&](const Sample &sample) {
+                        return newest.time - sample.time <= window;
+                    }
+                );
+
+                if (oldest == this->samples.end() || &*oldest == &newest)
+                    return 0;
+
+                double seconds = std::chrono::duration<double>(newest.time - oldest->time).count();
+
+                return (counter(newest) - counter(*oldest)) / seconds;
+            }
+    };
+
+    /**
+     * @brief Results of submitted shares
+     *
+     * @author GerrFrog
+     */
+    class Share_Counter
+    {
+        private:
+            /**
+             * @brief Accepted shares
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> accepted{0};
+
+            /**
+             * @brief Rejected shares
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> rejected{0};
+
+            /**
+             * @brief Shares rejected because the job was outdated
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> stale{0};
+
+        public:
+            /**
+             * @brief Construct a new Share_Counter object
+             *
+             * @author GerrFrog
+             */
+            Share_Counter() = default;
+
+            /**
+             * @brief Destroy the Share_Counter object
+             *
+             * @author GerrFrog
+             */
+            ~Share_Counter() = default;
+
+            /**
+             * @brief Count accepted share
+             *
+             * @author GerrFrog
+             */
+            void add_accepted() { this->accepted.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Count rejected share
+             *
+             * @author GerrFrog
+             */
+            void add_rejected() { this->rejected.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Count stale share
+             *
+             * @author GerrFrog
+             */
+            void add_stale() { this->stale.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Get accepted shares
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_accepted() const { return this->accepted.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Get rejected shares
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_rejected() const { return this->rejected.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Get stale shares
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_stale() const { return this->stale.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief Histogram with fixed bucket bounds for Prometheus. Written
+     * and read by any thread without locks
+     *
+     * @author GerrFrog
+     */
+    class Histogram
+    {
+        private:
+            /**
+             * @brief Upper bounds of buckets in seconds (ascending)
+             *
+             * @author GerrFrog
+             */
+            std::vector<double> bounds;
+
+            /**
+             * @brief Observations in every bucket (last is +Inf)
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::atomic<uint64_t>> buckets;
+
+            /**
+             * @brief Sum of observations in microseconds
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> sum{0};
+
+            /**
+             * @brief Number of observations
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> count{0};
+
+        public:
+            /**
+             * @brief Construct a new Histogram object
+             *
+             * @author GerrFrog
+             *
+             * @param bounds Upper bounds of buckets in seconds (ascending)
+             */
+            Histogram(
+                const std::vector<double> &bounds
+            ) : bounds(bounds),
+                buckets(bounds.size() + 1)
+            { }
+
+            /**
+             * @brief Destroy the Histogram object
+             *
+             * @author GerrFrog
+             */
+            ~Histogram() = default;
+
+            /**
+             * @brief Record observation
+             *
+             * @author GerrFrog
+             *
+             * @param value Observation
+             */
+            void record(std::chrono::microseconds value)
+            {
+                double seconds = value.count() / 1e6;
+                size_t index = std::lower_bound(
+                    this->bounds.begin(),
+                    this->bounds.end(),
+                    seconds
+                ) - this->bounds.begin();
+
+                this->buckets[index].fetch_add(1, std::memory_order_relaxed);
+                this->sum.fetch_add(value.count(), std::memory_order_relaxed);
+                this->count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Get upper bounds of buckets in seconds
+             *
+             * @author GerrFrog
+             *
+             * @return const std::vector<double>&
+             */
+            const std::vector<double> &get_bounds() const { return this->bounds; }
+
+            /**
+             * @brief Get cumulative number of observations up to bucket
+             *
+             * @author GerrFrog
+             *
+             * @param index Bucket index (bounds size for +Inf)
+             * @return uint64_t
+             */
+            uint64_t get_cumulative(size_t index) const
+            {
+                uint64_t total = 0;
+
+                for (size_t i = 0; i <= index && i < this->buckets.size(); i++)
+                    total += this->buckets[i].load(std::memory_order_relaxed);
+
+                return total;
+            }
+
+            /**
+             * @brief Get sum of observations in seconds
+             *
+             * @author GerrFrog
+             *
+             * @return double
+             */
+            double get_sum() const { return this->sum.load(std::memory_order_relaxed) / 1e6; }
+
+            /**
+             * @brief Get number of observations
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t get_count() const { return this->count.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief Tracepoints of the path from pool message to pool response.
+     * Every stage is measured from the previous tracepoint
+     *
+     * @author GerrFrog
+     */
+    enum class Stage : size_t
+    {
+        Parse,          ///< bytes received in handle_server_msg -> job parsed
+        Publish,        ///< job parsed -> job published to workers
+        First_Hash,     ///< job published -> first hash of a worker
+        Found,          ///< bytes received -> share found (age of job)
+        Submit,         ///< share found -> submit written to socket
+        Response,       ///< submit written -> pool response
+        Count
+    };
+
+    /**
+     * @brief Latency histograms of pipeline stages. Every writer thread
+     * has its own slot, slots are merged only when read
+     *
+     * @author GerrFrog
+     */
+    class Pipeline_Latency
+    {
+        public:
+            /**
+             * @brief Number of stages
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t stage_count = (size_t)Stage::Count;
+
+            /**
+             * @brief Names of stages
+             *
+             * @author GerrFrog
+             */
+            static constexpr std::array<const char*, stage_count> stage_names = {
+                "parse", "publish", "first_hash", "found", "submit", "response"
+            };
+
+            /**
+             * @brief Summary of stage
+             *
+             * @author GerrFrog
+             */
+            struct Summary
+            {
+                /**
+                 * @brief Number of observations
+                 *
+                 * @author GerrFrog
+                 */
+                uint64_t count;
+
+                /**
+                 * @brief Percentiles in milliseconds
+                 *
+                 * @author GerrFrog
+                 */
+                double p50, p99, p999;
+            };
+
+        private:
+            /**
+             * @brief Histograms of every slot and stage
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::array<Implementors::Log_Histogram, stage_count>> slots;
+
+        public:
+            /**
+             * @brief Construct a new Pipeline_Latency object
+             *
+             * @author GerrFrog
+             *
+             * @param slots Number of writer threads
+             */
+            Pipeline_Latency(
+                size_t slots
+            ) : slots(slots)
+            { }
+
+            /**
+             * @brief Destroy the Pipeline_Latency object
+             *
+             * @author GerrFrog
+             */
+            ~Pipeline_Latency() = default;
+
+            /**
+             * @brief Record latency. Only the owner of slot may call it
+             *
+             * @author GerrFrog
+             *
+             * @param slot Slot of writer thread
+             * @param stage Stage
+             * @param latency Latency
+             */
+            void record(size_t slot, Stage stage, std::chrono::nanoseconds latency)
+            {
+                this->slots[slot][(size_t)stage].record(
+                    std::max<int64_t>(latency.count(), 0)
+                );
+            }
+
+            /**
+             * @brief Record latency into slot written by several threads
+             *
+             * @author GerrFrog
+             *
+             * @param slot Shared slot
+             * @param stage Stage
+             * @param latency Latency
+             */
+            void record_shared(size_t slot, Stage stage, std::chrono::nanoseconds latency)
+            {
+                this->slots[slot][(size_t)stage].record_shared(
+                    std::max<int64_t>(latency.count(), 0)
+                );
+            }
+
+            /**
+             * @brief Get summary of stage over all slots
+             *
+             * @author GerrFrog
+             *
+             * @param stage Stage
+             * @return Summary
+             */
+            Summary summary(Stage stage) const
+            {
+                std::vector<uint64_t> counts(Implementors::Log_Histogram::bucket_count);
+                uint64_t total = 0;
+
+                for (auto &slot : this->slots)
+                    slot[(size_t)stage].add_to(counts);
+                for (auto count : counts)
+                    total += count;
+
+                return {
+                    total,
+                    Implementors::Log_Histogram::percentile(counts, 0.5) / 1e6,
+                    Implementors::Log_Histogram::percentile(counts, 0.99) / 1e6,
+                    Implementors::Log_Histogram::percentile(counts, 0.999) / 1e6
+                };
+            }
+
+            /**
+             * @brief Write table of all stages
+             *
+             * @author GerrFrog
+             *
+             * @param output Output stream
+             */
+            void dump(std::ostream &output) const
+            {
+                std::ios_base::fmtflags flags = output.flags();
+                std::streamsize precision = output.precision();
+
+                output 
+                    << std::left << std::setw(12) << "stage" << std::right
+                    << std::setw(10) << "count"
+                    << std::setw(12) << "p50 ms"
+                    << std::setw(12) << "p99 ms"
+                    << std::setw(12) << "p999 ms" << std::endl;
+
+                for (size_t i = 0; i < stage_count; i++)
+                {
+                    Summary summary = this->summary((Stage)i);
+
+                    output 
+                        << std::left << std::setw(12) << stage_names[i] << std::right
+                        << std::setw(10) << summary.count << std::fixed << std::setprecision(3)
+                        << std::setw(12) << summary.p50
+                        << std::setw(12) << summary.p99
+                        << std::setw(12) << summary.p999 << std::endl;
+                }
+
+                output.flags(flags);
+                output.precision(precision);
+            }
+    };
+
+    /**
+     * @brief Most recent latencies for percentiles. Written by 
+     * network threads, read by any thread without locks
+     *
+     * @author GerrFrog
+     */
+    class Latency_Window
+    {
+        public:
+            /**
+             * @brief Number of kept latencies
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t capacity = 1024;
+
+        private:
+            /**
+             * @brief Latencies in microseconds
+             *
+             * @author GerrFrog
+             */
+            std::array<std::atomic<uint64_t>, capacity> values{};
+
+            /**
+             * @brief Number of recorded latencies
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> count{0};
+
+        public:
+            /**
+             * @brief Construct a new Latency_Window object
+             *
+             * @author GerrFrog
+             */
+            Latency_Window() = default;
+
+            /**
+             * @brief Destroy the Latency_Window object
+             *
+             * @author GerrFrog
+             */
+            ~Latency_Window() = default;
+
+            /**
+             * @brief Record latency
+             *
+             * @author GerrFrog
+             *
+             * @param latency Latency
+             */
+            void record(std::chrono::microseconds latency)
+            {
+                // Reader may see the slot before its value, a stale value 
+                // only shifts percentiles by one observation
+                uint64_t index = this->count.fetch_add(1, std::memory_order_acq_rel);
+
+                this->values[index % capacity].store(latency.count(), std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Get number of recorded latencies
+             *
+             * @author GerrFrog
+             *
+             * @return uint64_t
+             */
+            uint64_t size() const { return this->count.load(std::memory_order_acquire); }
+
+            /**
+             * @brief Get percentiles of kept latencies
+             *
+             * @author GerrFrog
+             *
+             * @param quantiles Quantiles in range [0, 1]
+             * @return std::vector<double> Latencies in milliseconds (0 if nothing recorded)
+             */
+            std::vector<double> percentiles(const std::vector<double> &quantiles) const
+            {
+                size_t kept = std::min<uint64_t>(this->size(), capacity);
+                std::vector<uint64_t> sorted(kept);
+                std::vector<double> result;
+
+                for (size_t i = 0; i < kept; i++)
+                    sorted[i] = this->values[i].load(std::memory_order_relaxed);
+
+                std::sort(sorted.begin(), sorted.end());
+
+                for (auto quantile : quantiles)
+                {
+                    if (sorted.empty())
+                    {
+                        result.push_back(0);
+                        continue;
+                    }
+                    size_t rank = std::min<size_t>(quantile * kept, kept - 1);
+                    result.push_back(sorted[rank] / 1000.0);
+                }
+
+                return result;
+            }
+    };
+
+    /**
+     * @brief Hardware events counted per worker thread
+     *
+     * @author GerrFrog
+     */
+    enum class Perf_Event : size_t
+    {
+        Cycles,
+        Instructions,
+        LLC_Misses,
+        DTLB_Misses,
+        Branch_Misses,
+        Count
+    };
+
+    /**
+     * @brief Group of perf_event_open counters of the calling thread.
+     * Events the CPU or kernel does not provide are left out, the group
+     * is unavailable only when cycles can not be counted
+     *
+     * @note Must be opened, read and closed by the counted thread
+     *
+     * @author GerrFrog
+     */
+    class Perf_Group
+    {
+        public:
+            /**
+             * @brief Number of events in group
+             *
+             * @author GerrFrog
+             */
+            static constexpr size_t event_count = (size_t)Perf_Event::Count;
+
+        private:
+            /**
+             * @brief Descriptors of events (-1 if not opened)
+             *
+             * @author GerrFrog
+             */
+            std::array<int, event_count> descriptors;
+
+            /**
+             * @brief Order of opened events in group read
+             *
+             * @author GerrFrog
+             */
+            std::array<size_t, event_count> order;
+
+            /**
+             * @brief Number of opened events
+             *
+             * @author GerrFrog
+             */
+            size_t opened = 0;
+
+            /**
+             * @brief Raw values of previous read
+             *
+             * @author GerrFrog
+             */
+            std::array<uint64_t, event_count> previous{};
+
+            /**
+             * @brief Enabled and running time of previous read
+             *
+             * @author GerrFrog
+             */
+            uint64_t previous_enabled = 0, previous_running = 0;
+
+#ifdef __linux__
+            /**
+             * @brief Open one event of group
+             *
+             * @author GerrFrog
+             *
+             * @param type Event type
+             * @param config Event config
+             * @param leader Descriptor of group leader (-1 for leader)
+             * @return int Descriptor or -1
+             */
+            static int open_event(uint32_t type, uint64_t config, int leader)
+            {
+                perf_event_attr attr;
+
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = type;
+                attr.config = config;
+                attr.disabled = leader == -1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = 
+                    PERF_FORMAT_GROUP | 
+                    PERF_FORMAT_TOTAL_TIME_ENABLED | 
+                    PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+            }
+#endif
+
+        public:
+            /**
+             * @brief Construct a new Perf_Group object
+             *
+             * @author GerrFrog
+             */
+            Perf_Group() { this->descriptors.fill(-1); }
+
+            Perf_Group(const Perf_Group&) = delete;
+            Perf_Group &operator=(const Perf_Group&) = delete;
+
+            /**
+             * @brief Destroy the Perf_Group object
+             *
+             * @author GerrFrog
+             */
+            ~Perf_Group() { this->close(); }
+
+            /**
+             * @brief Open and start counters of the calling thread
+             *
+             * @author GerrFrog
+             *
+             * @return true Cycles and possibly other events are counted
+             * @return false perf events are unavailable
+             */
+            bool open()
+            {
+#ifdef __linux__
+                static const std::array<std::pair<uint32_t, uint64_t>, event_count> events = {{
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                    {PERF_TYPE_HW_CACHE, 
+                        PERF_COUNT_HW_CACHE_DTLB | 
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) | 
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+                }};
+
+                this->close();
+
+                for (size_t i = 0; i < event_count; i++)
+                {
+                    int descriptor = open_event(
+                        events[i].first, 
+                        events[i].second, 
+                        this->descriptors[0]
+                    );
+
+                    if (descriptor == -1)
+                    {
+                        if (i == 0)
+                            return false;
+                        continue;
+                    }
+
+                    this->descriptors[i] = descriptor;
+                    this->order[this->opened++] = i;
+                }
+
+                ioctl(this->descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(this->descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            /**
+             * @brief Stop and close counters
+             *
+             * @author GerrFrog
+             */
+            void close()
+            {
+#ifdef __linux__
+                for (auto &descriptor : this->descriptors)
+                    if (descriptor != -1)
+                        ::close(descriptor);
+#endif
+                this->descriptors.fill(-1);
+                this->opened = 0;
+                this->previous.fill(0);
+                this->previous_enabled = this->previous_running = 0;
+            }
+
+            /**
+             * @brief Check if event is counted
+             *
+             * @author GerrFrog
+             *
+             * @param event Event
+             * @return true Event is counted
+             */
+            bool has(Perf_Event event) const { return this->descriptors[(size_t)event] != -1; }
+
+            /**
+             * @brief Read counts since previous read. Counts are scaled up
+             * when the kernel multiplexed the group with other events
+             *
+             * @author GerrFrog
+             *
+             * @param deltas Counts of every event (0 for missing events)
+             * @return true Deltas are valid
+             */
+            bool read(std::array<uint64_t, event_count> &deltas)
+            {
+                deltas.fill(0);
+#ifdef __linux__
+                uint64_t buffer[3 + event_count];
+
+                if (this->opened == 0)
+                    return false;
+                if (::read(this->descriptors[0], buffer, sizeof(buffer)) < (ssize_t)((3 + this->opened) * sizeof(uint64_t)))
+                    return false;
+
+                uint64_t enabled = buffer[1] - this->previous_enabled;
+                uint64_t running = buffer[2] - this->previous_running;
+
+                this->previous_enabled = buffer[1];
+                this->previous_running = buffer[2];
+
+                for (size_t i = 0; i < this->opened; i++)
+                {
+                    size_t event = this->order[i];
+                    uint64_t delta = buffer[3 + i] - this->previous[event];
+
+                    this->previous[event] = buffer[3 + i];
+                    if (running != 0)
+                        deltas[event] = running == enabled ? delta : (uint64_t)((double)delta * enabled / running);
+                }
+
+                return running != 0;
+#else
+                return false;
+#endif
+            }
+    };
+
+    /**
+     * @brief Hardware counters of all workers. Every worker adds its
+     * own slot, readers sum the slots without locks
+     *
+     * @author GerrFrog
+     */
+    class Perf_Counters
+    {
+        public:
+            /**
+             * @brief Event names for reports
+             *
+             * @author GerrFrog
+             */
+            static constexpr std::array<const char*, Perf_Group::event_count> event_names = {
+                "cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"
+            };
+
+            /**
+             * @brief Counts of one worker
+             *
+             * @author GerrFrog
+             */
+            struct Totals
+            {
+                uint64_t hashes = 0;
+                std::array<uint64_t, Perf_Group::event_count> events{};
+            };
+
+        private:
+            /**
+             * @brief Counts of one worker, padded to a cache line
+             *
+             * @author GerrFrog
+             */
+            struct alignas(64) Slot
+            {
+                std::atomic<uint64_t> hashes{0};
+                std::array<std::atomic<uint64_t>, Perf_Group::event_count> events{};
+            };
+
+            /**
+             * @brief Counting is requested
+             *
+             * @author GerrFrog
+             */
+            bool enabled;
+
+            /**
+             * @brief Events counted by at least one worker (bit per event)
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint32_t> available{0};
+
+            /**
+             * @brief Worker slots
+             *
+             * @author GerrFrog
+             */
+            std::vector<Slot> slots;
+
+        public:
+            /**
+             * @brief Construct a new Perf_Counters object
+             *
+             * @author GerrFrog
+             *
+             * @param enabled Counting is requested
+             * @param slots Number of workers
+             */
+            Perf_Counters(bool enabled, size_t slots)
+                : enabled(enabled), slots(enabled ? slots : 0)
+            { }
+
+            /**
+             * @brief Destroy the Perf_Counters object
+             *
+             * @author GerrFrog
+             */
+            ~Perf_Counters() = default;
+
+            /**
+             * @brief Check if counting is requested
+             *
+             * @author GerrFrog
+             *
+             * @return true Counting is requested
+             */
+            bool is_enabled() const { return this->enabled; }
+
+            /**
+             * @brief Check if event was counted by any worker
+             *
+             * @author GerrFrog
+             *
+             * @param event Event index
+             * @return true Event is counted
+             */
+            bool has(size_t event) const 
+            { 
+                return this->available.load(std::memory_order_relaxed) & (1u << event); 
+            }
+
+            /**
+             * @brief Check if any event was counted
+             *
+             * @author GerrFrog
+             *
+             * @return true Counters are available
+             */
+            bool is_available() const { return this->available.load(std::memory_order_relaxed) != 0; }
+
+            /**
+             * @brief Register events opened by worker
+             *
+             * @author GerrFrog
+             *
+             * @param group Opened group
+             */
+            void attach(const Perf_Group &group)
+            {
+                uint32_t mask = 0;
+
+                for (size_t i = 0; i < Perf_Group::event_count; i++)
+                    if (group.has((Perf_Event)i))
+                        mask |= 1u << i;
+                this->available.fetch_or(mask, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Read group and add counts to worker slot. Only the
+             * owning worker writes the slot
+             *
+             * @author GerrFrog
+             *
+             * @param slot Worker index
+             * @param group Group of worker
+             * @param hashes Hashes since previous sample
+             */
+            void sample(size_t slot, Perf_Group &group, uint64_t hashes)
+            {
+                std::array<uint64_t, Perf_Group::event_count> deltas;
+                Slot &target = this->slots[slot];
+
+                if (!group.read(deltas))
+                    return;
+
+                for (size_t i = 0; i < deltas.size(); i++)
+                    target.events[i].store(
+                        target.events[i].load(std::memory_order_relaxed) + deltas[i],
+                        std::memory_order_relaxed
+                    );
+                target.hashes.store(
+                    target.hashes.load(std::memory_order_relaxed) + hashes,
+                    std::memory_order_release
+                );
+            }
+
+            /**
+             * @brief Get counts of worker
+             *
+             * @author GerrFrog
+             *
+             * @param slot Worker index
+             * @return Totals 
+             */
+            Totals get(size_t slot) const
+            {
+                Totals totals;
+                const Slot &source = this->slots[slot];
+
+                totals.hashes = source.hashes.load(std::memory_order_acquire);
+                for (size_t i = 0; i < totals.events.size(); i++)
+                    totals.events[i] = source.events[i].load(std::memory_order_relaxed);
+
+                return totals;
+            }
+
+            /**
+             * @brief Get counts of all workers
+             *
+             * @author GerrFrog
+             *
+             * @return Totals 
+             */
+            Totals get() const
+            {
+                Totals totals;
+
+                for (size_t slot = 0; slot < this->slots.size(); slot++)
+                {
+                    Totals worker = this->get(slot);
+
+                    totals.hashes += worker.hashes;
+                    for (size_t i = 0; i < totals.events.size(); i++)
+                        totals.events[i] += worker.events[i];
+                }
+
+                return totals;
+            }
+
+            /**
+             * @brief Get number of worker slots
+             *
+             * @author GerrFrog
+             *
+             * @return size_t 
+             */
+            size_t size() const { return this->slots.size(); }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../inc/statistics.hpp"
\ No newline at end of file
@@ -0,0 +1,1188 @@
+#pragma once
+
+#ifndef TUNER_HEADER
+#define TUNER_HEADER
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <cmath>
+#include <map>
+#include <set>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "../../solvers/inc/solvers.hpp"
+#include "../../logger/inc/logger.hpp"
+
+using std::string;
+
+/**
+ * @brief Implementators for Tuner objects
+ *
+ * @author GerrFrog
+ */
+namespace Tuner::Implementors
+{
+    /**
+     * @brief Read first line of file
+     *
+     * @author GerrFrog
+     *
+     * @param path Path to file
+     * @return string Empty if file can not be read
+     */
+    inline string read_line(const std::filesystem::path &path)
+    {
+        std::ifstream file(path);
+        string line;
+
+        std::getline(file, line);
+        while (!line.empty() && std::isspace((unsigned char)line.back()))
+            line.pop_back();
+
+        return line;
+    }
+
+    /**
+     * @brief Parse kernel CPU list ("0-3,8,10-11")
+     *
+     * @author GerrFrog
+     *
+     * @param list CPU list
+     * @return std::vector<unsigned> Sorted CPUs
+     */
+    inline std::vector<unsigned> parse_cpu_list(const string &list)
+    {
+        std::set<unsigned> cpus;
+        std::stringstream stream(list);
+        string range;
+
+        while (std::getline(stream, range, ','))
+        {
+            if (range.empty())
+                continue;
+
+            try {
+                size_t dash = range.find('-');
+                unsigned first = std::stoul(range.substr(0, dash));
+                unsigned last = dash == string::npos ? first : std::stoul(range.substr(dash + 1));
+
+                for (unsigned cpu = first; cpu <= last; cpu++)
+                    cpus.insert(cpu);
+            } catch (std::exception&) {
+                continue;
+            }
+        }
+
+        return std::vector<unsigned>(cpus.begin(), cpus.end());
+    }
+
+    /**
+     * @brief Parse cache size from sysfs ("32768K")
+     *
+     * @author GerrFrog
+     *
+     * @param size Cache size
+     * @return uint64_t Size in bytes (0 if unknown)
+     */
+    inline uint64_t parse_size(const string &size)
+    {
+        try {
+            size_t end;
+            uint64_t value = std::stoull(size, &end);
+
+            if (end < size.size() && (size[end] == 'K' || size[end] == 'k'))
+                value <<= 10;
+            else if (end < size.size() && size[end] == 'M')
+                value <<= 20;
+
+            return value;
+        } catch (std::exception&) {
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Logical CPU
+     *
+     * @author GerrFrog
+     */
+    struct Cpu
+    {
+        /**
+         * @brief Logical CPU number
+         *
+         * @author GerrFrog
+         */
+        unsigned id;
+
+        /**
+         * @brief Physical core (package and core id), SMT siblings
+         * share it
+         *
+         * @author GerrFrog
+         */
+        std::pair<int, int> core;
+    };
+
+    /**
+     * @brief CPUs sharing one L3 cache
+     *
+     * @author GerrFrog
+     */
+    struct Cache_Domain
+    {
+        /**
+         * @brief L3 size in bytes (0 if unknown)
+         *
+         * @author GerrFrog
+         */
+        uint64_t size = 0;
+
+        /**
+         * @brief CPUs of domain
+         *
+         * @author GerrFrog
+         */
+        std::vector<Cpu> cpus;
+    };
+
+    /**
+     * @brief Split CPUs of domain into one CPU of every physical core
+     * and remaining SMT siblings
+     *
+     * @author GerrFrog
+     *
+     * @param domain Cache domain
+     * @param primary First CPU of every core
+     * @param siblings Other CPUs
+     */
+    inline void split_cores(
+        const Cache_Domain &domain,
+        std::vector<unsigned> &primary,
+        std::vector<unsigned> &siblings
+    )
+    {
+        std::set<std::pair<int, int>> seen;
+
+        for (auto &cpu : domain.cpus)
+            if (seen.insert(cpu.core).second)
+                primary.push_back(cpu.id);
+            else
+                siblings.push_back(cpu.id);
+    }
+}
+
+/**
+ * @brief Thread count and placement tuning
+ *
+ * @author GerrFrog
+ */
+namespace Tuner
+{
+    /**
+     * @brief CPU and cache topology from sysfs
+     *
+     * @author GerrFrog
+     */
+    class Topology
+    {
+        private:
+            /**
+             * @brief L3 cache domains
+             *
+             * @author GerrFrog
+             */
+            std::vector<Implementors::Cache_Domain> domains;
+
+            /**
+             * @brief Number of physical cores
+             *
+             * @author GerrFrog
+             */
+            size_t cores = 0;
+
+            /**
+             * @brief Number of logical CPUs
+             *
+             * @author GerrFrog
+             */
+            size_t cpus = 0;
+
+            /**
+             * @brief CPU model
+             *
+             * @author GerrFrog
+             */
+            string model;
+
+            /**
+             * @brief Read CPU model from /proc/cpuinfo
+             *
+             * @author GerrFrog
+             *
+             * @return string
+             */
+            static string read_model()
+            {
+                std::ifstream cpuinfo("/proc/cpuinfo");
+                string line;
+
+                while (std::getline(cpuinfo, line))
+                    if (line.rfind("model name", 0) == 0 && line.find(':') != string::npos)
+                        return line.substr(line.find(':') + 2);
+
+                return "unknown";
+            }
+
+        public:
+            /**
+             * @brief Construct a new Topology object. Without sysfs every
+             * CPU is a core of one domain with unknown L3
+             *
+             * @author GerrFrog
+             *
+             * @param reserved CPUs left out (reserved for other threads)
+             * @param allowed CPUs the process may run on (empty for all)
+             * @param root Path to sysfs CPU directory
+             */
+            Topology(
+                const std::vector<unsigned> &reserved = {},
+                const std::vector<unsigned> &allowed = {},
+                const std::filesystem::path &root = "/sys/devices/system/cpu"
+            ) : model(read_model())
+            {
+                std::vector<unsigned> online = Implementors::parse_cpu_list(
+                    Implementors::read_line(root / "online")
+                );
+                std::map<string, Implementors::Cache_Domain> shared;
+                std::set<std::pair<int, int>> physical;
+
+                if (online.empty())
+                    for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); i++)
+                        online.push_back(i);
+
+                for (unsigned id : online)
+                {
+                    if (
+                        std::find(reserved.begin(), reserved.end(), id) != reserved.end() ||
+                        (!allowed.empty() && std::find(allowed.begin(), allowed.end(), id) == allowed.end())
+                    )
+                        continue;
+
+                    std::filesystem::path cpu = root / ("cpu" + std::to_string(id));
+                    string package = Implementors::read_line(cpu / "topology" / "physical_package_id");
+                    string core = Implementors::read_line(cpu / "topology" / "core_id");
+                    string l3_cpus = "all";
+                    uint64_t l3_size = 0;
+
+                    for (unsigned index = 0; index < 8; index++)
+                    {
+                        std::filesystem::path cache = cpu / "cache" / ("index" + std::to_string(index));
+
+                        if (Implementors::read_line(cache / "level") == "3")
+                        {
+                            l3_cpus = Implementors::read_line(cache / "shared_cpu_list");
+                            l3_size = Implementors::parse_size(Implementors::read_line(cache / "size"));
+                            break;
+                        }
+                    }
+
+                    Implementors::Cpu info{
+                        id,
+                        {
+                            package.empty() ? 0 : std::stoi(package),
+                            core.empty() ? (int)id : std::stoi(core)
+                        }
+                    };
+
+                    shared[l3_cpus].size = l3_size;
+                    shared[l3_cpus].cpus.push_back(info);
+                    physical.insert(info.core);
+                }
+
+                for (auto &domain : shared)
+                    this->domains.push_back(domain.second);
+
+                this->cores = physical.size();
+                this->cpus = online.size();
+            }
+
+            /**
+             * @brief Destroy the Topology object
+             *
+             * @author GerrFrog
+             */
+            ~Topology() = default;
+
+            /**
+             * @brief Get L3 cache domains
+             *
+             * @author GerrFrog
+             *
+             * @return const std::vector<Implementors::Cache_Domain>&
+             */
+            const std::vector<Implementors::Cache_Domain> &get_domains() const { return this->domains; }
+
+            /**
+             * @brief Get number of physical cores
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_cores() const { return this->cores; }
+
+            /**
+             * @brief Get number of logical CPUs
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_cpus() const { return this->cpus; }
+
+            /**
+             * @brief Describe host for cache of profiles
+             *
+             * @author GerrFrog
+             *
+             * @return string
+             */
+            string describe() const
+            {
+                std::ostringstream output;
+
+                output << this->model << ", " << this->cores << " cores, " << this->cpus << " cpus, L3";
+                for (auto &domain : this->domains)
+                    output << " " << (domain.size >> 20) << "M/" << domain.cpus.size();
+
+                return output.str();
+            }
+    };
+
+    /**
+     * @brief CPU limits of the process: cgroup v2 cpu.max quota of its
+     * cgroup and ancestors, and the CPUs of its affinity mask (cpuset)
+     *
+     * @author GerrFrog
+     */
+    class Cgroup_Limits
+    {
+        private:
+            /**
+             * @brief Quota in CPUs (0 if unlimited)
+             *
+             * @author GerrFrog
+             */
+            double quota = 0;
+
+            /**
+             * @brief Allowed CPUs (empty if unknown)
+             *
+             * @author GerrFrog
+             */
+            std::vector<unsigned> allowed;
+
+            /**
+             * @brief Path of cgroup of the process
+             *
+             * @author GerrFrog
+             */
+            std::filesystem::path group;
+
+        public:
+            /**
+             * @brief Construct a new Cgroup_Limits object
+             *
+             * @author GerrFrog
+             *
+             * @param root Mount point of cgroup hierarchy (v2 or hybrid)
+             */
+            Cgroup_Limits(
+                const std::filesystem::path &root = "/sys/fs/cgroup"
+            )
+            {
+                std::ifstream cgroups("/proc/self/cgroup");
+                std::error_code error;
+                std::filesystem::path mount = std::filesystem::exists(root / "cgroup.controllers", error) ? 
+                    root : 
+                    root / "unified";
+                std::vector<std::filesystem::path> levels;
+                string line;
+
+                // cgroup v2 entry: "0::/path"
+                while (std::getline(cgroups, line))
+                    if (line.rfind("0::", 0) == 0)
+                    {
+                        this->group = mount;
+                        levels.push_back(mount);
+                        for (auto &part : std::filesystem::path(line.substr(3)).relative_path())
+                            levels.push_back(this->group /= part);
+                    }
+
+                // Effective quota is the smallest one on the path from the root
+                for (auto &path : levels)
+                {
+                    std::istringstream max(Implementors::read_line(path / "cpu.max"));
+                    string limit;
+                    double period = 0;
+
+                    if (max >> limit >> period && limit != "max" && period > 0)
+                    {
+                        double cpus = std::stod(limit) / period;
+
+                        if (this->quota == 0 || cpus < this->quota)
+                            this->quota = cpus;
+                    }
+                }
+
+#ifdef __linux__
+                cpu_set_t set;
+
+                if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                    for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                        if (CPU_ISSET(cpu, &set))
+                            this->allowed.push_back(cpu);
+#endif
+            }
+
+            /**
+             * @brief Destroy the Cgroup_Limits object
+             *
+             * @author GerrFrog
+             */
+            ~Cgroup_Limits() = default;
+
+            /**
+             * @brief Get quota in CPUs
+             *
+             * @author GerrFrog
+             *
+             * @return double 0 if unlimited
+             */
+            double get_quota() const { return this->quota; }
+
+            /**
+             * @brief Get threads that fit into quota without throttling
+             *
+             * @author GerrFrog
+             *
+             * @return size_t 0 if unlimited
+             */
+            size_t get_threads() const
+            {
+                if (this->quota == 0)
+                    return 0;
+                return std::max<size_t>(1, (size_t)std::floor(this->quota));
+            }
+
+            /**
+             * @brief Get allowed CPUs
+             *
+             * @author GerrFrog
+             *
+             * @return const std::vector<unsigned>& Empty if unknown
+             */
+            const std::vector<unsigned> &get_allowed() const { return this->allowed; }
+
+            /**
+             * @brief Get path of cgroup
+             *
+             * @author GerrFrog
+             *
+             * @return const std::filesystem::path& Empty if not in cgroup v2
+             */
+            const std::filesystem::path &get_group() const { return this->group; }
+    };
+
+    /**
+     * @brief Tuned thread count and placement
+     *
+     * @author GerrFrog
+     */
+    struct Profile
+    {
+        /**
+         * @brief Number of worker threads
+         *
+         * @author GerrFrog
+         */
+        size_t threads = 0;
+
+        /**
+         * @brief CPUs for workers in order of worker index
+         *
+         * @author GerrFrog
+         */
+        std::vector<unsigned> cpus;
+
+        /**
+         * @brief Measured hashrate (0 if not benchmarked)
+         *
+         * @author GerrFrog
+         */
+        double hashrate = 0;
+    };
+
+    /**
+     * @brief Serialize profile
+     *
+     * @author GerrFrog
+     *
+     * @param json JSON
+     * @param profile Profile
+     */
+    inline void to_json(nlohmann::json &json, const Profile &profile)
+    {
+        json = {
+            {"threads", profile.threads},
+            {"cpus", profile.cpus},
+            {"hashrate", profile.hashrate}
+        };
+    }
+
+    /**
+     * @brief Deserialize profile
+     *
+     * @author GerrFrog
+     *
+     * @param json JSON
+     * @param profile Profile
+     */
+    inline void from_json(const nlohmann::json &json, Profile &profile)
+    {
+        profile.threads = json.at("threads").get<size_t>();
+        profile.cpus = json.at("cpus").get<std::vector<unsigned>>();
+        profile.hashrate = json.value("hashrate", 0.0);
+    }
+
+    /**
+     * @brief Startup tuner of worker threads. Proposes threads from L3
+     * size (one 2 MiB scratchpad per thread, physical cores before SMT
+     * siblings), optionally benchmarks candidates on the solver and
+     * caches the winner per host
+     *
+     * @author GerrFrog
+     */
+    class Auto_Tuner
+    {
+        public:
+            /**
+             * @brief L3 scratchpad of one thread (RANDOMX_SCRATCHPAD_L3)
+             *
+             * @author GerrFrog
+             */
+            static constexpr uint64_t scratchpad_size = 2 * 1024 * 1024;
+
+        private:
+            /**
+             * @brief Benchmark candidates
+             *
+             * @author GerrFrog
+             */
+            bool benchmark;
+
+            /**
+             * @brief Measured seconds of every candidate
+             *
+             * @author GerrFrog
+             */
+            double seconds;
+
+            /**
+             * @brief Path to cache of profiles
+             *
+             * @author GerrFrog
+             */
+            string cache;
+
+            /**
+             * @brief Hash host description (FNV-1a)
+             *
+             * @author GerrFrog
+             *
+             * @param description Host description
+             * @return string Fingerprint in HEX
+             */
+            static string fingerprint(const string &description)
+            {
+                uint64_t hash = 0xcbf29ce484222325ULL;
+                char output[17];
+
+                for (unsigned char c : description)
+                {
+                    hash ^= c;
+                    hash *= 0x100000001b3ULL;
+                }
+                std::snprintf(output, sizeof(output), "%016llx", (unsigned long long)hash);
+
+                return output;
+            }
+
+            /**
+             * @brief Load cache of profiles
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json Empty object if cache is missing
+             */
+            nlohmann::json load() const
+            {
+                std::ifstream file(this->cache);
+
+                if (!file)
+                    return nlohmann::json::object();
+
+                try {
+                    return nlohmann::json::parse(file);
+                } catch (std::exception &exp) {
+                    Logger::warning("tuner cache {}: {}", this->cache, exp.what());
+                    return nlohmann::json::object();
+                }
+            }
+
+            /**
+             * @brief Save cache of profiles
+             *
+             * @author GerrFrog
+             *
+             * @param profiles Profiles by fingerprint
+             */
+            void save(const nlohmann::json &profiles) const
+            {
+                std::ofstream file(this->cache);
+
+                if (!file)
+                {
+                    Logger::warning("tuner cache {}: cannot write", this->cache);
+                    return;
+                }
+                file << profiles.dump(4) << std::endl;
+            }
+
+            /**
+             * @brief Measure hashrate of solver with given threads
+             *
+             * @author GerrFrog
+             *
+             * @param solver Solver with published job
+             * @param threads Number of threads
+             * @return double Hashes per second
+             */
+            double measure(Solvers::Solver &solver, size_t threads) const
+            {
+                auto total = [&solver]() {
+                    uint64_t sum = 0;
+
+                    for (auto hashes : solver.get_hashes())
+                        sum += hashes;
+                    return sum;
+                };
+
+                solver.set_threads(threads);
+                // Warm-up: VMs, scratchpads and caches of new workers
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+
+                uint64_t before = total();
+                auto started = std::chrono::steady_clock::now();
+
+                std::this_thread::sleep_for(std::chrono::duration<double>(this->seconds));
+
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+                return (total() - before) / elapsed.count();
+            }
+
+            /**
+             * @brief Benchmark candidates around proposal. Candidates keep
+             * the CPU order of proposal
+             *
+             * @author GerrFrog
+             *
+             * @param solver Solver
+             * @param topology Topology
+             * @param proposal Proposed profile
+             * @return Profile Fastest candidate
+             */
+            Profile run_benchmark(
+                Solvers::Solver &solver,
+                const Topology &topology,
+                const Profile &proposal
+            ) const
+            {
+                std::set<size_t> candidates = {
+                    proposal.threads,
+                    topology.get_cores(),
+                    topology.get_cpus(),
+                    std::max<size_t>(proposal.threads, topology.get_domains().size() + 1) - topology.get_domains().size()
+                };
+                Profile best = proposal;
+
+                if (!solver.get_job())
+                    solver.set_job(Solvers::Implementors::synthetic_job("tuner", binary(32, 0)));
+
+                while (!solver.get_job())
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+                for (size_t threads : candidates)
+                {
+                    if (threads == 0 || threads > solver.get_max_threads())
+                        continue;
+
+                    double hashrate = this->measure(solver, threads);
+
+                    Logger::info("tuner: {} threads, {} H/s", threads, hashrate);
+                    if (hashrate > best.hashrate)
+                    {
+                        best.threads = threads;
+                        best.hashrate = hashrate;
+                    }
+                }
+
+                if (best.threads != proposal.threads)
+                {
+                    std::vector<unsigned> cpus = order(topology);
+
+                    best.cpus.assign(cpus.begin(), cpus.begin() + std::min(best.threads, cpus.size()));
+                }
+
+                return best;
+            }
+
+        public:
+            /**
+             * @brief Construct a new Auto_Tuner object
+             *
+             * @author GerrFrog
+             *
+             * @param config Tuner configuration (benchmark, seconds, cache)
+             */
+            Auto_Tuner(
+                const nlohmann::json &config
+            ) : benchmark(config.value("benchmark", false)),
+                seconds(config.value("seconds", 5.0)),
+                cache(config.value("cache", string("../tuner.json")))
+            { }
+
+            /**
+             * @brief Destroy the Auto_Tuner object
+             *
+             * @author GerrFrog
+             */
+            ~Auto_Tuner() = default;
+
+            /**
+             * @brief Order CPUs for placement: every L3 domain in turn,
+             * first one CPU of every physical core, then SMT siblings
+             *
+             * @author GerrFrog
+             *
+             * @param topology Topology
+             * @return std::vector<unsigned>
+             */
+            static std::vector<unsigned> order(const Topology &topology)
+            {
+                std::vector<std::vector<unsigned>> primary, siblings;
+                std::vector<unsigned> result;
+
+                for (auto &domain : topology.get_domains())
+                {
+                    primary.emplace_back();
+                    siblings.emplace_back();
+                    Implementors::split_cores(domain, primary.back(), siblings.back());
+                }
+
+                // Interleave domains, so a prefix of the order spreads over all L3
+                for (auto *list : {&primary, &siblings})
+                {
+                    size_t longest = 0;
+
+                    for (auto &domain : *list)
+                        longest = std::max(longest, domain.size());
+                    for (size_t i = 0; i < longest; i++)
+                        for (auto &domain : *list)
+                            if (i < domain.size())
+                                result.push_back(domain[i]);
+                }
+
+                return result;
+            }
+
+            /**
+             * @brief Propose threads from L3 size of every domain
+             *
+             * @author GerrFrog
+             *
+             * @param topology Topology
+             * @return Profile
+             */
+            static Profile propose(const Topology &topology)
+            {
+                Profile profile;
+                std::set<unsigned> selected;
+
+                for (auto &domain : topology.get_domains())
+                {
+                    std::vector<unsigned> primary, siblings;
+
+                    Implementors::split_cores(domain, primary, siblings);
+
+                    size_t threads = domain.size == 0 ?
+                        primary.size() :
+                        std::min<size_t>(domain.cpus.size(), std::max<uint64_t>(1, domain.size / scratchpad_size));
+
+                    primary.insert(primary.end(), siblings.begin(), siblings.end());
+                    selected.insert(primary.begin(), primary.begin() + threads);
+                }
+
+                for (unsigned cpu : order(topology))
+                    if (selected.count(cpu))
+                        profile.cpus.push_back(cpu);
+                profile.threads = profile.cpus.size();
+
+                return profile;
+            }
+
+            /**
+             * @brief Tune threads of solver. Uses cached profile of the
+             * host if there is one
+             *
+             * @author GerrFrog
+             *
+             * @param solver Solver
+             * @param mode Dataset mode of solver (part of fingerprint)
+             * @param topology CPUs available for workers
+             * @param place Pin workers to CPUs of profile
+             * @return Profile Applied profile
+             */
+            Profile tune(
+                Solvers::Solver &solver,
+                const string &mode,
+                const Topology &topology,
+                bool place
+            )
+            {
+                string description = topology.describe() + ", " + mode;
+                string key = this->fingerprint(description);
+                nlohmann::json profiles = this->load();
+                Profile profile;
+
+                if (
+                    profiles.contains(key) &&
+                    (!this->benchmark || profiles[key].value("hashrate", 0.0) > 0)
+                )
+                {
+                    profile = profiles[key].get<Profile>();
+                    Logger::info("tuner: cached profile {}, {} threads", key, profile.threads);
+                } else {
+                    profile = propose(topology);
+                    Logger::info("tuner: {}, proposed {} threads", description, profile.threads);
+
+                    if (this->benchmark)
+                    {
+                        // Candidates are prefixes of the CPU order
+                        if (place)
+                            solver.set_affinity(order(topology));
+                        profile = this->run_benchmark(solver, topology, profile);
+                    }
+
+                    profiles[key] = profile;
+                    profiles[key]["host"] = description;
+                    this->save(profiles);
+                }
+
+                if (place)
+                    solver.set_affinity(profile.cpus);
+                solver.set_threads(profile.threads);
+
+                return profile;
+            }
+    };
+
+    /**
+     * @brief Parks and unparks solver workers by host CPU pressure
+     * (/proc/pressure/cpu) or by load average of other processes.
+     * Parked workers keep their VMs, so changes are cheap
+     *
+     * @author GerrFrog
+     */
+    class Load_Governor
+    {
+        private:
+            /**
+             * @brief Solver
+             *
+             * @author GerrFrog
+             */
+            Solvers::Solver &solver;
+
+            /**
+             * @brief Signal source ("psi" or "load")
+             *
+             * @author GerrFrog
+             */
+            string source;
+
+            /**
+             * @brief Period of checks
+             *
+             * @author GerrFrog
+             */
+            std::chrono::milliseconds interval;
+
+            /**
+             * @brief PSI "some avg10" (percent) above which one worker is parked
+             *
+             * @author GerrFrog
+             */
+            double high;
+
+            /**
+             * @brief PSI "some avg10" (percent) below which one worker is unparked
+             *
+             * @author GerrFrog
+             */
+            double low;
+
+            /**
+             * @brief CPUs available for workers
+             *
+             * @author GerrFrog
+             */
+            size_t cpus;
+
+            /**
+             * @brief Governor is running
+             *
+             * @author GerrFrog
+             */
+            bool running = true;
+
+            /**
+             * @brief Guard for running
+             *
+             * @author GerrFrog
+             */
+            std::mutex mutex;
+
+            /**
+             * @brief Wakes up governor on stop
+             *
+             * @author GerrFrog
+             */
+            std::condition_variable wakeup;
+
+            /**
+             * @brief Governor thread
+             *
+             * @author GerrFrog
+             */
+            std::thread thread;
+
+            /**
+             * @brief Read CPU pressure of host
+             *
+             * @author GerrFrog
+             *
+             * @return double "some avg10" in percent (-1 if unavailable)
+             */
+            static double read_pressure()
+            {
+                std::ifstream pressure("/proc/pressure/cpu");
+                string word;
+
+                while (pressure >> word)
+                    if (word.rfind("avg10=", 0) == 0)
+                        return std::atof(word.c_str() + 6);
+
+                return -1;
+            }
+
+            /**
+             * @brief Read 1 minute load average of host
+             *
+             * @author GerrFrog
+             *
+             * @return double -1 if unavailable
+             */
+            static double read_load()
+            {
+                std::ifstream loadavg("/proc/loadavg");
+                double load = -1;
+
+                loadavg >> load;
+
+                return load;
+            }
+
+            /**
+             * @brief Choose number of hashing workers. Moves one worker
+             * per check, so lagging signals do not oscillate
+             *
+             * @author GerrFrog
+             *
+             * @param current Hashing workers
+             * @return size_t
+             */
+            size_t target(size_t current)
+            {
+                if (this->source == "psi")
+                {
+                    double pressure = read_pressure();
+
+                    if (pressure >= 0)
+                    {
+                        if (pressure > this->high)
+                            return current - 1;
+                        if (pressure < this->low)
+                            return current + 1;
+                        return current;
+                    }
+
+                    Logger::warning("governor: /proc/pressure/cpu is unavailable, using load average");
+                    this->source = "load";
+                }
+
+                double load = read_load();
+
+                if (load < 0)
+                    return current;
+
+                // Load of other processes leaves the rest of CPUs for workers
+                double others = std::max(0.0, load - current);
+                double free = this->cpus - others;
+
+                if (free < current - 0.5)
+                    return current - 1;
+                if (free >= current + 1)
+                    return current + 1;
+                return current;
+            }
+
+            /**
+             * @brief Governor loop
+             *
+             * @author GerrFrog
+             */
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+
+                while (!this->wakeup.wait_for(lock, this->interval, [this] { return !this->running; }))
+                {
+                    size_t threads = this->solver.get_threads();
+                    size_t current = this->solver.get_unparked();
+                    size_t next = std::min(std::max<size_t>(this->target(current), 1), threads);
+
+                    if (next == current)
+                        continue;
+
+                    // Unparked past threads means nothing is parked
+                    this->solver.set_unparked(next == threads ? SIZE_MAX : next);
+                    Logger::info("governor: {} of {} workers hashing", next, threads);
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct a new Load_Governor object
+             *
+             * @author GerrFrog
+             *
+             * @param config Governor configuration (source, interval, high, low)
+             * @param solver Solver
+             * @param cpus CPUs available for workers
+             */
+            Load_Governor(
+                const nlohmann::json &config,
+                Solvers::Solver &solver,
+                size_t cpus
+            ) : solver(solver),
+                source(config.value("source", string("psi"))),
+                interval((long)(config.value("interval", 5.0) * 1000)),
+                high(config.value("high", 10.0)),
+                low(config.value("low", 2.0)),
+                cpus(std::max<size_t>(cpus, 1)),
+                thread(&Load_Governor::run, this)
+            { }
+
+            /**
+             * @brief Destroy the Load_Governor object
+             *
+             * @author GerrFrog
+             */
+            ~Load_Governor()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->running = false;
+                }
+                this->wakeup.notify_all();
+                this->thread.join();
+            }
+    };
+
+    /**
+     * @brief Parse CPU list from configuration
+     *
+     * @author GerrFrog
+     *
+     * @param cpus Array of CPUs or kernel CPU list ("0-3,8")
+     * @return std::vector<unsigned>
+     */
+    inline std::vector<unsigned> parse_cpus(const nlohmann::json &cpus)
+    {
+        if (cpus.is_array())
+            return cpus.get<std::vector<unsigned>>();
+        if (cpus.is_string())
+            return Implementors::parse_cpu_list(cpus.get<string>());
+
+        return {};
+    }
+
+    /**
+     * @brief CPUs of workers from solver configuration. "affinity" is
+     * "off", "auto" (one thread per physical core first, SMT siblings
+     * last) or explicit CPU list
+     *
+     * @author GerrFrog
+     *
+     * @param config Solver configuration
+     * @param topology CPUs available for workers
+     * @return std::vector<unsigned> CPUs by worker index (empty if not pinned)
+     */
+    inline std::vector<unsigned> placement(const nlohmann::json &config, const Topology &topology)
+    {
+        nlohmann::json affinity = config.value("affinity", nlohmann::json("off"));
+
+        if (affinity == "off")
+            return {};
+        if (affinity == "auto")
+            return Auto_Tuner::order(topology);
+
+        return parse_cpus(affinity);
+    }
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
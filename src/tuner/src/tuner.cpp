@@ -0,0 +1 @@
+#include "../inc/tuner.hpp"
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <cstdint>
 #include <cstring>
+#include <array>
 
 #include "../../exceptions/inc/exceptions.hpp"
 
@@ -53,6 +54,25 @@ namespace Utilities
              */
             string encoded;
 
+            /**
+             * @brief Encode decoded binary (without stream, jobs of 
+             * pools are encoded on every message)
+             * 
+             * @author GerrFrog
+             */
+            void encode()
+            {
+                static constexpr char digits[] = "0123456789abcdef";
+
+                encoded.resize(decoded.size() * 2);
+
+                for (size_t i = 0; i < decoded.size(); i++)
+                {
+                    encoded[2 * i] = digits[decoded[i] >> 4];
+                    encoded[2 * i + 1] = digits[decoded[i] & 0x0F];
+                }
+            }
+
         public:
             /**
              * @brief Construct a new hex string object
@@ -93,10 +113,7 @@ namespace Utilities
             HEX_String(const binary& bin_data) :
                 decoded(bin_data)
             {
-                std::stringstream ss;
-                for (auto b : decoded)
-                    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(b);
-                encoded = ss.str();
+                encode();
             }
 
             /**
@@ -110,10 +127,7 @@ namespace Utilities
                 decoded(((unsigned char*)&num_data), 
                 ((unsigned char*)&num_data) + sizeof(uint32_t))
             {
-                std::stringstream ss;
-                for (auto b : decoded)
-                    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(b);
-                encoded = ss.str();
+                encode();
             }
 
             /**
@@ -240,7 +254,48 @@ namespace Utilities::Pools
      */
     struct New_Job_V2
     {
-        // TODO: Implement
+        /**
+         * @brief Channel ID
+         * 
+         * @author GerrFrog
+         */
+        uint32_t channel_id = 0;
+
+        /**
+         * @brief Job ID
+         * 
+         * @author GerrFrog
+         */
+        uint32_t job_id = 0;
+
+        /**
+         * @brief Job waits for SetNewPrevHash (min_ntime is empty)
+         * 
+         * @author GerrFrog
+         */
+        bool future = true;
+
+        /**
+         * @brief Smallest ntime (timestamp) of job
+         * 
+         * @author GerrFrog
+         */
+        uint32_t min_ntime = 0;
+
+        /**
+         * @brief Version (major, minor version and transaction count
+         * of block)
+         * 
+         * @author GerrFrog
+         */
+        uint32_t version = 0;
+
+        /**
+         * @brief Merkle root (tree hash of transactions)
+         * 
+         * @author GerrFrog
+         */
+        std::array<unsigned char, 32> merkle_root{};
     };
 }
 
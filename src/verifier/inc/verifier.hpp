@@ -0,0 +1,1028 @@
+#pragma once
+
+#ifndef VERIFIER_HEADER
+#define VERIFIER_HEADER
+
+#include <randomx.h>
+#include <nlohmann/json.hpp>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <set>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../requests/inc/requests.hpp"
+#include "../../solvers/inc/solvers.hpp"
+#include "../../statistics/inc/statistics.hpp"
+#include "../../utilities/inc/utilities.hpp"
+#include "../../logger/inc/logger.hpp"
+
+using std::string;
+
+/**
+ * @brief Unix domain socket protocol
+ *
+ * @author GerrFrog
+ */
+using local = net::local::stream_protocol;
+
+/**
+ * @brief Implementators for Verifier objects
+ *
+ * @author GerrFrog
+ */
+namespace Verifier::Implementors
+{
+    /**
+     * @brief Result of one share
+     *
+     * @author GerrFrog
+     */
+    enum class Verdict : int8_t
+    {
+        Malformed = -1,     ///< share cannot be parsed
+        Invalid = 0,        ///< hash differs from claimed hash
+        Valid = 1           ///< hash is equal to claimed hash
+    };
+
+    /**
+     * @brief Share to verify
+     *
+     * @author GerrFrog
+     */
+    struct Share
+    {
+        /**
+         * @brief Seed hash
+         *
+         * @author GerrFrog
+         */
+        binary seed_hash;
+
+        /**
+         * @brief Hashing blob with nonce
+         *
+         * @author GerrFrog
+         */
+        binary blob;
+
+        /**
+         * @brief Claimed hash
+         *
+         * @author GerrFrog
+         */
+        binary hash;
+
+        /**
+         * @brief Share is parsed
+         *
+         * @author GerrFrog
+         */
+        bool parsed = false;
+    };
+
+    /**
+     * @brief Batch of shares. Shares are verified by any worker, results
+     * keep order of shares
+     *
+     * @author GerrFrog
+     */
+    struct Batch
+    {
+        /**
+         * @brief Shares
+         *
+         * @author GerrFrog
+         */
+        std::vector<Share> shares;
+
+        /**
+         * @brief Results in order of shares
+         *
+         * @author GerrFrog
+         */
+        std::vector<Verdict> results;
+
+        /**
+         * @brief Shares not verified yet
+         *
+         * @author GerrFrog
+         */
+        std::atomic<size_t> remaining{0};
+
+        /**
+         * @brief Time when batch was received
+         *
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point received;
+
+        /**
+         * @brief Time when first share was taken by a worker
+         *
+         * @author GerrFrog
+         */
+        std::chrono::steady_clock::time_point started;
+
+        /**
+         * @brief First share is taken
+         *
+         * @author GerrFrog
+         */
+        std::once_flag start;
+
+        /**
+         * @brief Called by the worker which verified the last share (moved
+         * out of the batch before the call)
+         *
+         * @author GerrFrog
+         */
+        std::function<void()> done;
+    };
+
+    /**
+     * @brief Offset of the 32-bit nonce in hashing blob
+     *
+     * @author GerrFrog
+     */
+    constexpr size_t nonce_offset = 39;
+
+    /**
+     * @brief Parse share: {"seed_hash", "blob", "nonce" (optional, HEX of
+     * 4 bytes as in Stratum submit), "hash"}
+     *
+     * @author GerrFrog
+     *
+     * @param item JSON share
+     * @return Share Share (not parsed if fields are missing or wrong)
+     */
+    inline Share parse_share(const nlohmann::json &item)
+    {
+        Share share;
+
+        if (
+            !item.is_object() ||
+            !item.contains("seed_hash") || !item["seed_hash"].is_string() ||
+            !item.contains("blob") || !item["blob"].is_string() ||
+            !item.contains("hash") || !item["hash"].is_string()
+        )
+            return share;
+
+        share.seed_hash = Utilities::HEX_String(item["seed_hash"].get<string>()).get_decoded();
+        share.blob = Utilities::HEX_String(item["blob"].get<string>()).get_decoded();
+        share.hash = Utilities::HEX_String(item["hash"].get<string>()).get_decoded();
+
+        if (item.contains("nonce"))
+        {
+            if (!item["nonce"].is_string())
+                return share;
+
+            binary nonce = Utilities::HEX_String(item["nonce"].get<string>()).get_decoded();
+
+            if (nonce.size() != sizeof(uint32_t) || share.blob.size() < nonce_offset + sizeof(uint32_t))
+                return share;
+            std::memcpy(share.blob.data() + nonce_offset, nonce.data(), nonce.size());
+        }
+
+        share.parsed =
+            !share.seed_hash.empty() &&
+            !share.blob.empty() &&
+            share.hash.size() == RANDOMX_HASH_SIZE;
+
+        return share;
+    }
+
+    /**
+     * @brief Light or full virtual machine of a worker with the memory
+     * it points to
+     *
+     * @author GerrFrog
+     */
+    struct Worker_VM
+    {
+        /**
+         * @brief Virtual machine
+         *
+         * @author GerrFrog
+         */
+        std::unique_ptr<randomx_vm, void(*)(randomx_vm*)> vm{nullptr, randomx_destroy_vm};
+
+        /**
+         * @brief Seed hash of cache or dataset of the VM
+         *
+         * @author GerrFrog
+         */
+        binary seed_hash;
+
+        /**
+         * @brief Cache of the VM (light mode)
+         *
+         * @author GerrFrog
+         */
+        std::shared_ptr<randomx_cache> cache;
+
+        /**
+         * @brief Dataset of the VM (full mode)
+         *
+         * @author GerrFrog
+         */
+        std::shared_ptr<randomx_dataset> dataset;
+    };
+}
+
+/**
+ * @brief Batch verification of shares
+ *
+ * @author GerrFrog
+ */
+namespace Verifier
+{
+    /**
+     * @brief Pool of VMs verifying shares on all cores. Caches are
+     * reused per seed hash. In full mode the dataset follows the newest
+     * seed; shares of older seeds and shares received while the dataset
+     * is built are verified in light mode
+     *
+     * @author GerrFrog
+     */
+    class VM_Pool
+    {
+        private:
+            /**
+             * @brief Flags of light VMs and caches
+             *
+             * @author GerrFrog
+             */
+            randomx_flags flags;
+
+            /**
+             * @brief Dataset mode
+             *
+             * @author GerrFrog
+             */
+            bool full_memory;
+
+            /**
+             * @brief Initialized caches by seed hash
+             *
+             * @author GerrFrog
+             */
+            Solvers::Implementors::Cache_Storage caches;
+
+            /**
+             * @brief Shares waiting for a worker: batch and index of share
+             *
+             * @author GerrFrog
+             */
+            std::deque<std::pair<std::shared_ptr<Implementors::Batch>, size_t>> tasks;
+
+            /**
+             * @brief Guard for tasks and stop
+             *
+             * @author GerrFrog
+             */
+            std::mutex tasks_mutex;
+
+            /**
+             * @brief Wakes workers on new tasks
+             *
+             * @author GerrFrog
+             */
+            std::condition_variable tasks_cv;
+
+            /**
+             * @brief Pool is stopped
+             *
+             * @author GerrFrog
+             */
+            bool stop = false;
+
+            /**
+             * @brief Workers
+             *
+             * @author GerrFrog
+             */
+            std::vector<std::thread> workers;
+
+            /**
+             * @brief Seed hash of dataset (full mode)
+             *
+             * @author GerrFrog
+             */
+            binary dataset_seed;
+
+            /**
+             * @brief Dataset of the newest seed (full mode)
+             *
+             * @author GerrFrog
+             */
+            std::shared_ptr<randomx_dataset> dataset;
+
+            /**
+             * @brief Seeds whose dataset was built, never built again
+             *
+             * @author GerrFrog
+             */
+            std::set<binary> built_seeds;
+
+            /**
+             * @brief Thread building dataset
+             *
+             * @author GerrFrog
+             */
+            std::thread builder;
+
+            /**
+             * @brief Dataset is being built
+             *
+             * @author GerrFrog
+             */
+            bool building = false;
+
+            /**
+             * @brief Guard for dataset, dataset_seed, built_seeds, builder
+             * and building
+             *
+             * @author GerrFrog
+             */
+            std::mutex dataset_mutex;
+
+            /**
+             * @brief Verified shares by verdict (malformed, invalid, valid)
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> verdicts[3] = {};
+
+            /**
+             * @brief Shares verified with dataset
+             *
+             * @author GerrFrog
+             */
+            std::atomic<uint64_t> full_hashes{0};
+
+            /**
+             * @brief Get initialized cache for seed
+             *
+             * @author GerrFrog
+             *
+             * @param seed_hash Seed hash
+             * @return std::shared_ptr<randomx_cache>
+             */
+            std::shared_ptr<randomx_cache> get_cache(const binary &seed_hash)
+            {
+                // One Argon2 fill per seed, not one per worker
+                return this->caches.get(seed_hash);
+            }
+
+            /**
+             * @brief Build dataset for seed with all workers' count of threads
+             *
+             * @author GerrFrog
+             *
+             * @param seed_hash Seed hash
+             */
+            void build(binary seed_hash)
+            {
+                auto started = std::chrono::steady_clock::now();
+                std::shared_ptr<randomx_cache> cache = this->get_cache(seed_hash);
+                randomx_dataset *dataset = randomx_alloc_dataset((randomx_flags)(this->flags | RANDOMX_FLAG_FULL_MEM));
+
+                if (dataset == nullptr)
+                {
+                    std::lock_guard<std::mutex> lock(this->dataset_mutex);
+
+                    this->building = false;
+                    Logger::error("verifier: cannot allocate dataset, verifying in light mode");
+                    return;
+                }
+
+                unsigned long item_count = randomx_dataset_item_count();
+                unsigned long per_thread = item_count / this->workers.size();
+                std::vector<std::thread> init_threads;
+
+                for (size_t i = 0; i < this->workers.size(); i++)
+                {
+                    unsigned long start = i * per_thread;
+                    unsigned long count = (i == this->workers.size() - 1) ? item_count - start : per_thread;
+
+                    init_threads.emplace_back(randomx_init_dataset, dataset, cache.get(), start, count);
+                }
+                for (auto &thread : init_threads)
+                    thread.join();
+
+                std::lock_guard<std::mutex> lock(this->dataset_mutex);
+
+                this->dataset = std::shared_ptr<randomx_dataset>(dataset, randomx_release_dataset);
+                this->dataset_seed = seed_hash;
+                this->building = false;
+                Logger::info(
+                    "verifier: dataset is ready in {} s",
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()
+                );
+            }
+
+            /**
+             * @brief Get dataset for seed. Starts building it for a new
+             * seed
+             *
+             * @author GerrFrog
+             *
+             * @param seed_hash Seed hash
+             * @return std::shared_ptr<randomx_dataset> Dataset (empty if
+             * it is not ready)
+             */
+            std::shared_ptr<randomx_dataset> get_dataset(const binary &seed_hash)
+            {
+                std::lock_guard<std::mutex> lock(this->dataset_mutex);
+
+                if (this->dataset && this->dataset_seed == seed_hash)
+                    return this->dataset;
+
+                // Older seeds are not built again, so shares around seed change do not thrash
+                if (!this->building && this->built_seeds.insert(seed_hash).second)
+                {
+                    // Previous builder does not need the lock any more
+                    if (this->builder.joinable())
+                        this->builder.join();
+                    this->building = true;
+                    this->builder = std::thread(&VM_Pool::build, this, seed_hash);
+                }
+
+                return nullptr;
+            }
+
+            /**
+             * @brief Point VM to memory of seed, VM is created on first use
+             *
+             * @author GerrFrog
+             *
+             * @param worker_vm VM of worker
+             * @param seed_hash Seed hash
+             * @param dataset Dataset (full VM)
+             * @param cache Cache (light VM)
+             * @param flags Flags of VM
+             */
+            void prepare(
+                Implementors::Worker_VM &worker_vm,
+                const binary &seed_hash,
+                std::shared_ptr<randomx_dataset> dataset,
+                std::shared_ptr<randomx_cache> cache,
+                randomx_flags flags
+            )
+            {
+                if (worker_vm.vm && worker_vm.seed_hash == seed_hash)
+                    return;
+
+                if (!worker_vm.vm)
+                {
+                    worker_vm.vm.reset(randomx_create_vm(flags, cache.get(), dataset.get()));
+                    if (!worker_vm.vm)
+                        throw Exceptions::Solvers::RandomX_Error(
+                            "Cannot create RandomX virtual machine"
+                        );
+                }
+                else if (dataset)
+                    randomx_vm_set_dataset(worker_vm.vm.get(), dataset.get());
+                else
+                    randomx_vm_set_cache(worker_vm.vm.get(), cache.get());
+
+                worker_vm.seed_hash = seed_hash;
+                worker_vm.cache = cache;
+                worker_vm.dataset = dataset;
+            }
+
+            /**
+             * @brief Verify shares until pool is stopped
+             *
+             * @author GerrFrog
+             */
+            void work()
+            {
+                Implementors::Worker_VM light, full;
+
+                while (true)
+                {
+                    std::shared_ptr<Implementors::Batch> batch;
+                    size_t index;
+
+                    {
+                        std::unique_lock<std::mutex> lock(this->tasks_mutex);
+
+                        this->tasks_cv.wait(lock, [this]() {
+                            return this->stop || !this->tasks.empty();
+                        });
+                        if (this->stop)
+                            return;
+
+                        batch = this->tasks.front().first;
+                        index = this->tasks.front().second;
+                        this->tasks.pop_front();
+                    }
+
+                    std::call_once(batch->start, [&batch]() {
+                        batch->started = std::chrono::steady_clock::now();
+                    });
+
+                    const Implementors::Share &share = batch->shares[index];
+                    Implementors::Verdict verdict = Implementors::Verdict::Malformed;
+
+                    if (share.parsed)
+                    {
+                        std::shared_ptr<randomx_dataset> dataset = this->full_memory ?
+                            this->get_dataset(share.seed_hash) :
+                            nullptr;
+                        Implementors::Worker_VM &worker_vm = dataset ? full : light;
+                        char hash[RANDOMX_HASH_SIZE];
+
+                        try {
+                            if (dataset)
+                            {
+                                this->prepare(full, share.seed_hash, dataset, nullptr, (randomx_flags)(this->flags | RANDOMX_FLAG_FULL_MEM));
+                                this->full_hashes++;
+                            }
+                            else
+                                this->prepare(light, share.seed_hash, nullptr, this->get_cache(share.seed_hash), this->flags);
+
+                            randomx_calculate_hash(worker_vm.vm.get(), share.blob.data(), share.blob.size(), hash);
+                            verdict = std::memcmp(hash, share.hash.data(), sizeof(hash)) == 0 ?
+                                Implementors::Verdict::Valid :
+                                Implementors::Verdict::Invalid;
+                        } catch (const std::exception &err) {
+                            Logger::error("verifier: {}", err.what());
+                        }
+                    }
+
+                    batch->results[index] = verdict;
+                    this->verdicts[(int)verdict + 1]++;
+
+                    if (--batch->remaining == 0)
+                    {
+                        // Moved out: done may own the batch
+                        auto done = std::move(batch->done);
+
+                        done();
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct a new VM_Pool object
+             *
+             * @author GerrFrog
+             *
+             * @param config Verifier configuration (mode, threads, caches)
+             */
+            VM_Pool(
+                const nlohmann::json &config
+            ) : flags(randomx_get_flags()),
+                full_memory(config.value("mode", string("light")) == "full"),
+                caches(flags, std::max<size_t>(config.value("caches", (size_t)2), 1) * Solvers::Implementors::Cache_Storage::cache_memory)
+            {
+                size_t threads = config.value("threads", (size_t)0);
+
+                if (threads == 0)
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+
+                for (size_t i = 0; i < threads; i++)
+                    this->workers.emplace_back(&VM_Pool::work, this);
+            }
+
+            /**
+             * @brief Destroy the VM_Pool object
+             *
+             * @author GerrFrog
+             */
+            ~VM_Pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(this->tasks_mutex);
+
+                    this->stop = true;
+                }
+                this->tasks_cv.notify_all();
+                for (auto &worker : this->workers)
+                    worker.join();
+
+                // Workers are stopped, no build is started any more
+                if (this->builder.joinable())
+                    this->builder.join();
+            }
+
+            /**
+             * @brief Queue batch. Batch::done is called from a worker
+             * (or here for an empty batch)
+             *
+             * @author GerrFrog
+             *
+             * @param batch Batch
+             */
+            void submit(std::shared_ptr<Implementors::Batch> batch)
+            {
+                batch->results.assign(batch->shares.size(), Implementors::Verdict::Malformed);
+                batch->remaining = batch->shares.size();
+
+                if (batch->shares.empty())
+                {
+                    auto done = std::move(batch->done);
+
+                    batch->started = std::chrono::steady_clock::now();
+                    done();
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(this->tasks_mutex);
+
+                    for (size_t i = 0; i < batch->shares.size(); i++)
+                        this->tasks.emplace_back(batch, i);
+                }
+                this->tasks_cv.notify_all();
+            }
+
+            /**
+             * @brief Get statistics of verified shares
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json
+             */
+            nlohmann::json stats()
+            {
+                std::lock_guard<std::mutex> lock(this->dataset_mutex);
+
+                return {
+                    {"threads", this->workers.size()},
+                    {"mode", this->full_memory ? "full" : "light"},
+                    {"valid", this->verdicts[2].load()},
+                    {"invalid", this->verdicts[1].load()},
+                    {"malformed", this->verdicts[0].load()},
+                    {"full_hashes", this->full_hashes.load()},
+                    {"caches", this->caches.size()},
+                    {"dataset_seed", this->dataset ? Utilities::HEX_String(this->dataset_seed).get_encoded() : ""}
+                };
+            }
+    };
+
+    /**
+     * @brief Local socket server of the VM pool. Every line of a client
+     * is a JSON request, every request gets one JSON line back
+     *
+     * @note {"id": 1, "shares": [{"seed_hash", "blob", "nonce", "hash"}]}
+     * -> {"id": 1, "results": [true, false, null], "queue_ms", "latency_ms"}
+     * (null for malformed share)
+     * @note {"id": 2, "method": "stats"} -> counters and batch latency
+     *
+     * @author GerrFrog
+     */
+    class Verifier_Server
+    {
+        private:
+            /**
+             * @brief One client connection. Batches of a connection are
+             * verified one after another
+             *
+             * @author GerrFrog
+             */
+            class Session : public std::enable_shared_from_this<Session>
+            {
+                private:
+                    /**
+                     * @brief Server
+                     *
+                     * @author GerrFrog
+                     */
+                    Verifier_Server &server;
+
+                    /**
+                     * @brief Client socket
+                     *
+                     * @author GerrFrog
+                     */
+                    local::socket socket;
+
+                    /**
+                     * @brief Buffer for reading
+                     *
+                     * @author GerrFrog
+                     */
+                    net::streambuf buffer;
+
+                    /**
+                     * @brief Current response
+                     *
+                     * @author GerrFrog
+                     */
+                    string response;
+
+                    /**
+                     * @brief Read next request
+                     *
+                     * @author GerrFrog
+                     */
+                    void read()
+                    {
+                        net::async_read_until(
+                            this->socket,
+                            this->buffer,
+                            '\n',
+                            [self = this->shared_from_this()](beast::error_code err, std::size_t bytes) {
+                                if (err)
+                                    return;
+
+                                string line(
+                                    net::buffers_begin(self->buffer.data()),
+                                    net::buffers_begin(self->buffer.data()) + bytes
+                                );
+
+                                self->buffer.consume(bytes);
+                                self->handle(line);
+                            }
+                        );
+                    }
+
+                    /**
+                     * @brief Handle request
+                     *
+                     * @author GerrFrog
+                     *
+                     * @param line Request
+                     */
+                    void handle(const string &line)
+                    {
+                        nlohmann::json request = nlohmann::json::parse(line, nullptr, false);
+
+                        if (request.is_discarded() || !request.is_object())
+                            return this->write({{"id", nullptr}, {"error", "expected JSON object"}});
+
+                        nlohmann::json id = request.value("id", nlohmann::json());
+
+                        if (request.value("method", string("verify")) == "stats")
+                            return this->write({{"id", id}, {"result", this->server.stats()}});
+                        if (!request.contains("shares") || !request["shares"].is_array())
+                            return this->write({{"id", id}, {"error", "expected \"shares\" array"}});
+
+                        auto batch = std::make_shared<Implementors::Batch>();
+
+                        batch->received = std::chrono::steady_clock::now();
+                        for (auto &item : request["shares"])
+                            batch->shares.push_back(Implementors::parse_share(item));
+
+                        // Last share may be verified on a worker: reply from the server thread
+                        batch->done = [self = this->shared_from_this(), batch, id]() {
+                            net::post(self->socket.get_executor(), [self, batch, id]() {
+                                self->reply(*batch, id);
+                            });
+                        };
+                        this->server.pool.submit(batch);
+                    }
+
+                    /**
+                     * @brief Write results of batch
+                     *
+                     * @author GerrFrog
+                     *
+                     * @param batch Verified batch
+                     * @param id Request ID
+                     */
+                    void reply(Implementors::Batch &batch, const nlohmann::json &id)
+                    {
+                        auto now = std::chrono::steady_clock::now();
+                        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - batch.received);
+                        nlohmann::json results = nlohmann::json::array();
+
+                        for (auto verdict : batch.results)
+                            if (verdict == Implementors::Verdict::Malformed)
+                                results.push_back(nullptr);
+                            else
+                                results.push_back(verdict == Implementors::Verdict::Valid);
+
+                        this->server.latency.record(latency);
+                        this->server.batches++;
+
+                        this->write({
+                            {"id", id},
+                            {"results", results},
+                            {"queue_ms", std::chrono::duration<double, std::milli>(batch.started - batch.received).count()},
+                            {"latency_ms", latency.count() / 1e3}
+                        });
+                    }
+
+                    /**
+                     * @brief Write response and read next request
+                     *
+                     * @author GerrFrog
+                     *
+                     * @param message Response
+                     */
+                    void write(const nlohmann::json &message)
+                    {
+                        this->response = message.dump() + "\n";
+
+                        net::async_write(
+                            this->socket,
+                            net::buffer(this->response),
+                            [self = this->shared_from_this()](beast::error_code err, std::size_t) {
+                                if (!err)
+                                    self->read();
+                            }
+                        );
+                    }
+
+                public:
+                    /**
+                     * @brief Construct a new Session object
+                     *
+                     * @author GerrFrog
+                     *
+                     * @param server Server
+                     * @param socket Accepted socket
+                     */
+                    Session(
+                        Verifier_Server &server,
+                        local::socket &&socket
+                    ) : server(server),
+                        socket(std::move(socket))
+                    { }
+
+                    /**
+                     * @brief Destroy the Session object
+                     *
+                     * @author GerrFrog
+                     */
+                    ~Session() = default;
+
+                    /**
+                     * @brief Start reading requests
+                     *
+                     * @author GerrFrog
+                     */
+                    void run()
+                    {
+                        this->read();
+                    }
+            };
+
+            /**
+             * @brief Path of the socket
+             *
+             * @author GerrFrog
+             */
+            string path;
+
+            /**
+             * @brief Pool of VMs
+             *
+             * @author GerrFrog
+             */
+            VM_Pool pool;
+
+            /**
+             * @brief Input/Output context
+             *
+             * @author GerrFrog
+             */
+            net::io_context io_context;
+
+            /**
+             * @brief Acceptor of connections
+             *
+             * @author GerrFrog
+             */
+            local::acceptor acceptor;
+
+            /**
+             * @brief Stops the server on SIGINT and SIGTERM
+             *
+             * @author GerrFrog
+             */
+            net::signal_set signals;
+
+            /**
+             * @brief Latency of batches from receiving to results
+             *
+             * @author GerrFrog
+             */
+            Statistics::Histogram latency;
+
+            /**
+             * @brief Verified batches
+             *
+             * @author GerrFrog
+             */
+            uint64_t batches = 0;
+
+            /**
+             * @brief Accept next connection
+             *
+             * @author GerrFrog
+             */
+            void accept()
+            {
+                this->acceptor.async_accept(
+                    [this](beast::error_code err, local::socket socket) {
+                        if (!err)
+                            std::make_shared<Session>(*this, std::move(socket))->run();
+
+                        if (this->acceptor.is_open())
+                            this->accept();
+                    }
+                );
+            }
+
+            /**
+             * @brief Get statistics of pool and batch latency
+             *
+             * @author GerrFrog
+             *
+             * @return nlohmann::json
+             */
+            nlohmann::json stats()
+            {
+                nlohmann::json stats = this->pool.stats();
+                nlohmann::json buckets = nlohmann::json::array();
+                auto &bounds = this->latency.get_bounds();
+
+                for (size_t i = 0; i < bounds.size(); i++)
+                    buckets.push_back({{"le", bounds[i]}, {"count", this->latency.get_cumulative(i)}});
+
+                stats["batches"] = this->batches;
+                stats["latency"] = {
+                    {"count", this->latency.get_count()},
+                    {"sum_seconds", this->latency.get_sum()},
+                    {"buckets", buckets}
+                };
+
+                return stats;
+            }
+
+        public:
+            /**
+             * @brief Construct a new Verifier_Server object
+             *
+             * @author GerrFrog
+             *
+             * @param config Verifier configuration (socket, mode, threads, caches)
+             */
+            Verifier_Server(
+                const nlohmann::json &config
+            ) : path(config.value("socket", string("/tmp/cpuminer-verifier.sock"))),
+                pool(config),
+                acceptor(io_context),
+                signals(io_context, SIGINT, SIGTERM),
+                latency({0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10})
+            {
+                // Socket of a previous run
+                std::remove(this->path.c_str());
+
+                this->acceptor.open(local());
+                this->acceptor.bind(local::endpoint(this->path));
+                this->acceptor.listen();
+                this->signals.async_wait([this](beast::error_code, int) {
+                    this->io_context.stop();
+                });
+
+                Logger::info("verifier: listening on {}", this->path);
+            }
+
+            /**
+             * @brief Destroy the Verifier_Server object
+             *
+             * @author GerrFrog
+             */
+            ~Verifier_Server()
+            {
+                std::remove(this->path.c_str());
+            }
+
+            /**
+             * @brief Serve until SIGINT or SIGTERM
+             *
+             * @author GerrFrog
+             */
+            void run()
+            {
+                this->accept();
+                this->io_context.run();
+            }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
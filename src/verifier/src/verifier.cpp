@@ -0,0 +1 @@
+#include "../inc/verifier.hpp"
\ No newline at end of file
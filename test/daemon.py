@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Stand-in for the JSON-RPC of monerod used by solo mining tests.
+
+Serves get_info, get_block_template and submit_block. Templates have a
+v2 miner transaction with reserved space in extra and a number of fake
+transaction hashes; blockhashing_blob is computed here independently of
+the miner. Submitted blocks are checked against the template and, when
+the cpuminer Python module is importable, against the difficulty.
+"""
+
+import argparse
+import json
+import os
+import signal
+import struct
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ROUND_CONSTANTS = [
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808A, 0x8000000080008000,
+    0x000000000000808B, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008A, 0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+    0x000000008000808B, 0x800000000000008B, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800A, 0x800000008000000A,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+]
+ROTATIONS = [
+    [0, 36, 3, 41, 18], [1, 44, 10, 45, 2], [62, 6, 43, 15, 61],
+    [28, 55, 25, 21, 56], [27, 20, 39, 8, 14],
+]
+MASK = (1 << 64) - 1
+
+
+def keccak_f(state):
+    for rc in ROUND_CONSTANTS:
+        c = [state[x][0] ^ state[x][1] ^ state[x][2] ^ state[x][3] ^ state[x][4] for x in range(5)]
+        d = [c[(x - 1) % 5] ^ (((c[(x + 1) % 5] << 1) | (c[(x + 1) % 5] >> 63)) & MASK) for x in range(5)]
+        state = [[state[x][y] ^ d[x] for y in range(5)] for x in range(5)]
+        b = [[0] * 5 for _ in range(5)]
+        for x in range(5):
+            for y in range(5):
+                r = ROTATIONS[x][y]
+                b[y][(2 * x + 3 * y) % 5] = ((state[x][y] << r) | (state[x][y] >> (64 - r))) & MASK if r else state[x][y]
+        state = [[b[x][y] ^ (~b[(x + 1) % 5][y] & b[(x + 2) % 5][y]) for y in range(5)] for x in range(5)]
+        state[0][0] ^= rc
+    return state
+
+
+def keccak(data):
+    """Keccak-256 with original padding (cn_fast_hash)."""
+    rate = 136
+    data = bytearray(data) + b"\x01" + bytes(-(len(data) + 1) % rate)
+    data[-1] |= 0x80
+    state = [[0] * 5 for _ in range(5)]
+    for block in range(0, len(data), rate):
+        for i in range(rate // 8):
+            state[i % 5][i // 5] ^= struct.unpack_from("<Q", data, block + 8 * i)[0]
+        state = keccak_f(state)
+    return b"".join(struct.pack("<Q", state[i % 5][i // 5]) for i in range(4))
+
+
+def varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def tree_hash(hashes):
+    """crypto/tree-hash.c"""
+    if len(hashes) == 1:
+        return hashes[0]
+    if len(hashes) == 2:
+        return keccak(hashes[0] + hashes[1])
+    count = 1
+    while count * 2 < len(hashes):
+        count *= 2
+    copied = 2 * count - len(hashes)
+    nodes = list(hashes[:copied])
+    for i in range(copied, len(hashes), 2):
+        nodes.append(keccak(hashes[i] + hashes[i + 1]))
+    while len(nodes) > 1:
+        nodes = [keccak(nodes[i] + nodes[i + 1]) for i in range(0, len(nodes), 2)]
+    return nodes[0]
+
+
+class Chain:
+    def __init__(self, difficulty, transactions, seed_hash):
+        self.lock = threading.Lock()
+        self.difficulty = difficulty
+        self.transactions = transactions
+        self.seed_hash = seed_hash
+        self.height = 3000000
+        self.top = os.urandom(32)
+        self.templates = {}
+        self.extranonces = set()
+        self.accepted = 0
+        self.rejected = 0
+
+    def template(self, reserve_size):
+        header = varint(16) + varint(16) + varint(int(time.time())) + self.top + bytes(4)
+        extra_head = b"\x01" + os.urandom(32) + b"\x02" + varint(reserve_size)
+        extra = extra_head + bytes(reserve_size)
+        prefix = (
+            varint(2) + varint(self.height + 60)
+            + varint(1) + b"\xff" + varint(self.height)
+            + varint(1) + varint(600000000000) + b"\x03" + os.urandom(32) + os.urandom(1)
+            + varint(len(extra))
+        )
+        reserved_offset = len(header) + len(prefix) + len(extra_head)
+        miner_tx = prefix + extra + b"\x00"
+        hashes = [os.urandom(32) for _ in range(self.transactions)]
+        blob = header + miner_tx + varint(len(hashes)) + b"".join(hashes)
+        self.templates[blob[:reserved_offset]] = (header, len(miner_tx), hashes)
+        return {
+            "blocktemplate_blob": blob.hex(),
+            "blockhashing_blob": hashing_blob(header, miner_tx, hashes).hex(),
+            "difficulty": self.difficulty,
+            "height": self.height,
+            "prev_hash": self.top.hex(),
+            "reserved_offset": reserved_offset,
+            "seed_hash": self.seed_hash.hex(),
+            "status": "OK",
+        }
+
+
+def miner_tx_hash(miner_tx):
+    prefix, base = miner_tx[:-1], miner_tx[-1:]
+    return keccak(keccak(prefix) + keccak(base) + bytes(32))
+
+
+def hashing_blob(header, miner_tx, hashes):
+    root = tree_hash([miner_tx_hash(miner_tx)] + hashes)
+    return header + root + varint(len(hashes) + 1)
+
+
+def check_hash(hash_bytes, difficulty):
+    return int.from_bytes(hash_bytes, "little") * difficulty < (1 << 256)
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, body):
+        data = json.dumps(body).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_POST(self):
+        request = json.loads(self.rfile.read(int(self.headers["Content-Length"])))
+        chain = self.server.chain
+        method = request.get("method")
+        params = request.get("params", {})
+        reply = {"jsonrpc": "2.0", "id": request.get("id")}
+        with chain.lock:
+            if method == "get_info":
+                reply["result"] = {"height": chain.height, "top_block_hash": chain.top.hex(), "status": "OK"}
+            elif method == "get_block_template":
+                reply["result"] = chain.template(int(params.get("reserve_size", 8)))
+                log("template height {} reserve {}".format(chain.height, params.get("reserve_size")))
+            elif method == "submit_block":
+                error = submit(chain, bytes.fromhex(params[0]))
+                if error:
+                    chain.rejected += 1
+                    reply["error"] = {"code": -7, "message": error}
+                else:
+                    chain.accepted += 1
+                    reply["result"] = {"status": "OK"}
+                log("submit_block: {}".format(error or "accepted"))
+            else:
+                reply["error"] = {"code": -32601, "message": "Method not found"}
+        self.reply(reply)
+
+
+def submit(chain, block):
+    for start, (header, miner_tx_size, hashes) in chain.templates.items():
+        if block[len(header):len(start)] == start[len(header):] and block[:len(header) - 4] == header[:-4]:
+            break
+    else:
+        return "Block not accepted"
+    miner_tx = block[len(header):len(header) + miner_tx_size]
+    reserve = block[len(start):len(header) + miner_tx_size - 1]
+    blob = hashing_blob(block[:len(header)], miner_tx, hashes)
+    chain.extranonces.add(bytes(reserve))
+    if hasher is not None and not check_hash(hasher.hash(blob), chain.difficulty):
+        return "Block not accepted: low difficulty"
+    log("block extranonce {} nonce {}".format(reserve.hex(), block[len(header) - 4:len(header)].hex()))
+    chain.height += 1
+    chain.top = keccak(blob)
+    chain.templates.clear()
+    return None
+
+
+def log(message):
+    print("[daemon] " + message, flush=True)
+
+
+hasher = None
+
+
+def main():
+    global hasher
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=18081)
+    parser.add_argument("--difficulty", type=int, default=100)
+    parser.add_argument("--transactions", type=int, default=5)
+    parser.add_argument("--seed", default="00" * 32)
+    arguments = parser.parse_args()
+
+    # Background jobs of shell ignore SIGINT
+    signal.signal(signal.SIGINT, signal.default_int_handler)
+
+    if keccak(b"").hex() != "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470":
+        sys.exit("keccak self-test failed")
+
+    try:
+        import cpuminer
+        hasher = cpuminer.Hasher(bytes.fromhex(arguments.seed))
+        log("proof of work is checked")
+    except ImportError:
+        log("cpuminer module is not found, proof of work is not checked")
+
+    server = ThreadingHTTPServer(("127.0.0.1", arguments.port), Handler)
+    server.chain = Chain(arguments.difficulty, arguments.transactions, bytes.fromhex(arguments.seed))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        chain = server.chain
+        log("accepted {} rejected {} extranonces {}".format(chain.accepted, chain.rejected, len(chain.extranonces)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,245 @@
+#include "microbench.hpp"
+
+/**
+ * @brief Microbenchmarks of hashing stages: each stage of RandomX hash and
+ * of job handling is measured in isolation
+ *
+ * @author GerrFrog
+ *
+ * @param argc Argument counter
+ * @param argv Argument char pointer
+ * @return int Exit status
+ */
+int main(int argc, char *argv[])
+{
+    cxxopts::Options options(
+        "./microbench",
+        "Microbenchmarks of hashing stages"
+    );
+
+    options.add_options()
+        ("f,filter", "Measure stages containing substring", cxxopts::value<string>()->default_value(""))
+        ("w,warmup", "Warm-up of every stage in seconds", cxxopts::value<double>()->default_value("0.5"))
+        ("t,sample", "Minimal duration of sample in seconds", cxxopts::value<double>()->default_value("0.05"))
+        ("n,samples", "Number of samples", cxxopts::value<size_t>()->default_value("21"))
+        ("c,cpu", "Pin to CPU (negative to not pin)", cxxopts::value<int>()->default_value("0"))
+        ("j,json", "Write results to JSON file", cxxopts::value<string>())
+        ("h,help", "Help for arguments list")
+    ;
+
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help"))
+    {
+        cout << options.help() << endl;
+        return EXIT_SUCCESS;
+    }
+
+    int cpu = result["cpu"].as<int>();
+
+    if (cpu >= 0 && !Solvers::Implementors::set_thread_affinity({(unsigned)cpu}))
+        cout << "Cannot pin to CPU " << cpu << endl;
+
+    Microbench::Runner runner(
+        result["warmup"].as<double>(),
+        result["sample"].as<double>(),
+        result["samples"].as<size_t>(),
+        result["filter"].as<string>()
+    );
+    randomx_flags flags = randomx_get_flags();
+    bool soft_aes = !(flags & RANDOMX_FLAG_HARD_AES);
+    randomx_flags interpreted = (randomx_flags)(flags & ~RANDOMX_FLAG_JIT);
+    bool jit = flags & RANDOMX_FLAG_JIT;
+    const binary seed(32, 0);
+    const binary input(76, 0);
+    const string blob = Utilities::HEX_String(input).get_encoded();
+    alignas(16) uint64_t temp_hash[8] = {0};
+    alignas(16) uint64_t fill_state[8] = {0};
+    uint8_t *scratchpad = (uint8_t *)randomx::AlignedAllocator<64>::allocMemory(RANDOMX_SCRATCHPAD_L3);
+    randomx::RegisterFile register_file = {};
+    uint8_t item[randomx::CacheLineSize];
+    uint64_t item_number = 0;
+
+    // Caches are shared by stages, with and without generated code
+    randomx_cache *cache = randomx_alloc_cache(interpreted);
+    randomx_cache *jit_cache = jit ? randomx_alloc_cache(flags) : nullptr;
+
+    if (cache == nullptr)
+    {
+        cout << "Cannot allocate RandomX cache" << endl;
+        return EXIT_FAILURE;
+    }
+    randomx_init_cache(cache, seed.data(), seed.size());
+    if (jit_cache != nullptr)
+        randomx_init_cache(jit_cache, seed.data(), seed.size());
+
+    cout << "flags: " << flags << (soft_aes ? " (soft AES)" : " (hard AES)") << endl;
+
+    runner.measure("blake2b_input", [&]() {
+        blake2b(temp_hash, sizeof(temp_hash), input.data(), input.size(), nullptr, 0);
+        Microbench::Implementors::clobber(temp_hash);
+    });
+    runner.measure("blake2b_register_file", [&]() {
+        blake2b(temp_hash, sizeof(temp_hash), &register_file, sizeof(register_file), nullptr, 0);
+        Microbench::Implementors::clobber(temp_hash);
+    });
+    runner.measure("fill_aes_1rx4", [&]() {
+        if (soft_aes)
+            fillAes1Rx4<true>(temp_hash, RANDOMX_SCRATCHPAD_L3, scratchpad);
+        else
+            fillAes1Rx4<false>(temp_hash, RANDOMX_SCRATCHPAD_L3, scratchpad);
+        Microbench::Implementors::clobber(scratchpad);
+    });
+    runner.measure("hash_and_fill_aes_1rx4", [&]() {
+        if (soft_aes)
+            hashAndFillAes1Rx4<true>(scratchpad, RANDOMX_SCRATCHPAD_L3, temp_hash, fill_state);
+        else
+            hashAndFillAes1Rx4<false>(scratchpad, RANDOMX_SCRATCHPAD_L3, temp_hash, fill_state);
+        Microbench::Implementors::clobber(temp_hash);
+    });
+
+    // Single program with dataset items computed from cache (light mode)
+    for (bool compiled : {false, true})
+    {
+        string name = compiled ? "run_jit_light" : "run_interpreted_light";
+
+        if (!runner.selected(name) || (compiled && jit_cache == nullptr))
+            continue;
+
+        randomx_vm *vm = compiled ?
+            randomx_create_vm(flags, jit_cache, nullptr) :
+            randomx_create_vm(interpreted, cache, nullptr);
+
+        if (vm == nullptr)
+        {
+            cout << name << ": cannot create VM" << endl;
+            continue;
+        }
+
+        vm->initScratchpad(temp_hash);
+        vm->resetRoundingMode();
+        runner.measure(name, [&]() {
+            vm->run(temp_hash);
+            Microbench::Implementors::clobber(vm->getRegisterFile());
+        });
+        randomx_destroy_vm(vm);
+    }
+
+    runner.measure("init_dataset_item", [&]() {
+        randomx::initDatasetItem(cache, item, item_number++ % (RANDOMX_DATASET_BASE_SIZE / randomx::CacheLineSize));
+        Microbench::Implementors::clobber(item);
+    });
+    if (jit_cache != nullptr)
+        runner.measure("init_dataset_item_jit", [&]() {
+            uint32_t number = item_number++ % (RANDOMX_DATASET_BASE_SIZE / randomx::CacheLineSize);
+
+            jit_cache->datasetInit(jit_cache, item, number, number + 1);
+            Microbench::Implementors::clobber(item);
+        });
+
+    // Same instance as randomx::initCache, initial blocks are part of the stage
+    runner.measure("argon2_fill", [&]() {
+        argon2_context context = {};
+        argon2_instance_t instance = {};
+
+        context.pwd = (uint8_t *)seed.data();
+        context.pwdlen = (uint32_t)seed.size();
+        context.salt = (uint8_t *)RANDOMX_ARGON_SALT;
+        context.saltlen = (uint32_t)randomx::ArgonSaltSize;
+        context.t_cost = RANDOMX_ARGON_ITERATIONS;
+        context.m_cost = RANDOMX_ARGON_MEMORY;
+        context.lanes = RANDOMX_ARGON_LANES;
+        context.threads = 1;
+        context.flags = ARGON2_DEFAULT_FLAGS;
+        context.version = ARGON2_VERSION_NUMBER;
+
+        instance.version = context.version;
+        instance.passes = context.t_cost;
+        instance.memory_blocks = context.m_cost;
+        instance.segment_length = context.m_cost / (context.lanes * ARGON2_SYNC_POINTS);
+        instance.lane_length = instance.segment_length * ARGON2_SYNC_POINTS;
+        instance.lanes = context.lanes;
+        instance.threads = context.threads;
+        instance.type = Argon2_d;
+        instance.memory = (block *)cache->memory;
+        instance.impl = cache->argonImpl;
+
+        randomx_argon2_initialize(&instance, &context);
+        randomx_argon2_fill_memory_blocks(&instance);
+        Microbench::Implementors::clobber(cache->memory);
+    });
+
+    runner.measure("hex_string_decode", [&]() {
+        Utilities::HEX_String hex(blob);
+
+        Microbench::Implementors::clobber(&hex);
+    });
+
+    nlohmann::json message = {
+        {"jsonrpc", "2.0"},
+        {"method", "job"},
+        {"params", {
+            {"blob", blob},
+            {"job_id", "1"},
+            {"target", "b88d0600"},
+            {"height", 1},
+            {"seed_hash", string(64, '0')}
+        }}
+    };
+    string notification = message.dump();
+    Pools::Implementors::Parsers::Parser_V1 parser;
+
+    runner.measure("parser_v1_parse", [&]() {
+        Utilities::Pools::New_Job_V1 job = parser.parse(notification);
+
+        Microbench::Implementors::clobber(&job);
+    });
+
+    // Stratum V2 channel with seed hash and previous block, then jobs
+    namespace Stratum_V2 = Pools::Implementors::Stratum_V2;
+
+    Pools::Implementors::Parsers::Parser_V2 parser_v2;
+    Stratum_V2::Writer writer;
+    std::array<unsigned char, 32> field{};
+
+    for (string frame : {
+        string(writer.begin(0, Stratum_V2::Open_Standard_Mining_Channel_Success)
+            .u32(1).u32(1).u256(field).str("").u32(0).end()),
+        string(writer.begin(Stratum_V2::channel_bit | Stratum_V2::randomx_extension, Stratum_V2::set_seed_hash)
+            .u32(1).u256(field).end()),
+        string(writer.begin(Stratum_V2::channel_bit, Stratum_V2::New_Mining_Job)
+            .u32(1).u32(1).u8(0).u32(0x00051010).str(string(32, '\0')).end()),
+        string(writer.begin(Stratum_V2::channel_bit, Stratum_V2::Set_New_Prev_Hash)
+            .u32(1).u32(1).u256(field).u32(1700000000).u32(0).end())
+    }) {
+        Stratum_V2::Reader reader(frame);
+        Utilities::Pools::New_Job_V1 job;
+
+        parser_v2.parse(reader, job);
+    }
+
+    string new_mining_job(writer.begin(Stratum_V2::channel_bit, Stratum_V2::New_Mining_Job)
+        .u32(1).u32(2).u8(1).u32(1700000000).u32(0x00051010).str(string(32, '\0')).end());
+
+    runner.measure("parser_v2_parse", [&]() {
+        Stratum_V2::Reader reader(new_mining_job);
+        Utilities::Pools::New_Job_V1 job;
+
+        parser_v2.parse(reader, job);
+        Microbench::Implementors::clobber(&job);
+    });
+
+    randomx::AlignedAllocator<64>::freeMemory(scratchpad, RANDOMX_SCRATCHPAD_L3);
+    randomx_release_cache(cache);
+    if (jit_cache != nullptr)
+        randomx_release_cache(jit_cache);
+
+    if (result.count("json"))
+        std::ofstream(result["json"].as<string>()) << nlohmann::json({
+            {"flags", flags},
+            {"cpu", cpu},
+            {"results", runner.get_results()}
+        }).dump(4) << endl;
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,316 @@
+#pragma once
+
+#ifndef MICROBENCH_HEADER
+#define MICROBENCH_HEADER
+
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cxxopts.hpp>
+#include <iomanip>
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include "../src/pools/inc/pools.hpp"
+#include "../src/solvers/inc/solvers.hpp"
+#include "../src/utilities/inc/utilities.hpp"
+
+// Internal stages of RandomX (not exported by randomx.h)
+#include <common.hpp>
+#include <dataset.hpp>
+#include <aes_hash.hpp>
+#include <argon2_core.h>
+#include <blake2/blake2.h>
+#include <virtual_machine.hpp>
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/**
+ * @brief Implementators for Microbench objects
+ *
+ * @author GerrFrog
+ */
+namespace Microbench::Implementors
+{
+    /**
+     * @brief Make the compiler assume memory is read and written, so
+     * results of measured code are not optimized out
+     *
+     * @author GerrFrog
+     *
+     * @param pointer Result of measured code
+     */
+    inline void clobber(const void *pointer)
+    {
+        asm volatile("" : : "g"(pointer) : "memory");
+    }
+
+    /**
+     * @brief Median of samples
+     *
+     * @author GerrFrog
+     *
+     * @param samples Samples (reordered)
+     * @return double
+     */
+    inline double median(std::vector<double> &samples)
+    {
+        size_t middle = samples.size() / 2;
+
+        std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+        if (samples.size() % 2)
+            return samples[middle];
+
+        return (samples[middle] + *std::max_element(samples.begin(), samples.begin() + middle)) / 2;
+    }
+
+    /**
+     * @brief Median absolute deviation of samples
+     *
+     * @author GerrFrog
+     *
+     * @param samples Samples
+     * @param center Median of samples
+     * @return double
+     */
+    inline double mad(const std::vector<double> &samples, double center)
+    {
+        std::vector<double> deviations;
+
+        for (double sample : samples)
+            deviations.push_back(std::fabs(sample - center));
+
+        return median(deviations);
+    }
+}
+
+/**
+ * @brief Microbenchmarks of hashing stages
+ *
+ * @author GerrFrog
+ */
+namespace Microbench
+{
+    /**
+     * @brief Measurement of one stage
+     *
+     * @author GerrFrog
+     */
+    struct Result
+    {
+        /**
+         * @brief Stage name
+         *
+         * @author GerrFrog
+         */
+        string name;
+
+        /**
+         * @brief Calls of stage in one sample
+         *
+         * @author GerrFrog
+         */
+        uint64_t iterations;
+
+        /**
+         * @brief Number of samples
+         *
+         * @author GerrFrog
+         */
+        size_t samples;
+
+        /**
+         * @brief Median time of one call in nanoseconds
+         *
+         * @author GerrFrog
+         */
+        double median;
+
+        /**
+         * @brief Median absolute deviation in nanoseconds
+         *
+         * @author GerrFrog
+         */
+        double mad;
+    };
+
+    /**
+     * @brief Convert Result to JSON
+     *
+     * @author GerrFrog
+     *
+     * @param json JSON
+     * @param result Result
+     */
+    inline void to_json(nlohmann::json &json, const Result &result)
+    {
+        json = {
+            {"name", result.name},
+            {"iterations", result.iterations},
+            {"samples", result.samples},
+            {"median_ns", result.median},
+            {"mad_ns", result.mad}
+        };
+    }
+
+    /**
+     * @brief Runs stages with warm-up and collects samples. Calls of a
+     * stage are batched so one sample is long enough for the clock
+     *
+     * @author GerrFrog
+     */
+    class Runner
+    {
+        private:
+            /**
+             * @brief Warm-up of every stage in seconds
+             *
+             * @author GerrFrog
+             */
+            double warmup;
+
+            /**
+             * @brief Minimal duration of one sample in seconds
+             *
+             * @author GerrFrog
+             */
+            double sample_time;
+
+            /**
+             * @brief Number of samples
+             *
+             * @author GerrFrog
+             */
+            size_t samples;
+
+            /**
+             * @brief Stage name filter (substring, empty for all)
+             *
+             * @author GerrFrog
+             */
+            string filter;
+
+            /**
+             * @brief Results of measured stages
+             *
+             * @author GerrFrog
+             */
+            std::vector<Result> results;
+
+        public:
+            /**
+             * @brief Construct a new Runner object
+             *
+             * @author GerrFrog
+             *
+             * @param warmup Warm-up in seconds
+             * @param sample_time Minimal duration of sample in seconds
+             * @param samples Number of samples
+             * @param filter Stage name filter
+             */
+            Runner(
+                double warmup,
+                double sample_time,
+                size_t samples,
+                const string &filter
+            ) : warmup(warmup),
+                sample_time(sample_time),
+                samples(std::max<size_t>(samples, 1)),
+                filter(filter)
+            { }
+
+            /**
+             * @brief Destroy the Runner object
+             *
+             * @author GerrFrog
+             */
+            ~Runner() = default;
+
+            /**
+             * @brief Check if stage passes filter
+             *
+             * @author GerrFrog
+             *
+             * @param name Stage name
+             * @return true Stage is measured
+             */
+            bool selected(const string &name) const
+            {
+                return this->filter.empty() || name.find(this->filter) != string::npos;
+            }
+
+            /**
+             * @brief Measure stage
+             *
+             * @author GerrFrog
+             *
+             * @tparam Stage Callable without arguments
+             * @param name Stage name
+             * @param stage Stage
+             */
+            template <class Stage>
+            void measure(const string &name, Stage &&stage)
+            {
+                if (!this->selected(name))
+                    return;
+
+                using clock = std::chrono::steady_clock;
+
+                uint64_t calls = 0;
+                auto started = clock::now();
+
+                // Warm-up also calibrates calls per sample
+                do {
+                    stage();
+                    calls++;
+                } while (std::chrono::duration<double>(clock::now() - started).count() < this->warmup);
+
+                double call_time = std::chrono::duration<double>(clock::now() - started).count() / calls;
+                uint64_t iterations = std::max<uint64_t>(1, (uint64_t)(this->sample_time / call_time));
+                std::vector<double> times;
+
+                for (size_t i = 0; i < this->samples; i++)
+                {
+                    auto sample = clock::now();
+
+                    for (uint64_t j = 0; j < iterations; j++)
+                        stage();
+                    times.push_back(
+                        std::chrono::duration<double, std::nano>(clock::now() - sample).count() / iterations
+                    );
+                }
+
+                double center = Implementors::median(times);
+
+                this->results.push_back({name, iterations, this->samples, center, Implementors::mad(times, center)});
+                cout
+                    << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+                    << std::setw(16) << center << " ns"
+                    << std::setw(12) << this->results.back().mad << " ns MAD"
+                    << std::setw(10) << iterations << " x" << endl;
+            }
+
+            /**
+             * @brief Get results
+             *
+             * @author GerrFrog
+             *
+             * @return const std::vector<Result>&
+             */
+            const std::vector<Result> &get_results() const { return this->results; }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file
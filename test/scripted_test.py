@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Scripted end-to-end test of the miner against a test server.
+
+Starts a test server of the scenario (stratum_v2_server.py for the
+stratum_v2 scenario, daemon.py for solo), writes config.json for it into
+a temporary directory and runs the miner there until the server reports
+an accepted share or time runs out. The miner is stopped with SIGINT and must exit
+cleanly; the server is stopped the same way and its summary line
+"accepted N rejected N ..." decides the result.
+"""
+
+import argparse
+import json
+import os
+import re
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+TEST_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+
+
+def free_port():
+    with socket.socket() as probe:
+        probe.bind(("127.0.0.1", 0))
+        return probe.getsockname()[1]
+
+
+def wait_port(port, timeout):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            with socket.create_connection(("127.0.0.1", port), timeout=1):
+                return True
+        except OSError:
+            time.sleep(0.1)
+    return False
+
+
+def stratum_v2(port, difficulty):
+    server = [
+        os.path.join(TEST_DIRECTORY, "stratum_v2_server.py"),
+        "--port", str(port), "--difficulty", str(difficulty), "--interval", "2", "--blocks", "3",
+    ]
+    pool = {"host": "127.0.0.1", "port": str(port), "login": "test", "password": "x", "protocol": "v2"}
+    return server, pool, {}
+
+
+def solo(port, difficulty):
+    server = [
+        os.path.join(TEST_DIRECTORY, "daemon.py"),
+        "--port", str(port), "--difficulty", str(difficulty), "--transactions", "5",
+    ]
+    # Nothing listens on the pool port, blocks go to the daemon only
+    pool = {"host": "127.0.0.1", "port": str(free_port()), "login": "test", "password": "x"}
+    daemon = {
+        "enabled": True, "host": "127.0.0.1", "port": str(port), "wallet": "test",
+        "reserve_size": 8, "poll_interval": 200, "refresh": 60, "roll_interval": 1,
+    }
+    return server, pool, {"solo": daemon}
+
+
+SCENARIOS = {
+    "solo": solo,
+    "stratum_v2": stratum_v2,
+}
+
+
+class Server:
+    """Test server whose output is collected by a thread."""
+
+    def __init__(self, command):
+        self.process = subprocess.Popen(
+            [sys.executable] + command,
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+        )
+        self.lines = []
+        self.accepted = threading.Event()
+        self.reader = threading.Thread(target=self.read, daemon=True)
+        self.reader.start()
+
+    def read(self):
+        for line in self.process.stdout:
+            self.lines.append(line.rstrip())
+            if line.rstrip().endswith("accepted"):
+                self.accepted.set()
+
+    def stop(self):
+        self.process.send_signal(signal.SIGINT)
+        self.process.wait(timeout=10)
+        self.reader.join(timeout=10)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--miner", required=True)
+    parser.add_argument("--scenario", choices=sorted(SCENARIOS), required=True)
+    parser.add_argument("--difficulty", type=int, default=20)
+    parser.add_argument("--seconds", type=float, default=60)
+    arguments = parser.parse_args()
+
+    port = free_port()
+    server_command, pool, extra = SCENARIOS[arguments.scenario](port, arguments.difficulty)
+    config = {
+        "solver": {"threads": 1, "mode": "light", "huge_pages": False},
+        "pool": pool,
+        "logger": {"level": "info", "console_level": "info"},
+    }
+    config.update(extra)
+
+    with tempfile.TemporaryDirectory() as directory:
+        run = os.path.join(directory, "run")
+        os.mkdir(run)
+        config["logger"]["directory"] = os.path.join(directory, "logs")
+        with open(os.path.join(directory, "config.json"), "w") as file:
+            json.dump(config, file, indent=4)
+        # Proxies are read from environment after .env is loaded
+        open(os.path.join(directory, ".env"), "w").close()
+
+        server = Server(server_command)
+        if not wait_port(port, 10):
+            server.process.kill()
+            print("\n".join(server.lines))
+            print("FAILED: server does not listen on port {}".format(port))
+            return 1
+
+        environment = dict(os.environ, HTTP_PROXY="", HTTPS_PROXY="")
+        with open(os.path.join(directory, "miner.log"), "w+") as log:
+            miner = subprocess.Popen([arguments.miner], cwd=run, stdout=log, stderr=subprocess.STDOUT, env=environment)
+            server.accepted.wait(arguments.seconds)
+            miner.send_signal(signal.SIGINT)
+            try:
+                status = miner.wait(timeout=30)
+            except subprocess.TimeoutExpired:
+                miner.kill()
+                status = "timeout"
+            server.stop()
+            log.seek(0)
+            miner_output = log.read()
+
+    summary = [line for line in server.lines if " accepted " in line and " rejected " in line]
+    match = re.search(r"accepted (\d+) rejected (\d+)", summary[-1]) if summary else None
+    errors = []
+    if status != 0:
+        errors.append("miner exit status {}".format(status))
+    if match is None:
+        errors.append("server summary is missing")
+    elif int(match.group(1)) == 0:
+        errors.append("no share is accepted")
+    if errors:
+        print(miner_output)
+        print("\n".join(server.lines))
+        print("FAILED: " + ", ".join(errors))
+        return 1
+
+    print(summary[-1])
+    print("PASSED")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,319 @@
+#!/usr/bin/env python3
+"""Reference Stratum V2 mining server (standard channels) for tests.
+
+Speaks plain binary framing (no Noise handshake): SetupConnection,
+OpenStandardMiningChannel, NewMiningJob, SetNewPrevHash, SetTarget and
+SubmitSharesStandard, plus SetSeedHash of the RandomX extension. Jobs of
+RandomX map to header fields the same way as in the miner: prev_hash is
+the previous block ID, ntime the timestamp, merkle_root the tree hash and
+version holds major, minor version and number of transactions. When the
+cpuminer Python module is importable, shares are checked against target.
+"""
+
+import argparse
+import json
+import os
+import signal
+import socketserver
+import struct
+import threading
+import time
+
+CHANNEL_BIT = 0x8000
+RANDOMX_EXTENSION = 0x4000
+
+SETUP_CONNECTION = 0x00
+SETUP_CONNECTION_SUCCESS = 0x01
+SETUP_CONNECTION_ERROR = 0x02
+OPEN_STANDARD_MINING_CHANNEL = 0x10
+OPEN_STANDARD_MINING_CHANNEL_SUCCESS = 0x11
+NEW_MINING_JOB = 0x15
+SUBMIT_SHARES_STANDARD = 0x1A
+SUBMIT_SHARES_SUCCESS = 0x1C
+SUBMIT_SHARES_ERROR = 0x1D
+SET_NEW_PREV_HASH = 0x20
+SET_TARGET = 0x21
+SET_SEED_HASH = 0x00
+
+
+def frame(extension, msg_type, payload):
+    return struct.pack("<HB", extension, msg_type) + len(payload).to_bytes(3, "little") + payload
+
+
+def string(value):
+    return bytes([len(value)]) + value
+
+
+def varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+class Reader:
+    def __init__(self, payload):
+        self.payload = payload
+        self.offset = 0
+
+    def take(self, size):
+        if self.offset + size > len(self.payload):
+            raise ValueError("message is truncated")
+        data = self.payload[self.offset:self.offset + size]
+        self.offset += size
+        return data
+
+    def u8(self):
+        return self.take(1)[0]
+
+    def u16(self):
+        return struct.unpack("<H", self.take(2))[0]
+
+    def u32(self):
+        return struct.unpack("<I", self.take(4))[0]
+
+    def f32(self):
+        return struct.unpack("<f", self.take(4))[0]
+
+    def str(self):
+        return self.take(self.u8())
+
+
+class Chain:
+    def __init__(self, difficulty, seed_hash):
+        self.lock = threading.Lock()
+        self.difficulty = difficulty
+        self.seed_hash = seed_hash
+        self.prev_hash = os.urandom(32)
+        self.ntime = int(time.time())
+        self.job_id = 0
+        self.jobs = {}
+        self.clients = []
+        self.accepted = 0
+        self.rejected = 0
+        self.stale = 0
+        self.bytes_v2 = 0
+        self.bytes_v1 = 0
+
+    def target(self):
+        return ((1 << 256) - 1) // self.difficulty
+
+    def job(self):
+        self.job_id += 1
+        version = 16 | 16 << 8 | (1 + self.job_id % 20) << 16
+        self.jobs[self.job_id] = (version, os.urandom(32), self.prev_hash)
+        return self.job_id, version, self.jobs[self.job_id][1]
+
+    def blob(self, job_id, ntime, nonce):
+        version, merkle_root, prev_hash = self.jobs[job_id]
+        return (
+            varint(version & 0xFF) + varint(version >> 8 & 0xFF) + varint(ntime)
+            + prev_hash + struct.pack("<I", nonce) + merkle_root + varint(version >> 16)
+        )
+
+    def v1_size(self, job_id, ntime):
+        """Size of the same job as Stratum V1 JSON notification."""
+        message = {
+            "jsonrpc": "2.0",
+            "method": "job",
+            "params": {
+                "blob": self.blob(job_id, ntime, 0).hex(),
+                "job_id": str(job_id),
+                "target": (self.target() >> 192).to_bytes(8, "little").hex(),
+                "height": 3000000,
+                "seed_hash": self.seed_hash.hex(),
+            },
+        }
+        return len(json.dumps(message)) + 1
+
+
+class Client:
+    def __init__(self, chain, handler, channel_id):
+        self.chain = chain
+        self.handler = handler
+        self.channel_id = channel_id
+        self.open = False
+
+    def send(self, data):
+        try:
+            self.handler.wfile.write(data)
+        except OSError:
+            pass
+
+    def new_job(self, job_id, version, merkle_root, future):
+        min_ntime = b"\x00" if future else b"\x01" + struct.pack("<I", self.chain.ntime)
+        data = frame(
+            CHANNEL_BIT, NEW_MINING_JOB,
+            struct.pack("<II", self.channel_id, job_id) + min_ntime + struct.pack("<I", version) + string(merkle_root),
+        )
+        self.send(data)
+        return len(data)
+
+    def new_prev_hash(self, job_id):
+        data = frame(
+            CHANNEL_BIT, SET_NEW_PREV_HASH,
+            struct.pack("<II", self.channel_id, job_id) + self.chain.prev_hash + struct.pack("<II", self.chain.ntime, 0),
+        )
+        self.send(data)
+        return len(data)
+
+    def seed_hash(self):
+        self.send(frame(
+            CHANNEL_BIT | RANDOMX_EXTENSION, SET_SEED_HASH,
+            struct.pack("<I", self.channel_id) + self.chain.seed_hash,
+        ))
+
+
+class Handler(socketserver.StreamRequestHandler):
+    def handle(self):
+        chain = self.server.chain
+        with chain.lock:
+            client = Client(chain, self, len(chain.clients) + 1)
+            chain.clients.append(client)
+        log("client {} connected".format(client.channel_id))
+        try:
+            while True:
+                header = self.rfile.read(6)
+                if len(header) < 6:
+                    break
+                extension, msg_type = struct.unpack_from("<HB", header)
+                payload = self.rfile.read(int.from_bytes(header[3:6], "little"))
+                with chain.lock:
+                    self.message(chain, client, extension & ~CHANNEL_BIT, msg_type, Reader(payload))
+        except (OSError, ValueError) as error:
+            log("client {}: {}".format(client.channel_id, error))
+        finally:
+            with chain.lock:
+                chain.clients.remove(client)
+            log("client {} disconnected".format(client.channel_id))
+
+    def message(self, chain, client, extension, msg_type, message):
+        if extension != 0:
+            return
+        if msg_type == SETUP_CONNECTION:
+            protocol, min_version, max_version = message.u8(), message.u16(), message.u16()
+            if protocol != 0 or not min_version <= 2 <= max_version:
+                client.send(frame(0, SETUP_CONNECTION_ERROR, struct.pack("<I", 0) + string(b"unsupported-protocol")))
+                return
+            message.u32()
+            host, port = message.str(), message.u16()
+            vendor = message.str()
+            log("setup connection {}:{} vendor {}".format(host.decode(), port, vendor.decode()))
+            client.send(frame(0, SETUP_CONNECTION_SUCCESS, struct.pack("<HI", 2, 0)))
+        elif msg_type == OPEN_STANDARD_MINING_CHANNEL:
+            request_id, user, hashrate = message.u32(), message.str(), message.f32()
+            log("open channel {} user {} hashrate {}".format(client.channel_id, user.decode(), hashrate))
+            client.send(frame(
+                0, OPEN_STANDARD_MINING_CHANNEL_SUCCESS,
+                struct.pack("<II", request_id, client.channel_id) + chain.target().to_bytes(32, "little")
+                + string(b"") + struct.pack("<I", 0),
+            ))
+            client.open = True
+            client.seed_hash()
+            job_id, version, merkle_root = chain.job()
+            client.new_job(job_id, version, merkle_root, True)
+            client.new_prev_hash(job_id)
+        elif msg_type == SUBMIT_SHARES_STANDARD:
+            channel_id, sequence, job_id, nonce, ntime, version = struct.unpack("<6I", message.take(24))
+            error = submit(chain, job_id, nonce, ntime, version)
+            if error:
+                if error == "stale-share":
+                    chain.stale += 1
+                else:
+                    chain.rejected += 1
+                client.send(frame(
+                    CHANNEL_BIT, SUBMIT_SHARES_ERROR,
+                    struct.pack("<II", channel_id, sequence) + string(error.encode()),
+                ))
+            else:
+                chain.accepted += 1
+                client.send(frame(
+                    CHANNEL_BIT, SUBMIT_SHARES_SUCCESS,
+                    struct.pack("<IIIQ", channel_id, sequence, 1, chain.difficulty),
+                ))
+            log("share job {} nonce {:08x}: {}".format(job_id, nonce, error or "accepted"))
+
+
+def submit(chain, job_id, nonce, ntime, version):
+    if job_id not in chain.jobs or chain.jobs[job_id][0] != version:
+        return "invalid-job-id"
+    if chain.jobs[job_id][2] != chain.prev_hash:
+        return "stale-share"
+    blob = chain.blob(job_id, ntime, nonce)
+    if hasher is not None and int.from_bytes(hasher.hash(blob), "little") > chain.target():
+        return "difficulty-too-low"
+    return None
+
+
+def announce(chain, interval, blocks):
+    """New job every interval, new block (prev hash) every blocks jobs."""
+    count = 0
+    while True:
+        time.sleep(interval)
+        with chain.lock:
+            count += 1
+            block = count % blocks == 0
+            if block:
+                chain.prev_hash = os.urandom(32)
+                chain.ntime = int(time.time())
+                chain.jobs = {k: v for k, v in chain.jobs.items() if k > chain.job_id - 16}
+            job_id, version, merkle_root = chain.job()
+            for client in chain.clients:
+                if not client.open:
+                    continue
+                size = client.new_job(job_id, version, merkle_root, block)
+                if block:
+                    size += client.new_prev_hash(job_id)
+                chain.bytes_v2 += size
+                chain.bytes_v1 += chain.v1_size(job_id, chain.ntime)
+            log("{} {} for {} clients".format("block" if block else "job", job_id, len(chain.clients)))
+
+
+def log(message):
+    print("[sv2] " + message, flush=True)
+
+
+hasher = None
+
+
+def main():
+    global hasher
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=3336)
+    parser.add_argument("--difficulty", type=int, default=100)
+    parser.add_argument("--interval", type=float, default=2)
+    parser.add_argument("--blocks", type=int, default=3)
+    parser.add_argument("--seed", default="00" * 32)
+    arguments = parser.parse_args()
+
+    # Background jobs of shell ignore SIGINT
+    signal.signal(signal.SIGINT, signal.default_int_handler)
+
+    try:
+        import cpuminer
+        hasher = cpuminer.Hasher(bytes.fromhex(arguments.seed))
+        log("proof of work is checked")
+    except ImportError:
+        log("cpuminer module is not found, proof of work is not checked")
+
+    socketserver.ThreadingTCPServer.allow_reuse_address = True
+    socketserver.ThreadingTCPServer.daemon_threads = True
+    server = socketserver.ThreadingTCPServer(("127.0.0.1", arguments.port), Handler)
+    server.chain = Chain(arguments.difficulty, bytes.fromhex(arguments.seed))
+    threading.Thread(
+        target=announce, args=(server.chain, arguments.interval, arguments.blocks), daemon=True
+    ).start()
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        chain = server.chain
+        log("accepted {} rejected {} stale {}".format(chain.accepted, chain.rejected, chain.stale))
+        if chain.bytes_v1:
+            log("job bytes v2 {} v1 {} ({:.1f}x)".format(
+                chain.bytes_v2, chain.bytes_v1, chain.bytes_v1 / max(chain.bytes_v2, 1)))
+
+
+if __name__ == "__main__":
+    main()
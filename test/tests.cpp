@@ -0,0 +1,404 @@
+#include "tests.hpp"
+
+using Tests::Implementors::check;
+using Tests::Implementors::from_hex;
+using Tests::Implementors::to_hex;
+
+namespace Stratum_V2 = Pools::Implementors::Stratum_V2;
+
+/**
+ * @brief Unit tests of the miner. Only tests containing the first
+ * argument in their name are run
+ *
+ * @author GerrFrog
+ *
+ * @param argc Argument counter
+ * @param argv Argument char pointer
+ * @return int Exit status
+ */
+int main(int argc, char *argv[])
+{
+    Tests::Runner runner(argc > 1 ? argv[1] : "");
+
+    // Stratum V2: frames are copied, Writer reuses its buffer
+    std::array<unsigned char, 32> seed_hash, prev_hash, merkle_root, target{};
+
+    for (size_t i = 0; i < 32; i++)
+    {
+        seed_hash[i] = (unsigned char)i;
+        prev_hash[i] = (unsigned char)(0xA0 + i);
+        merkle_root[i] = (unsigned char)(0x40 + i);
+    }
+    target[31] = 0x01;
+    target[24] = 0xFF;
+
+    auto channel_success = [&target](uint32_t channel_id) {
+        Stratum_V2::Writer writer;
+
+        return string(writer.begin(0, Stratum_V2::Open_Standard_Mining_Channel_Success)
+            .u32(1).u32(channel_id).u256(target).str("").u32(0).end());
+    };
+    auto set_seed_hash = [&seed_hash](uint32_t channel_id) {
+        Stratum_V2::Writer writer;
+
+        return string(writer.begin(Stratum_V2::channel_bit | Stratum_V2::randomx_extension, Stratum_V2::set_seed_hash)
+            .u32(channel_id).u256(seed_hash).end());
+    };
+    auto new_mining_job = [&merkle_root](uint32_t channel_id, uint32_t job_id, bool future, uint32_t ntime, uint32_t version) {
+        Stratum_V2::Writer writer;
+
+        writer.begin(Stratum_V2::channel_bit, Stratum_V2::New_Mining_Job).u32(channel_id).u32(job_id);
+        if (future)
+            writer.u8(0);
+        else
+            writer.u8(1).u32(ntime);
+
+        return string(writer.u32(version).str(std::string_view((const char *)merkle_root.data(), merkle_root.size())).end());
+    };
+    auto set_new_prev_hash = [](uint32_t channel_id, uint32_t job_id, const std::array<unsigned char, 32> &prev, uint32_t ntime) {
+        Stratum_V2::Writer writer;
+
+        return string(writer.begin(Stratum_V2::channel_bit, Stratum_V2::Set_New_Prev_Hash)
+            .u32(channel_id).u32(job_id).u256(prev).u32(ntime).u32(0).end());
+    };
+    auto feed = [](Pools::Implementors::Parsers::Parser_V2 &parser, const string &frame, Utilities::Pools::New_Job_V1 &new_job) {
+        Stratum_V2::Reader message(frame);
+
+        check(parser.is_job(message), "frame changes job");
+
+        return parser.parse(message, new_job);
+    };
+
+    runner.run("stratum_v2: writer and reader round trip", [&]() {
+        Stratum_V2::Writer writer;
+        string frame(writer.begin(0, Stratum_V2::Submit_Shares_Success)
+            .u8(0x7F).u16(0xBEEF).u32(0xDEADBEEF).f32(1.5f).u256(seed_hash).str("abc").str("").end());
+        Stratum_V2::Reader reader(frame);
+        std::array<unsigned char, 32> value;
+
+        check(reader.extension == 0, "extension");
+        check(reader.type == Stratum_V2::Submit_Shares_Success, "message type");
+        check(reader.u8() == 0x7F, "u8");
+        check(reader.u16() == 0xBEEF, "u16");
+        check(reader.u32() == 0xDEADBEEF, "u32");
+
+        uint32_t bits = reader.u32();
+        float hashrate;
+
+        std::memcpy(&hashrate, &bits, sizeof(bits));
+        check(hashrate == 1.5f, "f32");
+        reader.u256(value);
+        check(value == seed_hash, "u256");
+        check(reader.str() == "abc", "str");
+        check(reader.str().empty(), "empty str");
+
+        bool truncated = false;
+
+        try {
+            reader.u8();
+        } catch (Exceptions::Pools::Protocol_Error &) {
+            truncated = true;
+        }
+        check(truncated, "read after the end throws");
+    });
+
+    runner.run("stratum_v2: 24 bit length and channel bit", [&]() {
+        Stratum_V2::Writer writer;
+        string payload(200, 'x');
+        string frame(writer.begin(Stratum_V2::channel_bit | Stratum_V2::randomx_extension, Stratum_V2::set_seed_hash)
+            .str(payload).str(payload).end());
+
+        // 2 * (1 + 200) = 402 = 0x000192
+        check(frame.size() == Stratum_V2::header_size + 402, "frame size");
+        check(to_hex(frame.data(), Stratum_V2::header_size) == "00c000920100", "header bytes");
+
+        Stratum_V2::Reader reader(frame);
+
+        check(reader.extension == Stratum_V2::randomx_extension, "channel bit is stripped");
+        check(reader.str() == payload && reader.str() == payload, "payload");
+
+        bool rejected = false;
+
+        try {
+            Stratum_V2::Reader longer(frame + "x");
+        } catch (Exceptions::Pools::Protocol_Error &) {
+            rejected = true;
+        }
+        check(rejected, "frame longer than its length is rejected");
+    });
+
+    runner.run("stratum_v2: parser builds hashing blob", [&]() {
+        Pools::Implementors::Parsers::Parser_V2 parser;
+        Utilities::Pools::New_Job_V1 new_job;
+        // Major 16, minor 16, 7 transactions
+        uint32_t version = 16 | 16 << 8 | 7 << 16;
+
+        check(!feed(parser, channel_success(5), new_job), "no job before seed hash");
+        check(!feed(parser, set_seed_hash(5), new_job), "no job before previous block");
+        check(!feed(parser, set_new_prev_hash(5, 1, prev_hash, 300), new_job), "no job for unknown job ID");
+        check(feed(parser, new_mining_job(5, 2, false, 300, version), new_job), "job is built");
+
+        // ntime 300 is varint ac 02, nonce is zeroed
+        check(
+            new_job.blob.get_encoded() ==
+                "1010ac02" + to_hex(prev_hash.data(), 32) + "00000000" + to_hex(merkle_root.data(), 32) + "07",
+            "blob layout"
+        );
+        check(new_job.job_id == "2", "job ID");
+        check(new_job.target == "ff00000000000001", "target is high 8 bytes");
+        check(new_job.seed_hash.get_decoded() == binary(seed_hash.begin(), seed_hash.end()), "seed hash");
+        check(!feed(parser, set_seed_hash(6), new_job), "other channel is ignored");
+    });
+
+    runner.run("stratum_v2: new prev hash promotes future job", [&]() {
+        Pools::Implementors::Parsers::Parser_V2 parser;
+        Utilities::Pools::New_Job_V1 new_job;
+        std::array<unsigned char, 32> next_hash;
+        uint32_t version = 16 | 16 << 8 | 1 << 16;
+
+        next_hash.fill(0x33);
+        feed(parser, channel_success(5), new_job);
+        feed(parser, set_seed_hash(5), new_job);
+        feed(parser, set_new_prev_hash(5, 1, prev_hash, 300), new_job);
+        check(feed(parser, new_mining_job(5, 2, false, 300, version), new_job), "current job");
+        check(!feed(parser, new_mining_job(5, 4, true, 0, version), new_job), "future job waits for previous block");
+        check(new_job.job_id == "2", "solver keeps current job");
+        check(!parser.submit_shares_standard(1, 2, 0).empty(), "current job takes shares");
+
+        check(feed(parser, set_new_prev_hash(5, 4, next_hash, 400), new_job), "future job is activated");
+        check(new_job.job_id == "4", "job ID of future job");
+        // ntime 400 is varint 90 03
+        check(
+            new_job.blob.get_encoded() ==
+                "10109003" + to_hex(next_hash.data(), 32) + "00000000" + to_hex(merkle_root.data(), 32) + "01",
+            "blob with new previous block and ntime"
+        );
+        check(parser.submit_shares_standard(1, 2, 0).empty(), "job of previous block is dropped");
+
+        string submit(parser.submit_shares_standard(1, 4, 0x11223344));
+        Stratum_V2::Reader reader(submit);
+
+        check(reader.type == Stratum_V2::Submit_Shares_Standard, "submit type");
+        check(reader.u32() == 5 && reader.u32() == 1 && reader.u32() == 4, "channel, sequence and job ID");
+        check(reader.u32() == 0x11223344 && reader.u32() == 400 && reader.u32() == version, "nonce, ntime and version");
+    });
+
+    // Monero: vectors of Keccak-256 with original padding (cn_fast_hash)
+    // and of crypto/tree-hash.c for leaves fast_hash(i)
+    auto keccak = [](const binary &data) {
+        Monero::Implementors::Hash hash;
+
+        Hashes::Keccak_256::hash(data.data(), data.size(), hash.data());
+
+        return to_hex(hash.data(), hash.size());
+    };
+
+    runner.run("monero: keccak-256", [&]() {
+        binary rate(136), longer(200);
+
+        for (size_t i = 0; i < longer.size(); i++)
+            longer[i] = (uint8_t)i;
+        std::copy(longer.begin(), longer.begin() + rate.size(), rate.begin());
+
+        check(keccak({}) == "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470", "empty input");
+        check(keccak({'a', 'b', 'c'}) == "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45", "abc");
+        check(keccak(rate) == "7ce759f1ab7f9ce437719970c26b0a66ff11fe3e38e17df89cf5d29c7d7f807e", "one full block");
+        check(keccak(longer) == "bfb0aa97863e797943cf7c33bb7e880bb4543f3d2703c0923c6901c2af57b890", "two blocks");
+    });
+
+    runner.run("monero: tree branch and root", [&]() {
+        const std::vector<std::pair<size_t, string>> roots = {
+            {1, "bc36789e7a1e281436464229828f817d6612f7b477d66591ff96a9e064bcc98a"},
+            {2, "57d772147cdf27f5f67d679f0f3a513f8b87622ce598a3cf0b048ab178ddfc6e"},
+            {3, "31ea648480acca9d46c5cfd2fd5ecf576ce7a797bdd582869c38deeacf6d17d4"},
+            {4, "dd5115b5dcca3db0bffa31064a0d21f21362cd02e1263e47d69e38bbeec1d359"},
+            {5, "3b85b9b4e7171846e3dd41d242f99cdc136467ff276a272d5d8f960b2c447d67"},
+            {9, "6a31a9bc64f694b411012bf9293fbf312a418c49565fcee0b0125c5c768c77be"}
+        };
+
+        for (auto &[count, root] : roots)
+        {
+            std::vector<Monero::Implementors::Hash> leaves;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                uint8_t data = (uint8_t)i;
+
+                leaves.push_back(Monero::Implementors::fast_hash(&data, 1));
+            }
+
+            auto branch = Monero::Implementors::tree_branch(leaves);
+            auto found = Monero::Implementors::tree_root(leaves[0], branch);
+
+            check(to_hex(found.data(), found.size()) == root, "root of " + std::to_string(count) + " leaves");
+        }
+    });
+
+    runner.run("monero: block template blobs", [&]() {
+        using Monero::Implementors::write_varint;
+
+        binary header, prefix, extra_head, blob;
+        std::vector<Monero::Implementors::Hash> hashes;
+
+        write_varint(header, 16);
+        write_varint(header, 16);
+        write_varint(header, 1700000000);
+        for (uint8_t i = 0; i < 32; i++)
+            header.push_back(i);
+        header.insert(header.end(), sizeof(uint32_t), 0);
+
+        // Extra: public key, then nonce tag with 8 reserved bytes
+        extra_head.push_back(0x01);
+        extra_head.insert(extra_head.end(), 32, 0x11);
+        extra_head.push_back(0x02);
+        write_varint(extra_head, 8);
+
+        // Version 2 miner transaction with one tagged key output
+        write_varint(prefix, 2);
+        write_varint(prefix, 3000060);
+        write_varint(prefix, 1);
+        prefix.push_back(0xFF);
+        write_varint(prefix, 3000000);
+        write_varint(prefix, 1);
+        write_varint(prefix, 600000000000);
+        prefix.push_back(0x03);
+        prefix.insert(prefix.end(), 32, 0x22);
+        prefix.push_back(0x5A);
+        write_varint(prefix, extra_head.size() + 8);
+
+        blob = header;
+        blob.insert(blob.end(), prefix.begin(), prefix.end());
+        blob.insert(blob.end(), extra_head.begin(), extra_head.end());
+        blob.insert(blob.end(), 8, 0);
+        blob.push_back(0x00);
+        write_varint(blob, 4);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            uint8_t data = 0x30 + i;
+            auto hash = Monero::Implementors::fast_hash(&data, 1);
+
+            blob.insert(blob.end(), hash.begin(), hash.end());
+        }
+
+        size_t reserved_offset = header.size() + prefix.size() + extra_head.size();
+        string hashing_prefix = "101080e2cfaa06" + to_hex(header.data() + 7, 32) + "00000000";
+        Monero::Block_Template block_template({
+            {"blocktemplate_blob", to_hex(blob.data(), blob.size())},
+            {"blockhashing_blob", hashing_prefix + "1571c5102316c3beffaae94db278eca21532b7232c1232b49a3940f1cae8c4f405"},
+            {"reserved_offset", reserved_offset},
+            {"seed_hash", string(64, '0')},
+            {"height", 3000000},
+            {"difficulty", 100},
+            {"prev_hash", to_hex(header.data() + 7, 32)}
+        }, 8);
+
+        check(reserved_offset == 131, "reserved offset");
+        check(block_template.get_tx_count() == 5, "transactions with miner transaction");
+        check(block_template.is_consistent(), "hashing blob of daemon");
+
+        binary hashing = block_template.get_hashing_blob(0x0807060504030201ULL);
+
+        check(
+            to_hex(hashing.data(), hashing.size()) ==
+                hashing_prefix + "b39abdf896921e6631a4a1d399e7843010aed431fe2e5784ab09ae5ec335c58b05",
+            "hashing blob for extranonce"
+        );
+
+        binary block = block_template.get_block(0x0807060504030201ULL, from_hex("aabbccdd"));
+        binary expected = blob;
+
+        for (uint8_t i = 0; i < 8; i++)
+            expected[reserved_offset + i] = i + 1;
+        std::memcpy(expected.data() + header.size() - sizeof(uint32_t), from_hex("aabbccdd").data(), sizeof(uint32_t));
+        check(block == expected, "block with extranonce and nonce");
+    });
+
+    // Cache storage: caches are light, large pages may be unavailable
+    using Solvers::Implementors::Cache_Storage;
+
+    randomx_flags cache_flags = randomx_get_flags();
+    auto seed = [](const string &key) { return binary(key.begin(), key.end()); };
+
+    runner.run("cache_storage: hit returns stored cache", [&]() {
+        Cache_Storage caches(cache_flags);
+        auto cache = caches.get(seed("test key 000"));
+
+        check(caches.get(seed("test key 000")) == cache, "same cache for same seed");
+        check(caches.size() == 1, "one stored cache");
+        check(caches.contains(seed("test key 000")), "seed is stored");
+    });
+
+    runner.run("cache_storage: concurrent misses fill once", [&]() {
+        Cache_Storage caches(cache_flags);
+        std::vector<std::shared_ptr<randomx_cache>> found(4);
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < found.size(); i++)
+            threads.emplace_back([&caches, &found, &seed, i]() {
+                found[i] = caches.get(seed("test key 000"));
+            });
+        for (auto &thread : threads)
+            thread.join();
+
+        for (auto &cache : found)
+            check(cache == found[0], "same cache for all threads");
+        check(caches.size() == 1, "one stored cache");
+    });
+
+    runner.run("cache_storage: least recently used is evicted", [&]() {
+        Cache_Storage caches(cache_flags, 2 * Cache_Storage::cache_memory);
+
+        caches.get(seed("seed a"));
+        caches.get(seed("seed b"));
+        caches.get(seed("seed a"));
+        caches.get(seed("seed c"));
+
+        check(caches.size() == 2, "budget of two caches");
+        check(caches.contains(seed("seed a")), "recently used seed is kept");
+        check(!caches.contains(seed("seed b")), "least recently used seed is evicted");
+        check(caches.contains(seed("seed c")), "new seed is stored");
+    });
+
+    runner.run("cache_storage: evicted cache stays usable while held", [&]() {
+        Cache_Storage caches(cache_flags, Cache_Storage::cache_memory);
+        auto held = caches.get(seed("test key 000"));
+
+        caches.get(seed("seed b"));
+        check(!caches.contains(seed("test key 000")), "seed is evicted");
+
+        const char input[] = "This is a test";
+        std::array<unsigned char, RANDOMX_HASH_SIZE> hash;
+        randomx_vm *vm = randomx_create_vm(cache_flags, held.get(), nullptr);
+
+        check(vm != nullptr, "virtual machine is created");
+        randomx_calculate_hash(vm, input, sizeof(input) - 1, hash.data());
+        randomx_destroy_vm(vm);
+
+        check(
+            to_hex(hash.data(), hash.size()) == "639183aae1bf4c9a35884cb46b09cad9175f04efd7684e7262a0ac1c2f0b4e3f",
+            "hash with held cache"
+        );
+    });
+
+    runner.run("cache_storage: falls back without huge pages", [&]() {
+        // Interpreter caches, JIT leaks its compiler when huge pages fail
+        Cache_Storage caches((randomx_flags)((cache_flags & ~RANDOMX_FLAG_JIT) | RANDOMX_FLAG_LARGE_PAGES));
+
+        for (const string &key : {"seed a", "seed b"})
+            check(caches.get(seed(key)) != nullptr, "cache for " + key);
+        check(caches.size() == 2, "two stored caches");
+    });
+
+    runner.run("server: label values are escaped", [&]() {
+        using Server::Implementors::escape_label;
+
+        check(escape_label("pool.example.com") == "pool.example.com", "plain value");
+        check(escape_label("a\"b") == "a\\\"b", "double quote");
+        check(escape_label("a\\b") == "a\\\\b", "backslash");
+        check(escape_label("a\nb") == "a\\nb", "line feed");
+    });
+
+    cout << endl << runner.get_number() - runner.get_failed() << " of " << runner.get_number() << " tests passed" << endl;
+
+    return runner.get_failed() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#ifndef TESTS_HEADER
+#define TESTS_HEADER
+
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <thread>
+#include <memory>
+
+#include "../src/pools/inc/pools.hpp"
+#include "../src/solvers/inc/solvers.hpp"
+#include "../src/server/inc/server.hpp"
+#include "../src/monero/inc/monero.hpp"
+#include "../src/hashes/inc/hashes.hpp"
+#include "../src/utilities/inc/utilities.hpp"
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/**
+ * @brief Implementators for Tests objects
+ *
+ * @author GerrFrog
+ */
+namespace Tests::Implementors
+{
+    /**
+     * @brief Throw if condition does not hold, so the failed check is
+     * reported and the next test still runs
+     *
+     * @author GerrFrog
+     *
+     * @param condition Condition
+     * @param message Description of check
+     */
+    inline void check(bool condition, const string &message)
+    {
+        if (!condition)
+            throw std::runtime_error("check failed: " + message);
+    }
+
+    /**
+     * @brief Decode HEX
+     *
+     * @author GerrFrog
+     *
+     * @param hex HEX string
+     * @return binary
+     */
+    inline binary from_hex(const string &hex)
+    {
+        return Utilities::HEX_String(hex).get_decoded();
+    }
+
+    /**
+     * @brief Encode to HEX
+     *
+     * @author GerrFrog
+     *
+     * @param data Bytes
+     * @param size Number of bytes
+     * @return string
+     */
+    inline string to_hex(const void *data, size_t size)
+    {
+        return Utilities::HEX_String(binary((const unsigned char *)data, (const unsigned char *)data + size)).get_encoded();
+    }
+}
+
+/**
+ * @brief Unit tests of the miner
+ *
+ * @author GerrFrog
+ */
+namespace Tests
+{
+    /**
+     * @brief Runs named tests and counts failures. Tests whose name does
+     * not contain filter are skipped
+     *
+     * @author GerrFrog
+     */
+    class Runner
+    {
+        private:
+            /**
+             * @brief Substring of test names to run
+             *
+             * @author GerrFrog
+             */
+            string filter;
+
+            /**
+             * @brief Number of started tests
+             *
+             * @author GerrFrog
+             */
+            size_t number = 0;
+
+            /**
+             * @brief Number of failed tests
+             *
+             * @author GerrFrog
+             */
+            size_t failed = 0;
+
+        public:
+            /**
+             * @brief Construct a new Runner object
+             *
+             * @author GerrFrog
+             *
+             * @param filter Substring of test names to run
+             */
+            explicit Runner(const string &filter = "") : filter(filter) { }
+
+            /**
+             * @brief Destroy the Runner object
+             *
+             * @author GerrFrog
+             */
+            ~Runner() = default;
+
+            /**
+             * @brief Run test
+             *
+             * @author GerrFrog
+             *
+             * @param name Name of test
+             * @param test Test (throws on failure)
+             */
+            template<typename Test>
+            void run(const string &name, Test test)
+            {
+                if (name.find(this->filter) == string::npos)
+                    return;
+
+                cout << "[" << std::setw(2) << std::right << ++this->number << "] "
+                    << std::setw(48) << std::left << name << " ... " << std::flush;
+
+                try {
+                    test();
+                    cout << "PASSED" << endl;
+                } catch (std::exception &exp) {
+                    cout << "FAILED" << endl << "     " << exp.what() << endl;
+                    this->failed++;
+                }
+            }
+
+            /**
+             * @brief Get number of failed tests
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_failed() const { return this->failed; }
+
+            /**
+             * @brief Get number of run tests
+             *
+             * @author GerrFrog
+             *
+             * @return size_t
+             */
+            size_t get_number() const { return this->number; }
+    };
+}
+
+
+
+
+
+
+
+#endif
\ No newline at end of file